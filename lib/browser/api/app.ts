@@ -85,6 +85,7 @@ if (process.platform === 'darwin') {
   const setDockMenu = app.dock!.setMenu;
   app.dock!.setMenu = (menu) => {
     dockMenu = menu;
+    (Menu as any)._flushPendingStates();
     setDockMenu(menu);
   };
   app.dock!.getMenu = () => dockMenu;
@@ -40,6 +40,20 @@ const MenuItem = function (options) {
   this.overrideProperty('acceleratorWorksWhenHidden', true);
   this.overrideProperty('registerAccelerator', roles.shouldRegisterAccelerator(this.role));
 
+  // The native menu keeps its own copy of these, tell it when they change.
+  for (const name of MenuItem.stateProperties) {
+    let value = this[name];
+    Object.defineProperty(this, name, {
+      enumerable: true,
+      configurable: true,
+      get: () => value,
+      set: (newValue) => {
+        value = newValue;
+        if (this.menu) this.menu._invalidateItem(this);
+      }
+    });
+  }
+
   if (!MenuItem.types.includes(this.type)) {
     throw new Error(`Unknown menu item type: ${this.type}`);
   }
@@ -65,6 +79,8 @@ const MenuItem = function (options) {
 
 MenuItem.types = ['normal', 'separator', 'submenu', 'checkbox', 'radio'];
 
+MenuItem.stateProperties = ['checked', 'enabled', 'visible', 'acceleratorWorksWhenHidden', 'registerAccelerator'];
+
 MenuItem.prototype.getDefaultRoleAccelerator = function () {
   return roles.getDefaultAccelerator(this.role);
 };
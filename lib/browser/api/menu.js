@@ -12,20 +12,37 @@ let groupIdIndex = 0;
 
 Object.setPrototypeOf(Menu.prototype, EventEmitter.prototype);
 
+// Menus with items whose state has not been sent to the native menu yet.
+const pendingMenus = new Set();
+
+const flushPendingStates = function () {
+  for (const menu of pendingMenus) menu._sendPendingStates();
+  pendingMenus.clear();
+};
+
+const getCommandState = function (item) {
+  const state = {
+    commandId: item.commandId,
+    checked: item.checked,
+    enabled: item.enabled,
+    visible: item.visible,
+    acceleratorWorksWhenHidden: item.acceleratorWorksWhenHidden,
+    registerAccelerator: item.registerAccelerator
+  };
+  if (item.accelerator != null) {
+    state.accelerator = item.accelerator;
+  } else {
+    const defaultAccelerator = item.getDefaultRoleAccelerator();
+    if (defaultAccelerator) state.defaultAccelerator = defaultAccelerator;
+  }
+  return state;
+};
+
 // Menu Delegate.
 // This object should hold no reference to |Menu| to avoid cyclic reference.
+// The state of the items is kept by the native menu, so that showing it does
+// not call into JS for every item.
 const delegate = {
-  isCommandIdChecked: (menu, id) => menu.commandsMap[id] ? menu.commandsMap[id].checked : undefined,
-  isCommandIdEnabled: (menu, id) => menu.commandsMap[id] ? menu.commandsMap[id].enabled : undefined,
-  shouldCommandIdWorkWhenHidden: (menu, id) => menu.commandsMap[id] ? menu.commandsMap[id].acceleratorWorksWhenHidden : undefined,
-  isCommandIdVisible: (menu, id) => menu.commandsMap[id] ? menu.commandsMap[id].visible : undefined,
-  getAcceleratorForCommandId: (menu, id, useDefaultAccelerator) => {
-    const command = menu.commandsMap[id];
-    if (!command) return;
-    if (command.accelerator != null) return command.accelerator;
-    if (useDefaultAccelerator) return command.getDefaultRoleAccelerator();
-  },
-  shouldRegisterAcceleratorForCommandId: (menu, id) => menu.commandsMap[id] ? menu.commandsMap[id].registerAccelerator : undefined,
   executeCommand: (menu, event, id) => {
     const command = menu.commandsMap[id];
     if (!command) return;
@@ -35,8 +52,12 @@ const delegate = {
     // Ensure radio groups have at least one menu item selected
     for (const id of Object.keys(menu.groupsMap)) {
       const found = menu.groupsMap[id].find(item => item.checked) || null;
-      if (!found) v8Util.setHiddenValue(menu.groupsMap[id][0], 'checked', true);
+      if (!found) {
+        v8Util.setHiddenValue(menu.groupsMap[id][0], 'checked', true);
+        menu._invalidateItem(menu.groupsMap[id][0]);
+      }
     }
+    flushPendingStates();
   }
 };
 
@@ -47,8 +68,31 @@ Menu.prototype._init = function () {
   this.groupsMap = {};
   this.items = [];
   this.delegate = delegate;
+  this._pendingItems = new Set();
+};
+
+// Sends the state of |item| to the native menu with the next batch.
+Menu.prototype._invalidateItem = function (item) {
+  if (pendingMenus.size === 0) process.nextTick(flushPendingStates);
+  pendingMenus.add(this);
+  this._pendingItems.add(item);
+};
+
+Menu.prototype._sendPendingStates = function () {
+  if (this._pendingItems.size === 0) return;
+  this.setCommandStates(Array.from(this._pendingItems, getCommandState));
+  this._pendingItems.clear();
 };
 
+// Make the getters of the native menu see the latest state of the items.
+for (const name of ['getAcceleratorTextAt', 'isItemCheckedAt', 'isEnabledAt', 'isVisibleAt', 'worksWhenHiddenAt']) {
+  const getter = Menu.prototype[name];
+  Menu.prototype[name] = function (...args) {
+    flushPendingStates();
+    return getter.apply(this, args);
+  };
+}
+
 Menu.prototype.popup = function (options = {}) {
   if (options == null || typeof options !== 'object') {
     throw new TypeError('Options must be an object');
@@ -75,6 +119,7 @@ Menu.prototype.popup = function (options = {}) {
     }
   }
 
+  flushPendingStates();
   this.popupAt(window, x, y, positioningItem, callback);
   return { browserWindow: window, x, y, position: positioningItem };
 };
@@ -131,6 +176,7 @@ Menu.prototype.insert = function (pos, item) {
   // Remember the items.
   this.items.splice(pos, 0, item);
   this.commandsMap[item.commandId] = item;
+  this._invalidateItem(item);
 };
 
 Menu.prototype._callMenuWillShow = function () {
@@ -146,6 +192,10 @@ Menu.getApplicationMenu = () => applicationMenu;
 
 Menu.sendActionToFirstResponder = bindings.sendActionToFirstResponder;
 
+// Called before the native code uses a menu right away, e.g. to register its
+// accelerators, as the pending states are otherwise sent on the next tick.
+Menu._flushPendingStates = flushPendingStates;
+
 // set application menu with a preexisting menu
 Menu.setApplicationMenu = function (menu) {
   if (menu && menu.constructor !== Menu) {
@@ -264,6 +314,7 @@ function insertItemByType (item, pos) {
         set: () => {
           this.groupsMap[item.groupId].forEach(other => {
             if (other !== item) v8Util.setHiddenValue(other, 'checked', false);
+            this._invalidateItem(other);
           });
           v8Util.setHiddenValue(item, 'checked', true);
         }
@@ -25,6 +25,7 @@ module.exports = [
   { name: 'net' },
   { name: 'netLog' },
   { name: 'Notification' },
+  { name: 'PDFPrinter' },
   { name: 'powerMonitor' },
   { name: 'powerSaveBlocker' },
   { name: 'protocol' },
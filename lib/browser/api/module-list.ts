@@ -22,6 +22,7 @@ export const browserModuleList: ElectronInternal.ModuleEntry[] = [
   { name: 'Notification', loader: () => require('./notification') },
   { name: 'OffscreenHostView', loader: () => require('./offscreen-host-view') },
   { name: 'OffscreenWindow', loader: () => require('./offscreen-window') },
+  { name: 'PDFPrinter', loader: () => require('./pdf-printer') },
   { name: 'powerMonitor', loader: () => require('./power-monitor') },
   { name: 'powerSaveBlocker', loader: () => require('./power-save-blocker') },
   { name: 'protocol', loader: () => require('./protocol') },
@@ -0,0 +1,130 @@
+'use strict';
+
+const { EventEmitter } = require('events');
+const os = require('os');
+const { webContents } = require('electron');
+
+// Prints pages to PDF files using a pool of hidden WebContents, which are
+// reused between jobs instead of starting a renderer for every page.
+class PDFPrinter extends EventEmitter {
+  constructor (options = {}) {
+    super();
+
+    const { concurrency = os.cpus().length, webPreferences = {} } = options;
+    if (!Number.isInteger(concurrency) || concurrency < 1) {
+      throw new Error('concurrency must be a positive integer');
+    }
+
+    this._concurrency = concurrency;
+    this._webPreferences = webPreferences;
+    this._queue = [];
+    this._idleContents = [];
+    this._activeCount = 0;
+    this._destroyed = false;
+
+    this._completedCount = 0;
+    this._failedCount = 0;
+    this._pageCount = 0;
+    // Time spent with at least one job running, so that throughput isn't
+    // lowered by the time the printer was left idle.
+    this._busyTime = 0;
+    this._busyStart = 0;
+  }
+
+  print (job) {
+    if (this._destroyed) {
+      return Promise.reject(new Error('PDFPrinter has been destroyed'));
+    }
+    if (!job || typeof job.outputPath !== 'string') {
+      return Promise.reject(new Error('Must pass outputPath as a string'));
+    }
+    if (typeof job.url !== 'string' && typeof job.filePath !== 'string') {
+      return Promise.reject(new Error('Must pass either url or filePath as a string'));
+    }
+
+    return new Promise((resolve, reject) => {
+      this._queue.push({ job, resolve, reject });
+      this._runNext();
+    });
+  }
+
+  getMetrics () {
+    let elapsed = this._busyTime;
+    if (this._activeCount > 0) {
+      elapsed += Date.now() - this._busyStart;
+    }
+    return {
+      pendingCount: this._queue.length,
+      activeCount: this._activeCount,
+      completedCount: this._completedCount,
+      failedCount: this._failedCount,
+      pageCount: this._pageCount,
+      elapsedTime: elapsed,
+      pagesPerSecond: elapsed > 0 ? this._pageCount * 1000 / elapsed : 0
+    };
+  }
+
+  destroy () {
+    if (this._destroyed) return;
+    this._destroyed = true;
+
+    for (const { reject } of this._queue.splice(0)) {
+      reject(new Error('PDFPrinter has been destroyed'));
+    }
+    for (const contents of this._idleContents.splice(0)) {
+      contents.destroy();
+    }
+  }
+
+  _runNext () {
+    while (this._activeCount < this._concurrency && this._queue.length > 0) {
+      const { job, resolve, reject } = this._queue.shift();
+      if (this._activeCount++ === 0) {
+        this._busyStart = Date.now();
+      }
+      this._run(job).then(resolve, reject).then(() => {
+        if (--this._activeCount === 0) {
+          this._busyTime += Date.now() - this._busyStart;
+        }
+        this._runNext();
+      });
+    }
+  }
+
+  async _run (job) {
+    const contents = this._idleContents.pop() ||
+      webContents.create({ ...this._webPreferences, show: false });
+    try {
+      if (typeof job.filePath === 'string') {
+        await contents.loadFile(job.filePath);
+      } else {
+        await contents.loadURL(job.url);
+      }
+      const pageCount = await contents.printToPDF({
+        ...job.options,
+        outputPath: job.outputPath
+      });
+      this._completedCount++;
+      this._pageCount += pageCount;
+      const result = { outputPath: job.outputPath, pageCount };
+      this.emit('job-done', {}, result);
+      return result;
+    } catch (error) {
+      this._failedCount++;
+      throw error;
+    } finally {
+      this._release(contents);
+    }
+  }
+
+  _release (contents) {
+    if (contents.isDestroyed()) return;
+    if (this._destroyed || contents.isCrashed()) {
+      contents.destroy();
+    } else {
+      this._idleContents.push(contents);
+    }
+  }
+}
+
+module.exports = PDFPrinter;
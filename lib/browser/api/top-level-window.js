@@ -26,6 +26,13 @@ TopLevelWindow.prototype._init = function () {
   }
 };
 
+const { setMenu } = TopLevelWindow.prototype;
+TopLevelWindow.prototype.setMenu = function (menu) {
+  // The accelerators of the menu are registered right away.
+  electron.Menu._flushPendingStates();
+  return setMenu.call(this, menu);
+};
+
 TopLevelWindow.getFocusedWindow = () => {
   return TopLevelWindow.getAllWindows().find((win) => win.isFocused());
 };
@@ -1,9 +1,15 @@
 'use strict';
 
 const { EventEmitter } = require('events');
-const { deprecate } = require('electron');
+const { deprecate, Menu } = require('electron');
 const { Tray } = process.electronBinding('tray');
 
 Object.setPrototypeOf(Tray.prototype, EventEmitter.prototype);
 
+const { setContextMenu } = Tray.prototype;
+Tray.prototype.setContextMenu = function (menu) {
+  Menu._flushPendingStates();
+  return setContextMenu.call(this, menu);
+};
+
 module.exports = Tray;
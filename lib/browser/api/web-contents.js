@@ -4,6 +4,7 @@ const features = process.electronBinding('features');
 const { EventEmitter } = require('events');
 const electron = require('electron');
 const path = require('path');
+const { Readable } = require('stream');
 const url = require('url');
 const { app, ipcMain, session, deprecate } = electron;
 
@@ -100,6 +101,21 @@ const { WebContents } = binding;
 Object.setPrototypeOf(NavigationController.prototype, EventEmitter.prototype);
 Object.setPrototypeOf(WebContents.prototype, NavigationController.prototype);
 
+// Tell the native side which events have listeners whenever they change, so
+// that it doesn't emit the others at all.
+const updateListenedEvents = function (contents) {
+  if (contents.isDestroyed()) return;
+  contents._setListenedEvents(contents.eventNames().filter(name => typeof name === 'string'));
+};
+
+for (const method of ['addListener', 'on', 'prependListener', 'removeListener', 'off', 'removeAllListeners']) {
+  WebContents.prototype[method] = function (...args) {
+    const result = EventEmitter.prototype[method].apply(this, args);
+    updateListenedEvents(this);
+    return result;
+  };
+}
+
 // WebContents::send(channel, args..)
 // WebContents::sendToAll(channel, args..)
 WebContents.prototype.send = function (channel, ...args) {
@@ -258,7 +274,7 @@ WebContents.prototype.printToPDF = function (options) {
   // PrinterType enum from //printing/print_job_constants.h
   printingSetting.printerType = 2;
   if (features.isPrintingEnabled()) {
-    return this._printToPDF(printingSetting);
+    return this._printToPDF(printingSetting, options.outputPath);
   } else {
     return Promise.reject(new Error('Printing feature is disabled'));
   }
@@ -281,6 +297,19 @@ WebContents.prototype.getPrinters = function () {
   }
 };
 
+WebContents.prototype.takeHeapSnapshotStream = function (options = {}) {
+  const reader = this._takeHeapSnapshotStream(options);
+  return new Readable({
+    read () {
+      reader.read().then(chunk => {
+        this.push(chunk);
+      }, error => {
+        this.destroy(error);
+      });
+    }
+  });
+};
+
 WebContents.prototype.loadFile = function (filePath, options = {}) {
   if (typeof filePath !== 'string') {
     throw new Error('Must pass filePath as a string');
@@ -328,6 +357,8 @@ WebContents.prototype._init = function () {
     deprecate.log('The default value of app.allowRendererProcessReuse is deprecated, it is currently "false".  It will change to be "true" in Electron 9.  For more information please check https://github.com/electron/electron/issues/18397');
     warnedAboutRendererProcessReuse = true;
   }
+  updateListenedEvents(this);
+
   // The navigation controller.
   NavigationController.call(this, this);
 
@@ -347,6 +378,17 @@ WebContents.prototype._init = function () {
     }
   });
 
+  this.on('-ipc-message-raw', function (event, message) {
+    addReplyToEvent(event);
+    ipcMain._rawListeners.emit(message.channel, event, message);
+    // Listeners added with on() still get the arguments.
+    if (this.listenerCount('ipc-message') > 0 || ipcMain.listenerCount(message.channel) > 0) {
+      const args = message.args;
+      this.emit('ipc-message', event, message.channel, ...args);
+      ipcMain.emit(message.channel, event, ...args);
+    }
+  });
+
   this.on('-ipc-invoke', function (event, internal, channel, args) {
     event._reply = (result) => event.sendReply({ result });
     event._throw = (error) => {
@@ -503,5 +545,20 @@ module.exports = {
 
   getAllWebContents () {
     return binding.getAllWebContents();
+  },
+
+  // Sends to all WebContents, the ones of a session, or the given ones.
+  broadcast (targets, channel, ...args) {
+    if (typeof channel !== 'string') {
+      throw new Error('Missing required channel argument');
+    }
+
+    let contents = binding.getAllWebContents();
+    if (Array.isArray(targets)) {
+      contents = targets;
+    } else if (targets != null) {
+      contents = contents.filter(c => c.session === targets);
+    }
+    return binding._broadcast(false, contents.filter(c => !c.isDestroyed()), channel, args);
   }
 };
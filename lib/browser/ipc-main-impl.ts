@@ -30,4 +30,24 @@ export class IpcMainImpl extends EventEmitter {
   removeHandler (method: string) {
     this._invokeHandlers.delete(method);
   }
+
+  // Listeners of the channels received without deserializing the arguments.
+  _rawListeners = new EventEmitter();
+
+  onRaw: Electron.IpcMain['onRaw'] = (channel, listener) => {
+    this._rawListeners.on(channel, listener);
+    this._updateRawChannels();
+    return this;
+  }
+
+  removeRawListener: Electron.IpcMain['removeRawListener'] = (channel, listener) => {
+    this._rawListeners.removeListener(channel, listener);
+    this._updateRawChannels();
+    return this;
+  }
+
+  private _updateRawChannels () {
+    const { _setRawIPCChannels } = process.electronBinding('web_contents');
+    _setRawIPCChannels(this._rawListeners.eventNames().filter(name => typeof name === 'string'));
+  }
 }
@@ -1,3 +1,5 @@
+import { IpcRendererPort } from '@electron/internal/renderer/ipc-renderer-port';
+
 const { ipc } = process.electronBinding('ipc');
 const v8Util = process.electronBinding('v8_util');
 
@@ -22,6 +24,10 @@ if (!ipcRenderer.send) {
     return ipc.sendTo(internal, false, webContentsId, channel, args);
   };
 
+  ipcRenderer.connectTo = async function (webContentsId, channel) {
+    return new IpcRendererPort(await ipc.connectTo(webContentsId, channel));
+  };
+
   ipcRenderer.invoke = async function (channel, ...args) {
     const { error, result } = await ipc.invoke(internal, channel, args);
     if (error) {
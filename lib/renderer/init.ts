@@ -1,5 +1,6 @@
 import { EventEmitter } from 'events';
 import * as path from 'path';
+import { IpcRendererPort } from '@electron/internal/renderer/ipc-renderer-port';
 
 const Module = require('module');
 
@@ -48,6 +49,14 @@ v8Util.setHiddenValue(global, 'ipcNative', {
   onMessage (internal: boolean, channel: string, args: any[], senderId: number) {
     const sender = internal ? ipcInternalEmitter : ipcEmitter;
     sender.emit(channel, { sender, senderId }, ...args);
+  },
+  onConnect (channel: string, port: NodeJS.IpcRendererPortBinding, senderId: number) {
+    // Nobody would ever close the port, let the caller know right away.
+    if (ipcEmitter.listenerCount(channel) === 0) {
+      port.close();
+      return;
+    }
+    ipcEmitter.emit(channel, { sender: ipcEmitter, senderId, port: new IpcRendererPort(port) });
   }
 });
 
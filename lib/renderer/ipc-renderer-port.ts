@@ -0,0 +1,22 @@
+import { EventEmitter } from 'events';
+
+// Wraps one end of a direct channel between two renderers, see
+// ipcRenderer.connectTo().
+export class IpcRendererPort extends EventEmitter {
+  constructor (private _port: NodeJS.IpcRendererPortBinding) {
+    super();
+    _port.setHandlers((args: any[]) => {
+      this.emit('message', { sender: this }, ...args);
+    }, () => {
+      this.emit('close');
+    });
+  }
+
+  postMessage (...args: any[]) {
+    this._port.postMessage(args);
+  }
+
+  close () {
+    this._port.close();
+  }
+}
@@ -27,6 +27,7 @@ for (const prop of Object.keys(EventEmitter.prototype)) {
 Object.setPrototypeOf(process, EventEmitter.prototype);
 
 const { ipcRendererInternal } = require('@electron/internal/renderer/ipc-renderer-internal');
+const { IpcRendererPort } = require('@electron/internal/renderer/ipc-renderer-port');
 const ipcRendererUtils = require('@electron/internal/renderer/ipc-renderer-internal-utils');
 
 const {
@@ -57,6 +58,15 @@ v8Util.setHiddenValue(global, 'ipcNative', {
   onMessage (internal, channel, args, senderId) {
     const sender = internal ? ipcRendererInternal : electron.ipcRenderer;
     sender.emit(channel, { sender, senderId }, ...args);
+  },
+  onConnect (channel, port, senderId) {
+    const sender = electron.ipcRenderer;
+    // Nobody would ever close the port, let the caller know right away.
+    if (sender.listenerCount(channel) === 0) {
+      port.close();
+      return;
+    }
+    sender.emit(channel, { sender, senderId, port: new IpcRendererPort(port) });
   }
 });
 
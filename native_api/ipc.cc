@@ -0,0 +1,24 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "electron/native_api/ipc.h"
+
+#include "shell/browser/native_ipc_handler_registry.h"
+
+namespace electron {
+namespace api {
+namespace ipc {
+
+ELECTRON_EXTERN bool __cdecl addMessageHandler(const char* channel,
+                                               MessageHandler* handler) {
+  return NativeIpcHandlerRegistry::GetInstance()->AddHandler(channel, handler);
+}
+
+ELECTRON_EXTERN void __cdecl removeMessageHandler(const char* channel) {
+  NativeIpcHandlerRegistry::GetInstance()->RemoveHandler(channel);
+}
+
+}  // namespace ipc
+}  // namespace api
+}  // namespace electron
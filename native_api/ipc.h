@@ -0,0 +1,74 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef NATIVE_API_IPC_H_
+#define NATIVE_API_IPC_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "electron/native_api/electron.h"
+
+namespace electron {
+namespace api {
+namespace ipc {
+
+// Values are passed in the format of the V8 ValueSerializer, with its header,
+// which is what v8.serialize() returns in Node.js.
+
+class ELECTRON_EXTERN Reply {
+ public:
+  // Sends |data|, the serialized return value, as the result of
+  // ipcRenderer.sendSync or ipcRenderer.invoke. Can be called from any thread.
+  virtual void Send(const uint8_t* data, size_t size) = 0;
+
+  // Rejects ipcRenderer.invoke with |message|, or returns undefined from
+  // ipcRenderer.sendSync.
+  virtual void SendError(const char* message) = 0;
+
+ protected:
+  virtual ~Reply() = default;
+};
+
+class ELECTRON_EXTERN MessageHandler {
+ public:
+  // Called on the IPC handler thread for each message sent on the channel
+  // with ipcRenderer.send, ipcRenderer.sendSync or ipcRenderer.invoke.
+  // |data| is the serialized array of arguments and is only valid during the
+  // call. |reply| is null for ipcRenderer.send, otherwise exactly one of its
+  // methods must be called, which deletes it.
+  virtual void OnMessage(int web_contents_id,
+                         const char* channel,
+                         const uint8_t* data,
+                         size_t size,
+                         Reply* reply) = 0;
+
+  // Called on the IPC handler thread after removeMessageHandler, once the
+  // handler will not be called anymore for that channel. The handler can be
+  // deleted from here.
+  virtual void OnRemoved() {}
+
+ protected:
+  virtual ~MessageHandler() = default;
+};
+
+// Handles the messages sent on |channel| with |handler| instead of ipcMain.
+// Returns false if the channel already has a native handler. Messages with
+// arguments that can not be structured cloned still go to ipcMain. Renderers
+// send the messages of native channels straight to the handler thread once
+// they know about them. Pages that sent a message before any handler was
+// added go through the main thread instead, which still calls the handler.
+ELECTRON_EXTERN bool __cdecl addMessageHandler(const char* channel,
+                                               MessageHandler* handler);
+
+// Stops handling |channel| natively. Returns right away, without waiting for
+// the handler if it is being called, so the handler must not be deleted
+// before its OnRemoved is called.
+ELECTRON_EXTERN void __cdecl removeMessageHandler(const char* channel);
+
+}  // namespace ipc
+}  // namespace api
+}  // namespace electron
+
+#endif  // NATIVE_API_IPC_H_
@@ -0,0 +1,47 @@
+#!/usr/bin/env node
+
+// Compares sending the same message to many windows with webContents.send in
+// a loop against webContents.broadcast.
+//
+// Usage: node script/benchmark-broadcast.js [--windows=50] [--messages=100]
+//                                           [--payload-size=10000]
+
+const childProcess = require('child_process');
+const path = require('path');
+const utils = require('./lib/utils');
+
+const args = require('minimist')(process.argv.slice(2), {
+  default: {
+    windows: 50,
+    messages: 100,
+    'payload-size': 10000
+  }
+});
+
+const app = path.resolve(__dirname, '..', 'spec', 'fixtures', 'broadcast-benchmark');
+const RESULTS_PATTERN = /^broadcast-benchmark-results (.*)$/m;
+
+function main () {
+  const env = Object.assign({}, process.env, {
+    BROADCAST_BENCHMARK_WINDOWS: args.windows,
+    BROADCAST_BENCHMARK_MESSAGES: args.messages,
+    BROADCAST_BENCHMARK_PAYLOAD_SIZE: args['payload-size']
+  });
+
+  const result = childProcess.spawnSync(utils.getAbsoluteElectronExec(), [app], { env });
+  const match = RESULTS_PATTERN.exec(result.stdout.toString());
+  if (result.status !== 0 || !match) {
+    console.error(result.stderr.toString());
+    throw new Error(`Electron exited with ${result.status} before the results`);
+  }
+
+  // |sendTime| is spent on the main thread sending the messages, |totalTime|
+  // also includes delivering them to every window.
+  const results = JSON.parse(match[1]);
+  for (const [method, { sendTime, totalTime }] of Object.entries(results)) {
+    console.log(`${method}: ${sendTime.toFixed(1)}ms sending, ` +
+                `${totalTime.toFixed(1)}ms until delivered`);
+  }
+}
+
+main();
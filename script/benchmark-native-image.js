@@ -0,0 +1,48 @@
+#!/usr/bin/env node
+
+// Compares making thumbnails of large photos with image.resize and
+// image.toJPEG on the main thread against nativeImage.transformImages.
+//
+// Usage: node script/benchmark-native-image.js [--dir=path/to/photos]
+//                                              [--images=50] [--width=256]
+//
+// Without --dir, the corpus is made of generated 4000x3000 images.
+
+const childProcess = require('child_process');
+const path = require('path');
+const utils = require('./lib/utils');
+
+const args = require('minimist')(process.argv.slice(2), {
+  default: {
+    images: 50,
+    width: 256
+  }
+});
+
+const app = path.resolve(__dirname, '..', 'spec', 'fixtures', 'native-image-benchmark');
+const RESULTS_PATTERN = /^native-image-benchmark-results (.*)$/m;
+
+function main () {
+  const env = Object.assign({}, process.env, {
+    NATIVE_IMAGE_BENCHMARK_DIR: args.dir ? path.resolve(args.dir) : '',
+    NATIVE_IMAGE_BENCHMARK_IMAGES: args.images,
+    NATIVE_IMAGE_BENCHMARK_WIDTH: args.width
+  });
+
+  const result = childProcess.spawnSync(utils.getAbsoluteElectronExec(), [app], { env });
+  const match = RESULTS_PATTERN.exec(result.stdout.toString());
+  if (result.status !== 0 || !match) {
+    console.error(result.stderr.toString());
+    throw new Error(`Electron exited with ${result.status} before the results`);
+  }
+
+  // |maxTickDelay| is the longest time the main thread did not run timers.
+  const { count, ...results } = JSON.parse(match[1]);
+  console.log(`${count} images`);
+  for (const [method, { totalTime, maxTickDelay }] of Object.entries(results)) {
+    console.log(`${method}: ${totalTime.toFixed(1)}ms, ` +
+                `main thread blocked up to ${maxTickDelay.toFixed(1)}ms`);
+  }
+}
+
+main();
@@ -0,0 +1,49 @@
+#!/usr/bin/env node
+
+// Measures how many pages per second a PDFPrinter prints, for example to
+// compare different concurrencies.
+//
+// Usage: node script/benchmark-pdf-printer.js [--runs=3] [--jobs=100]
+//                                             [--pages=5] [--concurrency=N]
+
+const childProcess = require('child_process');
+const path = require('path');
+const utils = require('./lib/utils');
+
+const args = require('minimist')(process.argv.slice(2), {
+  default: {
+    runs: 3,
+    jobs: 100,
+    pages: 5
+  }
+});
+
+const app = path.resolve(__dirname, '..', 'spec', 'fixtures', 'pdf-printer-benchmark');
+const METRICS_PATTERN = /^pdf-printer-benchmark-metrics (.*)$/m;
+
+function run () {
+  const env = Object.assign({}, process.env, {
+    PDF_BENCHMARK_JOBS: args.jobs,
+    PDF_BENCHMARK_PAGES: args.pages,
+    PDF_BENCHMARK_CONCURRENCY: args.concurrency || ''
+  });
+
+  const result = childProcess.spawnSync(utils.getAbsoluteElectronExec(), [app], { env });
+  const match = METRICS_PATTERN.exec(result.stdout.toString());
+  if (result.status !== 0 || !match) {
+    console.error(result.stderr.toString());
+    throw new Error(`Electron exited with ${result.status} before printing`);
+  }
+  return JSON.parse(match[1]);
+}
+
+function main () {
+  for (let i = 0; i < args.runs; i++) {
+    const metrics = run();
+    console.log(`run ${i + 1}: ${metrics.completedCount} jobs, ` +
+                `${metrics.pageCount} pages in ${metrics.elapsedTime}ms, ` +
+                `${metrics.pagesPerSecond.toFixed(1)} pages/s`);
+  }
+}
+
+main();
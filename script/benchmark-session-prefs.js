@@ -0,0 +1,60 @@
+#!/usr/bin/env node
+
+// Compares creating many persistent sessions whose Preferences files are read
+// synchronously against creating them with the asyncPrefs option.
+//
+// Usage: node script/benchmark-session-prefs.js [--partitions=50] [--runs=5]
+//
+// The partitions are created once to write their Preferences files, then
+// every mode is measured in fresh processes, so that the files are read.
+
+const childProcess = require('child_process');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const utils = require('./lib/utils');
+
+const args = require('minimist')(process.argv.slice(2), {
+  default: {
+    partitions: 50,
+    runs: 5
+  }
+});
+
+const app = path.resolve(__dirname, '..', 'spec', 'fixtures', 'session-prefs-benchmark');
+const RESULTS_PATTERN = /^session-prefs-benchmark-results (.*)$/m;
+
+function run (mode, userData) {
+  const env = Object.assign({}, process.env, {
+    SESSION_PREFS_BENCHMARK_MODE: mode,
+    SESSION_PREFS_BENCHMARK_PARTITIONS: args.partitions,
+    SESSION_PREFS_BENCHMARK_USER_DATA: userData
+  });
+
+  const result = childProcess.spawnSync(utils.getAbsoluteElectronExec(), [app], { env });
+  const match = RESULTS_PATTERN.exec(result.stdout.toString());
+  if (result.status !== 0 || !match) {
+    console.error(result.stderr.toString());
+    throw new Error(`Electron exited with ${result.status} before the results`);
+  }
+  return JSON.parse(match[1]);
+}
+
+function main () {
+  const userData = fs.mkdtempSync(path.join(os.tmpdir(), 'electron-session-prefs-benchmark-'));
+  try {
+    run('populate', userData);
+    console.log(`${args.partitions} partitions, best of ${args.runs} runs`);
+    for (const mode of ['sync', 'async']) {
+      let best = Infinity;
+      for (let i = 0; i < args.runs; i++) {
+        best = Math.min(best, run(mode, userData).creationTime);
+      }
+      console.log(`${mode}: ${best.toFixed(1)}ms`);
+    }
+  } finally {
+    fs.rmdirSync(userData, { recursive: true });
+  }
+}
+
+main();
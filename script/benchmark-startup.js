@@ -0,0 +1,65 @@
+#!/usr/bin/env node
+
+// Measures the time it takes the main process to emit 'ready', for example to
+// compare startup with and without a browser_snapshot_blob.bin.
+//
+// Usage: node script/benchmark-startup.js [--runs=20] [--app=path/to/app]
+//                                         [--require=path/to/module]
+
+const childProcess = require('child_process');
+const path = require('path');
+const utils = require('./lib/utils');
+
+const args = require('minimist')(process.argv.slice(2), {
+  string: ['app', 'require'],
+  default: {
+    runs: 20,
+    app: path.resolve(__dirname, '..', 'spec', 'fixtures', 'startup-benchmark')
+  }
+});
+
+const READY_PATTERN = /^startup-benchmark-ready (\d+(\.\d+)?)$/m;
+
+function run () {
+  const env = Object.assign({}, process.env);
+  if (args.require) {
+    env.STARTUP_BENCHMARK_REQUIRE = path.resolve(args.require);
+  }
+
+  const start = process.hrtime.bigint();
+  const result = childProcess.spawnSync(utils.getAbsoluteElectronExec(), [args.app], { env });
+  const wallTime = Number(process.hrtime.bigint() - start) / 1e6;
+
+  const match = READY_PATTERN.exec(result.stdout.toString());
+  if (result.status !== 0 || !match) {
+    console.error(result.stderr.toString());
+    throw new Error(`Electron exited with ${result.status} before 'ready'`);
+  }
+  // |ready| is the uptime reported by the main process, |wallTime| also
+  // includes launching the executable and shutting down.
+  return { ready: parseFloat(match[1]), wallTime };
+}
+
+function percentile (values, p) {
+  const sorted = [...values].sort((a, b) => a - b);
+  return sorted[Math.max(0, Math.ceil(sorted.length * p / 100) - 1)];
+}
+
+function main () {
+  // The first launch warms up the disk cache and isn't representative.
+  run();
+
+  const results = [];
+  for (let i = 0; i < args.runs; i++) {
+    results.push(run());
+  }
+
+  for (const key of ['ready', 'wallTime']) {
+    const values = results.map(result => result[key]);
+    console.log(`${key}: min ${percentile(values, 0).toFixed(1)}ms, ` +
+                `median ${percentile(values, 50).toFixed(1)}ms, ` +
+                `p90 ${percentile(values, 90).toFixed(1)}ms`);
+  }
+}
+
+main();
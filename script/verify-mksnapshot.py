@@ -13,6 +13,8 @@ PROJECT_NAME = get_electron_branding()['project_name']
 PRODUCT_NAME = get_electron_branding()['product_name']
 SOURCE_ROOT = os.path.abspath(os.path.dirname(os.path.dirname(__file__)))
 SNAPSHOT_SOURCE = os.path.join(SOURCE_ROOT, 'spec', 'fixtures', 'testsnap.js')
+BROWSER_SNAPSHOT_SOURCE = os.path.join(SOURCE_ROOT, 'spec', 'fixtures',
+                                       'testbrowsersnap.js')
 
 def main():
   args = parse_args()
@@ -30,6 +32,12 @@ def main():
                     '--no-native-code-counters', '--turbo_instruction_scheduling' ]
         subprocess.check_call(mkargs)
         print('ok mksnapshot successfully created snapshot_blob.bin.')
+        mkargs = [ get_binary_path('mksnapshot', app_path), \
+                    BROWSER_SNAPSHOT_SOURCE, '--startup_blob', \
+                    'browser_snapshot_blob.bin', \
+                    '--no-native-code-counters', '--turbo_instruction_scheduling' ]
+        subprocess.check_call(mkargs)
+        print('ok mksnapshot successfully created browser_snapshot_blob.bin.')
         context_snapshot = 'v8_context_snapshot.bin'
         context_snapshot_path = os.path.join(app_path, context_snapshot)
         gen_binary = get_binary_path('v8_context_snapshot_generator', \
@@ -49,6 +57,9 @@ def main():
 
       test_path = os.path.join(SOURCE_ROOT, 'spec', 'fixtures', \
                                'snapshot-items-available')
+      browser_test_path = os.path.join(SOURCE_ROOT, 'spec', 'fixtures', \
+                                       'browser-snapshot-items-available')
+      browser_snapshot = os.path.join(app_path, 'browser_snapshot_blob.bin')
 
       if sys.platform == 'darwin':
         bin_files = glob.glob(os.path.join(app_path, '*.bin'))
@@ -64,6 +75,14 @@ def main():
       else:
         electron = os.path.join(app_path, PROJECT_NAME)
 
+      if os.path.exists(browser_snapshot):
+        subprocess.check_call([electron, browser_test_path])
+        print('ok successfully used browser snapshot.')
+        # The next test expects the main process to use snapshot_blob.bin.
+        os.remove(browser_snapshot)
+        if sys.platform == 'darwin':
+          os.remove(os.path.join(bin_out_path, 'browser_snapshot_blob.bin'))
+
       subprocess.check_call([electron, test_path])
       print('ok successfully used custom snapshot.')
   except subprocess.CalledProcessError as e:
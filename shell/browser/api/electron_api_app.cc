@@ -42,11 +42,13 @@
 #include "shell/browser/electron_browser_context.h"
 #include "shell/browser/electron_browser_main_parts.h"
 #include "shell/browser/electron_paths.h"
+#include "shell/browser/gc_scheduler.h"
 #include "shell/browser/login_handler.h"
 #include "shell/browser/relauncher.h"
 #include "shell/common/application_info.h"
 #include "shell/common/electron_command_line.h"
 #include "shell/common/gin_helper/dictionary.h"
+#include "shell/common/gin_helper/event_listener_cache.h"
 #include "shell/common/native_mate_converters/callback_converter_deprecated.h"
 #include "shell/common/native_mate_converters/file_path_converter.h"
 #include "shell/common/native_mate_converters/gurl_converter.h"
@@ -548,6 +550,9 @@ App::App(v8::Isolate* isolate) {
       content::PROCESS_TYPE_BROWSER, base::GetCurrentProcessHandle(),
       base::ProcessMetrics::CreateCurrentProcessMetrics());
   app_metrics_[pid] = std::move(process_metric);
+  metrics_sampler_ = std::make_unique<ProcessMetricsSampler>();
+  metrics_sampler_->AddProcess(content::PROCESS_TYPE_BROWSER,
+                               base::GetCurrentProcessHandle());
   Init(isolate);
 }
 
@@ -809,10 +814,12 @@ void App::ChildProcessLaunched(int process_type, base::ProcessHandle handle) {
 #endif
   app_metrics_[pid] = std::make_unique<electron::ProcessMetric>(
       process_type, handle, std::move(metrics));
+  metrics_sampler_->AddProcess(process_type, handle);
 }
 
 void App::ChildProcessDisconnected(base::ProcessId pid) {
   app_metrics_.erase(pid);
+  metrics_sampler_->RemoveProcess(pid);
 }
 
 base::FilePath App::GetAppPath() const {
@@ -1221,8 +1228,14 @@ std::vector<mate::Dictionary> App::GetAppMetrics(v8::Isolate* isolate) {
     pid_dict.Set("creationTime",
                  process_metric.second->process.CreationTime().ToJsTime());
 
-#if !defined(OS_LINUX)
+#if defined(OS_LINUX)
+    // Reading the memory info from /proc blocks, so report what the sampler
+    // read last in the background.
+    ProcessMemoryInfo memory_info;
+    metrics_sampler_->GetMemoryInfo(process_metric.first, &memory_info);
+#else
     auto memory_info = process_metric.second->GetMemoryInfo();
+#endif
 
     mate::Dictionary memory_dict = mate::Dictionary::CreateEmpty(isolate);
     // TODO(zcbenz): Just call SetHidden when this file is converted to gin.
@@ -1237,10 +1250,13 @@ std::vector<mate::Dictionary> App::GetAppMetrics(v8::Isolate* isolate) {
 #if defined(OS_WIN)
     memory_dict.Set("privateBytes",
                     static_cast<double>(memory_info.private_bytes >> 10));
+#elif defined(OS_LINUX)
+    memory_dict.Set(
+        "proportionalSetSize",
+        static_cast<double>(memory_info.proportional_set_size >> 10));
 #endif
 
     pid_dict.Set("memory", memory_dict);
-#endif
 
 #if defined(OS_MACOSX)
     pid_dict.Set("sandboxed", process_metric.second->IsSandboxed());
@@ -1254,9 +1270,106 @@ std::vector<mate::Dictionary> App::GetAppMetrics(v8::Isolate* isolate) {
     result.push_back(pid_dict);
   }
 
+#if defined(OS_LINUX)
+  metrics_sampler_->RefreshMemoryInfo();
+#endif
+
   return result;
 }
 
+void App::StartMetricsSampling(mate::Arguments* args) {
+  int interval = 1000;
+  int capacity = 3600;
+  mate::Dictionary options;
+  if (args->GetNext(&options)) {
+    options.Get("interval", &interval);
+    options.Get("capacity", &capacity);
+  }
+  if (interval <= 0 || capacity <= 0) {
+    args->ThrowError("interval and capacity must be positive");
+    return;
+  }
+  if (static_cast<size_t>(capacity) > ProcessMetricsSampler::kMaxCapacity) {
+    args->ThrowError("capacity must not exceed " +
+                     std::to_string(ProcessMetricsSampler::kMaxCapacity));
+    return;
+  }
+
+  metrics_sampler_->Start(base::TimeDelta::FromMilliseconds(interval),
+                          capacity);
+}
+
+void App::StopMetricsSampling() {
+  metrics_sampler_->Stop();
+}
+
+v8::Local<v8::Value> App::GetMetricsSamples(v8::Isolate* isolate) {
+  std::vector<double> samples = metrics_sampler_->GetSamples();
+
+  auto buffer = v8::ArrayBuffer::New(isolate, samples.size() * sizeof(double));
+  if (!samples.empty()) {
+    memcpy(buffer->GetContents().Data(), samples.data(),
+           samples.size() * sizeof(double));
+  }
+
+  std::vector<std::string> fields(
+      std::begin(ProcessMetricsSampler::kFieldNames),
+      std::end(ProcessMetricsSampler::kFieldNames));
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  dict.Set("fields", fields);
+  dict.Set("samples", v8::Local<v8::Value>(
+                          v8::Float64Array::New(buffer, 0, samples.size())));
+  return dict.GetHandle();
+}
+
+void App::SetGCOptions(mate::Arguments* args) {
+  auto* gc_scheduler = ElectronBrowserMainParts::Get()->gc_scheduler();
+  if (!gc_scheduler) {
+    args->ThrowError("setGCOptions() can only be called after app is ready");
+    return;
+  }
+
+  mate::Dictionary dict;
+  if (!args->GetNext(&dict)) {
+    args->ThrowError("options must be an object");
+    return;
+  }
+
+  GcScheduler::Options options = gc_scheduler->options();
+  dict.Get("idleGC", &options.idle_gc);
+  int full_gc_interval = options.full_gc_interval.InMilliseconds();
+  dict.Get("fullGCInterval", &full_gc_interval);
+  if (full_gc_interval < 0) {
+    args->ThrowError("fullGCInterval must not be negative");
+    return;
+  }
+  options.full_gc_interval =
+      base::TimeDelta::FromMilliseconds(full_gc_interval);
+  gc_scheduler->SetOptions(options);
+}
+
+v8::Local<v8::Value> App::GetGCStats(v8::Isolate* isolate) {
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  auto* gc_scheduler = ElectronBrowserMainParts::Get()->gc_scheduler();
+  if (!gc_scheduler)
+    return dict.GetHandle();
+
+  const GcScheduler::Stats& stats = gc_scheduler->stats();
+  dict.Set("minorGCCount", static_cast<double>(stats.minor_gc_count));
+  dict.Set("majorGCCount", static_cast<double>(stats.major_gc_count));
+  dict.Set("totalPauseTime", stats.total_pause_time.InMillisecondsF());
+  dict.Set("maxPauseTime", stats.max_pause_time.InMillisecondsF());
+  dict.Set("idleNotificationCount",
+           static_cast<double>(stats.idle_notification_count));
+  dict.Set("forcedGCCount", static_cast<double>(stats.forced_gc_count));
+  return dict.GetHandle();
+}
+
+v8::Local<v8::Value> App::GetEventStats(v8::Isolate* isolate) {
+  return mate::ConvertToV8(
+      isolate, gin_helper::EventEmitStats::GetInstance()->ToValue());
+}
+
 v8::Local<v8::Value> App::GetGPUFeatureStatus(v8::Isolate* isolate) {
   auto status = content::GetFeatureStatus();
   base::DictionaryValue temp;
@@ -1506,6 +1619,12 @@ void App::BuildPrototype(v8::Isolate* isolate,
                  &App::DisableDomainBlockingFor3DAPIs)
       .SetMethod("getFileIcon", &App::GetFileIcon)
       .SetMethod("getAppMetrics", &App::GetAppMetrics)
+      .SetMethod("startMetricsSampling", &App::StartMetricsSampling)
+      .SetMethod("stopMetricsSampling", &App::StopMetricsSampling)
+      .SetMethod("getMetricsSamples", &App::GetMetricsSamples)
+      .SetMethod("setGCOptions", &App::SetGCOptions)
+      .SetMethod("getGCStats", &App::GetGCStats)
+      .SetMethod("getEventStats", &App::GetEventStats)
       .SetMethod("getGPUFeatureStatus", &App::GetGPUFeatureStatus)
       .SetMethod("getGPUInfo", &App::GetGPUInfo)
 #if defined(MAS_BUILD)
@@ -24,6 +24,7 @@
 #include "net/ssl/client_cert_identity.h"
 #include "shell/browser/api/event_emitter_deprecated.h"
 #include "shell/browser/api/process_metric.h"
+#include "shell/browser/api/process_metrics_sampler.h"
 #include "shell/browser/browser.h"
 #include "shell/browser/browser_observer.h"
 #include "shell/browser/electron_browser_client.h"
@@ -195,6 +196,12 @@ class App : public ElectronBrowserClient::Delegate,
                                      mate::Arguments* args);
 
   std::vector<mate::Dictionary> GetAppMetrics(v8::Isolate* isolate);
+  void StartMetricsSampling(mate::Arguments* args);
+  void StopMetricsSampling();
+  v8::Local<v8::Value> GetMetricsSamples(v8::Isolate* isolate);
+  void SetGCOptions(mate::Arguments* args);
+  v8::Local<v8::Value> GetGCStats(v8::Isolate* isolate);
+  v8::Local<v8::Value> GetEventStats(v8::Isolate* isolate);
   v8::Local<v8::Value> GetGPUFeatureStatus(v8::Isolate* isolate);
   v8::Local<v8::Promise> GetGPUInfo(v8::Isolate* isolate,
                                     const std::string& info_type);
@@ -242,6 +249,10 @@ class App : public ElectronBrowserClient::Delegate,
                          std::unique_ptr<electron::ProcessMetric>>;
   ProcessMetricMap app_metrics_;
 
+  // Tracks the same processes as |app_metrics_|, samples them while
+  // startMetricsSampling() is active and caches their memory info.
+  std::unique_ptr<ProcessMetricsSampler> metrics_sampler_;
+
   DISALLOW_COPY_AND_ASSIGN(App);
 };
 
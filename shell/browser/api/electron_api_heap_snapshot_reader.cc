@@ -0,0 +1,133 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/api/electron_api_heap_snapshot_reader.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "gin/object_template_builder.h"
+#include "shell/common/node_includes.h"
+
+namespace electron {
+
+namespace api {
+
+gin::WrapperInfo HeapSnapshotReader::kWrapperInfo = {gin::kEmbedderNativeGin};
+
+HeapSnapshotReader::HeapSnapshotReader(
+    v8::Isolate* isolate,
+    mojo::ScopedDataPipeConsumerHandle consumer)
+    : isolate_(isolate),
+      consumer_(std::move(consumer)),
+      watcher_(FROM_HERE,
+               mojo::SimpleWatcher::ArmingPolicy::MANUAL,
+               base::SequencedTaskRunnerHandle::Get()) {
+  if (consumer_) {
+    watcher_.Watch(consumer_.get(), MOJO_HANDLE_SIGNAL_READABLE,
+                   base::BindRepeating(&HeapSnapshotReader::OnReadable,
+                                       base::Unretained(this)));
+  } else {
+    end_of_data_ = true;
+  }
+}
+
+HeapSnapshotReader::~HeapSnapshotReader() = default;
+
+// static
+gin::Handle<HeapSnapshotReader> HeapSnapshotReader::Create(
+    v8::Isolate* isolate,
+    mojo::ScopedDataPipeConsumerHandle consumer) {
+  return gin::CreateHandle(
+      isolate, new HeapSnapshotReader(isolate, std::move(consumer)));
+}
+
+void HeapSnapshotReader::OnSerialized(bool success) {
+  serialized_ = success;
+  MaybeFinish();
+}
+
+v8::Local<v8::Promise> HeapSnapshotReader::Read() {
+  util::Promise<v8::Local<v8::Value>> promise(isolate_);
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+  if (pending_read_) {
+    promise.RejectWithErrorMessage("A read is already pending");
+    return handle;
+  }
+  pending_read_.emplace(std::move(promise));
+  ReadData();
+  return handle;
+}
+
+void HeapSnapshotReader::ReadData() {
+  if (end_of_data_) {
+    MaybeFinish();
+    return;
+  }
+
+  const void* buffer = nullptr;
+  uint32_t num_bytes = 0;
+  MojoResult result =
+      consumer_->BeginReadData(&buffer, &num_bytes, MOJO_READ_DATA_FLAG_NONE);
+  if (result == MOJO_RESULT_SHOULD_WAIT) {
+    watcher_.ArmOrNotify();
+    return;
+  }
+  if (result != MOJO_RESULT_OK) {
+    // MOJO_RESULT_FAILED_PRECONDITION: the producer has been closed and
+    // everything has been read.
+    end_of_data_ = true;
+    watcher_.Cancel();
+    consumer_.reset();
+    if (result != MOJO_RESULT_FAILED_PRECONDITION)
+      serialized_ = false;
+    MaybeFinish();
+    return;
+  }
+
+  v8::HandleScope handle_scope(isolate_);
+  auto promise = std::move(*pending_read_);
+  pending_read_.reset();
+  v8::Context::Scope context_scope(promise.GetContext());
+  v8::Local<v8::Value> chunk =
+      node::Buffer::Copy(isolate_, static_cast<const char*>(buffer), num_bytes)
+          .ToLocalChecked();
+  consumer_->EndReadData(num_bytes);
+  promise.Resolve(chunk);
+}
+
+void HeapSnapshotReader::OnReadable(MojoResult result) {
+  if (pending_read_)
+    ReadData();
+}
+
+void HeapSnapshotReader::MaybeFinish() {
+  if (!pending_read_ || !end_of_data_ || !serialized_)
+    return;
+
+  v8::HandleScope handle_scope(isolate_);
+  auto promise = std::move(*pending_read_);
+  pending_read_.reset();
+  if (*serialized_) {
+    v8::Context::Scope context_scope(promise.GetContext());
+    promise.Resolve(v8::Null(isolate_));
+  } else {
+    promise.RejectWithErrorMessage("takeHeapSnapshot failed");
+  }
+}
+
+gin::ObjectTemplateBuilder HeapSnapshotReader::GetObjectTemplateBuilder(
+    v8::Isolate* isolate) {
+  return gin::Wrappable<HeapSnapshotReader>::GetObjectTemplateBuilder(isolate)
+      .SetMethod("read", &HeapSnapshotReader::Read);
+}
+
+const char* HeapSnapshotReader::GetTypeName() {
+  return "HeapSnapshotReader";
+}
+
+}  // namespace api
+
+}  // namespace electron
@@ -0,0 +1,74 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_API_ELECTRON_API_HEAP_SNAPSHOT_READER_H_
+#define SHELL_BROWSER_API_ELECTRON_API_HEAP_SNAPSHOT_READER_H_
+
+#include "base/memory/weak_ptr.h"
+#include "base/optional.h"
+#include "gin/handle.h"
+#include "gin/wrappable.h"
+#include "mojo/public/cpp/system/data_pipe.h"
+#include "mojo/public/cpp/system/simple_watcher.h"
+#include "shell/common/promise_util.h"
+
+namespace electron {
+
+namespace api {
+
+// Reads a heap snapshot streamed by a renderer through a data pipe, backing
+// the Readable returned by webContents.takeHeapSnapshotStream().
+class HeapSnapshotReader : public gin::Wrappable<HeapSnapshotReader> {
+ public:
+  static gin::WrapperInfo kWrapperInfo;
+
+  static gin::Handle<HeapSnapshotReader> Create(
+      v8::Isolate* isolate,
+      mojo::ScopedDataPipeConsumerHandle consumer);
+
+  // Called once the renderer has finished serializing the snapshot.
+  void OnSerialized(bool success);
+
+  base::WeakPtr<HeapSnapshotReader> GetWeakPtr() {
+    return weak_factory_.GetWeakPtr();
+  }
+
+  // gin::Wrappable:
+  gin::ObjectTemplateBuilder GetObjectTemplateBuilder(
+      v8::Isolate* isolate) override;
+  const char* GetTypeName() override;
+
+ private:
+  HeapSnapshotReader(v8::Isolate* isolate,
+                     mojo::ScopedDataPipeConsumerHandle consumer);
+  ~HeapSnapshotReader() override;
+
+  // Resolves with a Buffer of the data available next, or null once the
+  // whole snapshot has been read.
+  v8::Local<v8::Promise> Read();
+
+  void ReadData();
+  void OnReadable(MojoResult result);
+  void MaybeFinish();
+
+  v8::Isolate* isolate_;
+  mojo::ScopedDataPipeConsumerHandle consumer_;
+  mojo::SimpleWatcher watcher_;
+
+  base::Optional<util::Promise<v8::Local<v8::Value>>> pending_read_;
+  // Set once the producer has been closed and all the data has been read.
+  bool end_of_data_ = false;
+  // Whether the renderer serialized the snapshot, once it has replied.
+  base::Optional<bool> serialized_;
+
+  base::WeakPtrFactory<HeapSnapshotReader> weak_factory_{this};
+
+  DISALLOW_COPY_AND_ASSIGN(HeapSnapshotReader);
+};
+
+}  // namespace api
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_API_ELECTRON_API_HEAP_SNAPSHOT_READER_H_
@@ -0,0 +1,101 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/api/electron_api_ipc_raw_message.h"
+
+#include <stdlib.h>
+
+#include <utility>
+
+#include "base/containers/span.h"
+#include "gin/object_template_builder.h"
+#include "shell/common/gin_converters/blink_converter_gin_adapter.h"
+#include "shell/common/native_mate_converters/serialized_message.h"
+#include "shell/common/node_includes.h"
+
+namespace electron {
+
+namespace api {
+
+gin::WrapperInfo IPCRawMessage::kWrapperInfo = {gin::kEmbedderNativeGin};
+
+IPCRawMessage::IPCRawMessage(const std::string& channel,
+                             blink::CloneableMessage message)
+    : channel_(channel), message_(std::move(message)) {}
+
+IPCRawMessage::~IPCRawMessage() = default;
+
+// static
+gin::Handle<IPCRawMessage> IPCRawMessage::Create(
+    v8::Isolate* isolate,
+    const std::string& channel,
+    blink::CloneableMessage message) {
+  return gin::CreateHandle(isolate,
+                           new IPCRawMessage(channel, std::move(message)));
+}
+
+std::string IPCRawMessage::GetChannel() const {
+  return channel_;
+}
+
+size_t IPCRawMessage::GetSize() const {
+  return message_.encoded_message.size();
+}
+
+v8::Local<v8::Value> IPCRawMessage::GetArgs(v8::Isolate* isolate) {
+  if (args_.IsEmpty())
+    args_.Reset(isolate, gin::ConvertToV8(isolate, message_));
+  return args_.Get(isolate);
+}
+
+v8::Local<v8::Value> IPCRawMessage::ToBuffer(v8::Isolate* isolate) {
+  // Drop the serialization tag, so that the buffer is what v8.serialize()
+  // returns for the arguments.
+  base::span<const uint8_t> data = message_.encoded_message;
+  size_t header_size = serialized_message::GetHeaderSize(data);
+  if (header_size && header_size < data.size() &&
+      data[header_size] == serialized_message::kNewSerializationTag) {
+    v8::Local<v8::Object> buffer =
+        node::Buffer::New(isolate, data.size() - 1).ToLocalChecked();
+    char* out = node::Buffer::Data(buffer);
+    memcpy(out, data.data(), header_size);
+    memcpy(out + header_size, data.data() + header_size + 1,
+           data.size() - header_size - 1);
+    return buffer;
+  }
+
+  // Arguments serialized as a base::Value have to be read to be written in
+  // the format of the ValueSerializer.
+  v8::ValueSerializer serializer(isolate);
+  serializer.WriteHeader();
+  bool wrote_value;
+  if (!serializer.WriteValue(isolate->GetCurrentContext(), GetArgs(isolate))
+           .To(&wrote_value))
+    return v8::Local<v8::Value>();
+  DCHECK(wrote_value);
+  std::pair<uint8_t*, size_t> serialized = serializer.Release();
+  v8::Local<v8::Object> buffer =
+      node::Buffer::Copy(isolate, reinterpret_cast<char*>(serialized.first),
+                         serialized.second)
+          .ToLocalChecked();
+  free(serialized.first);
+  return buffer;
+}
+
+gin::ObjectTemplateBuilder IPCRawMessage::GetObjectTemplateBuilder(
+    v8::Isolate* isolate) {
+  return gin::Wrappable<IPCRawMessage>::GetObjectTemplateBuilder(isolate)
+      .SetMethod("toBuffer", &IPCRawMessage::ToBuffer)
+      .SetProperty("channel", &IPCRawMessage::GetChannel)
+      .SetProperty("size", &IPCRawMessage::GetSize)
+      .SetProperty("args", &IPCRawMessage::GetArgs);
+}
+
+const char* IPCRawMessage::GetTypeName() {
+  return "IPCRawMessage";
+}
+
+}  // namespace api
+
+}  // namespace electron
@@ -0,0 +1,59 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_API_ELECTRON_API_IPC_RAW_MESSAGE_H_
+#define SHELL_BROWSER_API_ELECTRON_API_IPC_RAW_MESSAGE_H_
+
+#include <string>
+
+#include "gin/handle.h"
+#include "gin/wrappable.h"
+#include "third_party/blink/public/common/messaging/cloneable_message.h"
+
+namespace electron {
+
+namespace api {
+
+// A message received on a channel listened to with ipcMain.onRaw(). Its
+// arguments are only deserialized when they are accessed, so that it can be
+// forwarded or stored as is.
+class IPCRawMessage : public gin::Wrappable<IPCRawMessage> {
+ public:
+  static gin::WrapperInfo kWrapperInfo;
+
+  static gin::Handle<IPCRawMessage> Create(v8::Isolate* isolate,
+                                           const std::string& channel,
+                                           blink::CloneableMessage message);
+
+  // gin::Wrappable:
+  gin::ObjectTemplateBuilder GetObjectTemplateBuilder(
+      v8::Isolate* isolate) override;
+  const char* GetTypeName() override;
+
+  const std::string& channel() const { return channel_; }
+  const blink::CloneableMessage& message() const { return message_; }
+
+ private:
+  IPCRawMessage(const std::string& channel, blink::CloneableMessage message);
+  ~IPCRawMessage() override;
+
+  std::string GetChannel() const;
+  size_t GetSize() const;
+  v8::Local<v8::Value> GetArgs(v8::Isolate* isolate);
+  v8::Local<v8::Value> ToBuffer(v8::Isolate* isolate);
+
+  std::string channel_;
+  blink::CloneableMessage message_;
+
+  // The deserialized arguments, once accessed.
+  v8::Global<v8::Value> args_;
+
+  DISALLOW_COPY_AND_ASSIGN(IPCRawMessage);
+};
+
+}  // namespace api
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_API_ELECTRON_API_IPC_RAW_MESSAGE_H_
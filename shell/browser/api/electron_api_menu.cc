@@ -5,15 +5,16 @@
 #include "shell/browser/api/electron_api_menu.h"
 
 #include <map>
+#include <string>
 #include <utility>
 
 #include "native_mate/constructor.h"
 #include "shell/browser/native_window.h"
+#include "shell/browser/ui/accelerator_util.h"
 #include "shell/common/gin_converters/callback_converter.h"
 #include "shell/common/gin_converters/image_converter.h"
 #include "shell/common/gin_helper/dictionary.h"
 #include "shell/common/gin_helper/object_template_builder.h"
-#include "shell/common/native_mate_converters/accelerator_converter.h"
 #include "shell/common/node_includes.h"
 
 namespace {
@@ -46,56 +47,44 @@ void Menu::AfterInit(v8::Isolate* isolate) {
   if (!wrappable.Get("delegate", &delegate))
     return;
 
-  delegate.Get("isCommandIdChecked", &is_checked_);
-  delegate.Get("isCommandIdEnabled", &is_enabled_);
-  delegate.Get("isCommandIdVisible", &is_visible_);
-  delegate.Get("shouldCommandIdWorkWhenHidden", &works_when_hidden_);
-  delegate.Get("getAcceleratorForCommandId", &get_accelerator_);
-  delegate.Get("shouldRegisterAcceleratorForCommandId",
-               &should_register_accelerator_);
   delegate.Get("executeCommand", &execute_command_);
   delegate.Get("menuWillShow", &menu_will_show_);
 }
 
 bool Menu::IsCommandIdChecked(int command_id) const {
-  v8::Locker locker(isolate());
-  v8::HandleScope handle_scope(isolate());
-  return is_checked_.Run(GetWrapper(), command_id);
+  return model_->GetCommandState(command_id).checked;
 }
 
 bool Menu::IsCommandIdEnabled(int command_id) const {
-  v8::Locker locker(isolate());
-  v8::HandleScope handle_scope(isolate());
-  return is_enabled_.Run(GetWrapper(), command_id);
+  return model_->GetCommandState(command_id).enabled;
 }
 
 bool Menu::IsCommandIdVisible(int command_id) const {
-  v8::Locker locker(isolate());
-  v8::HandleScope handle_scope(isolate());
-  return is_visible_.Run(GetWrapper(), command_id);
+  return model_->GetCommandState(command_id).visible;
 }
 
 bool Menu::ShouldCommandIdWorkWhenHidden(int command_id) const {
-  v8::Locker locker(isolate());
-  v8::HandleScope handle_scope(isolate());
-  return works_when_hidden_.Run(GetWrapper(), command_id);
+  return model_->GetCommandState(command_id).works_when_hidden;
 }
 
 bool Menu::GetAcceleratorForCommandIdWithParams(
     int command_id,
     bool use_default_accelerator,
     ui::Accelerator* accelerator) const {
-  v8::Locker locker(isolate());
-  v8::HandleScope handle_scope(isolate());
-  v8::Local<v8::Value> val =
-      get_accelerator_.Run(GetWrapper(), command_id, use_default_accelerator);
-  return mate::ConvertFromV8(isolate(), val, accelerator);
+  const auto& state = model_->GetCommandState(command_id);
+  if (state.accelerator) {
+    *accelerator = *state.accelerator;
+    return true;
+  }
+  if (use_default_accelerator && state.default_accelerator) {
+    *accelerator = *state.default_accelerator;
+    return true;
+  }
+  return false;
 }
 
 bool Menu::ShouldRegisterAcceleratorForCommandId(int command_id) const {
-  v8::Locker locker(isolate());
-  v8::HandleScope handle_scope(isolate());
-  return should_register_accelerator_.Run(GetWrapper(), command_id);
+  return model_->GetCommandState(command_id).register_accelerator;
 }
 
 void Menu::ExecuteCommand(int command_id, int flags) {
@@ -159,6 +148,30 @@ void Menu::SetRole(int index, const base::string16& role) {
   model_->SetRole(index, role);
 }
 
+void Menu::SetCommandStates(
+    const std::vector<gin_helper::Dictionary>& states) {
+  for (const auto& dict : states) {
+    int command_id;
+    if (!dict.Get("commandId", &command_id))
+      continue;
+    ElectronMenuModel::CommandState state;
+    dict.Get("checked", &state.checked);
+    dict.Get("enabled", &state.enabled);
+    dict.Get("visible", &state.visible);
+    dict.Get("acceleratorWorksWhenHidden", &state.works_when_hidden);
+    dict.Get("registerAccelerator", &state.register_accelerator);
+    std::string keycode;
+    ui::Accelerator accelerator;
+    if (dict.Get("accelerator", &keycode) &&
+        accelerator_util::StringToAccelerator(keycode, &accelerator))
+      state.accelerator = accelerator;
+    if (dict.Get("defaultAccelerator", &keycode) &&
+        accelerator_util::StringToAccelerator(keycode, &accelerator))
+      state.default_accelerator = accelerator;
+    model_->SetCommandState(command_id, state);
+  }
+}
+
 void Menu::Clear() {
   model_->Clear();
 }
@@ -244,6 +257,7 @@ void Menu::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("setSublabel", &Menu::SetSublabel)
       .SetMethod("setToolTip", &Menu::SetToolTip)
       .SetMethod("setRole", &Menu::SetRole)
+      .SetMethod("setCommandStates", &Menu::SetCommandStates)
       .SetMethod("clear", &Menu::Clear)
       .SetMethod("getIndexOfCommandId", &Menu::GetIndexOfCommandId)
       .SetMethod("getItemCount", &Menu::GetItemCount)
@@ -7,12 +7,14 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/callback.h"
 #include "gin/arguments.h"
 #include "shell/browser/api/electron_api_top_level_window.h"
 #include "shell/browser/api/trackable_object.h"
 #include "shell/browser/ui/electron_menu_model.h"
+#include "shell/common/gin_helper/dictionary.h"
 
 namespace electron {
 
@@ -94,6 +96,7 @@ class Menu : public mate::TrackableObject<Menu>,
   void SetSublabel(int index, const base::string16& sublabel);
   void SetToolTip(int index, const base::string16& toolTip);
   void SetRole(int index, const base::string16& role);
+  void SetCommandStates(const std::vector<gin_helper::Dictionary>& states);
   void Clear();
   int GetIndexOfCommandId(int command_id);
   int GetItemCount() const;
@@ -108,14 +111,6 @@ class Menu : public mate::TrackableObject<Menu>,
   bool WorksWhenHiddenAt(int index) const;
 
   // Stored delegate methods.
-  base::RepeatingCallback<bool(v8::Local<v8::Value>, int)> is_checked_;
-  base::RepeatingCallback<bool(v8::Local<v8::Value>, int)> is_enabled_;
-  base::RepeatingCallback<bool(v8::Local<v8::Value>, int)> is_visible_;
-  base::RepeatingCallback<bool(v8::Local<v8::Value>, int)> works_when_hidden_;
-  base::RepeatingCallback<v8::Local<v8::Value>(v8::Local<v8::Value>, int, bool)>
-      get_accelerator_;
-  base::RepeatingCallback<bool(v8::Local<v8::Value>, int)>
-      should_register_accelerator_;
   base::RepeatingCallback<void(v8::Local<v8::Value>, v8::Local<v8::Value>, int)>
       execute_command_;
   base::RepeatingCallback<void(v8::Local<v8::Value>)> menu_will_show_;
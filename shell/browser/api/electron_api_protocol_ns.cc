@@ -14,8 +14,12 @@
 #include "shell/browser/electron_browser_context.h"
 #include "shell/common/deprecate_util.h"
 #include "shell/common/gin_converters/callback_converter.h"
+#include "shell/common/gin_converters/file_path_converter.h"
 #include "shell/common/gin_converters/net_converter.h"
+#include "shell/common/gin_converters/std_converter.h"
+#include "shell/common/gin_converters/value_converter_gin_adapter.h"
 #include "shell/common/gin_helper/dictionary.h"
+#include "shell/common/gin_helper/error_thrower.h"
 #include "shell/common/gin_helper/object_template_builder.h"
 #include "shell/common/options_switches.h"
 #include "shell/common/promise_util.h"
@@ -142,6 +146,9 @@ const char* kBuiltinSchemes[] = {
     "about", "file", "http", "https", "data", "filesystem",
 };
 
+// Default limit of the response bodies kept in the cache of a scheme.
+const int64_t kDefaultResponseCacheSize = 32 * 1024 * 1024;
+
 // Convert error code to string.
 std::string ErrorCodeToString(ProtocolError error) {
   switch (error) {
@@ -171,8 +178,14 @@ ProtocolNS::~ProtocolNS() = default;
 void ProtocolNS::RegisterURLLoaderFactories(
     content::ContentBrowserClient::NonNetworkURLLoaderFactoryMap* factories) {
   for (const auto& it : handlers_) {
+    if (it.second.first == ProtocolType::kDirectory) {
+      factories->emplace(it.first, std::make_unique<ElectronURLLoaderFactory>(
+                                       directory_roots_[it.first]));
+      continue;
+    }
     factories->emplace(it.first, std::make_unique<ElectronURLLoaderFactory>(
-                                     it.second.first, it.second.second));
+                                     it.second.first, it.second.second,
+                                     response_caches_[it.first]));
   }
 }
 
@@ -180,12 +193,51 @@ ProtocolError ProtocolNS::RegisterProtocol(ProtocolType type,
                                            const std::string& scheme,
                                            const ProtocolHandler& handler) {
   const bool added = base::TryEmplace(handlers_, scheme, type, handler).second;
-  return added ? ProtocolError::OK : ProtocolError::REGISTERED;
+  if (!added)
+    return ProtocolError::REGISTERED;
+  response_caches_[scheme] = base::MakeRefCounted<ProtocolResponseCache>();
+  return ProtocolError::OK;
+}
+
+void ProtocolNS::RegisterDirectoryProtocol(gin_helper::ErrorThrower thrower,
+                                           const std::string& scheme,
+                                           v8::Local<v8::Value> root) {
+  DirectoryRoots roots;
+  base::FilePath path;
+  if (gin::ConvertFromV8(isolate(), root, &path))
+    roots[std::string()] = path;
+  else if (!gin::ConvertFromV8(isolate(), root, &roots))
+    roots.clear();
+  if (roots.empty()) {
+    thrower.ThrowError("root must be a path or an object of paths by host");
+    return;
+  }
+  for (const auto& it : roots) {
+    if (!it.second.IsAbsolute()) {
+      thrower.ThrowError("root paths must be absolute");
+      return;
+    }
+  }
+
+  if (!base::TryEmplace(handlers_, scheme, ProtocolType::kDirectory,
+                        ProtocolHandler())
+           .second) {
+    thrower.ThrowError(ErrorCodeToString(ProtocolError::REGISTERED));
+    return;
+  }
+  directory_roots_[scheme] = std::move(roots);
 }
 
 void ProtocolNS::UnregisterProtocol(const std::string& scheme,
                                     gin::Arguments* args) {
   const bool removed = handlers_.erase(scheme) != 0;
+  directory_roots_.erase(scheme);
+  auto it = response_caches_.find(scheme);
+  if (it != response_caches_.end()) {
+    // Factories created for the scheme may still hold the cache.
+    it->second->Disable();
+    response_caches_.erase(it);
+  }
   const auto error =
       removed ? ProtocolError::OK : ProtocolError::NOT_REGISTERED;
   HandleOptionalCallback(args, error);
@@ -215,6 +267,48 @@ bool ProtocolNS::IsProtocolIntercepted(const std::string& scheme) {
   return base::Contains(intercept_handlers_, scheme);
 }
 
+void ProtocolNS::EnableResponseCache(const std::string& scheme,
+                                     gin::Arguments* args) {
+  gin_helper::ErrorThrower thrower(args->isolate());
+  auto it = response_caches_.find(scheme);
+  if (it == response_caches_.end()) {
+    thrower.ThrowError(ErrorCodeToString(ProtocolError::NOT_REGISTERED));
+    return;
+  }
+
+  int64_t max_size = kDefaultResponseCacheSize;
+  gin::Dictionary options(args->isolate());
+  if (args->GetNext(&options))
+    options.Get("maxSize", &max_size);
+  if (max_size <= 0) {
+    thrower.ThrowError("maxSize must be a positive number");
+    return;
+  }
+  it->second->Enable(max_size);
+}
+
+void ProtocolNS::DisableResponseCache(const std::string& scheme,
+                                      gin::Arguments* args) {
+  auto it = response_caches_.find(scheme);
+  if (it == response_caches_.end()) {
+    gin_helper::ErrorThrower(args->isolate())
+        .ThrowError(ErrorCodeToString(ProtocolError::NOT_REGISTERED));
+    return;
+  }
+  it->second->Disable();
+}
+
+v8::Local<v8::Value> ProtocolNS::GetResponseCacheStats(
+    gin_helper::ErrorThrower thrower,
+    const std::string& scheme) {
+  auto it = response_caches_.find(scheme);
+  if (it == response_caches_.end()) {
+    thrower.ThrowError(ErrorCodeToString(ProtocolError::NOT_REGISTERED));
+    return v8::Undefined(isolate());
+  }
+  return gin::ConvertToV8(isolate(), it->second->GetStats());
+}
+
 v8::Local<v8::Promise> ProtocolNS::IsProtocolHandled(const std::string& scheme,
                                                      gin::Arguments* args) {
   node::Environment* env = node::Environment::GetCurrent(args->isolate());
@@ -278,9 +372,14 @@ void ProtocolNS::BuildPrototype(v8::Isolate* isolate,
                  &ProtocolNS::RegisterProtocolFor<ProtocolType::kStream>)
       .SetMethod("registerProtocol",
                  &ProtocolNS::RegisterProtocolFor<ProtocolType::kFree>)
+      .SetMethod("registerDirectoryProtocol",
+                 &ProtocolNS::RegisterDirectoryProtocol)
       .SetMethod("unregisterProtocol", &ProtocolNS::UnregisterProtocol)
       .SetMethod("isProtocolRegistered", &ProtocolNS::IsProtocolRegistered)
       .SetMethod("isProtocolHandled", &ProtocolNS::IsProtocolHandled)
+      .SetMethod("enableResponseCache", &ProtocolNS::EnableResponseCache)
+      .SetMethod("disableResponseCache", &ProtocolNS::DisableResponseCache)
+      .SetMethod("getResponseCacheStats", &ProtocolNS::GetResponseCacheStats)
       .SetMethod("interceptStringProtocol",
                  &ProtocolNS::InterceptProtocolFor<ProtocolType::kString>)
       .SetMethod("interceptBufferProtocol",
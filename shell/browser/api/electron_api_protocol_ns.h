@@ -5,6 +5,7 @@
 #ifndef SHELL_BROWSER_API_ELECTRON_API_PROTOCOL_NS_H_
 #define SHELL_BROWSER_API_ELECTRON_API_PROTOCOL_NS_H_
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -62,6 +63,9 @@ class ProtocolNS : public mate::TrackableObject<ProtocolNS> {
   ProtocolError RegisterProtocol(ProtocolType type,
                                  const std::string& scheme,
                                  const ProtocolHandler& handler);
+  void RegisterDirectoryProtocol(gin_helper::ErrorThrower thrower,
+                                 const std::string& scheme,
+                                 v8::Local<v8::Value> root);
   void UnregisterProtocol(const std::string& scheme, gin::Arguments* args);
   bool IsProtocolRegistered(const std::string& scheme);
 
@@ -71,6 +75,12 @@ class ProtocolNS : public mate::TrackableObject<ProtocolNS> {
   void UninterceptProtocol(const std::string& scheme, gin::Arguments* args);
   bool IsProtocolIntercepted(const std::string& scheme);
 
+  // Response cache of registered schemes.
+  void EnableResponseCache(const std::string& scheme, gin::Arguments* args);
+  void DisableResponseCache(const std::string& scheme, gin::Arguments* args);
+  v8::Local<v8::Value> GetResponseCacheStats(gin_helper::ErrorThrower thrower,
+                                             const std::string& scheme);
+
   // Old async version of IsProtocolRegistered.
   v8::Local<v8::Promise> IsProtocolHandled(const std::string& scheme,
                                            gin::Arguments* args);
@@ -94,6 +104,11 @@ class ProtocolNS : public mate::TrackableObject<ProtocolNS> {
 
   HandlersMap handlers_;
   HandlersMap intercept_handlers_;
+
+  // scheme => roots, for the schemes of ProtocolType::kDirectory.
+  std::map<std::string, DirectoryRoots> directory_roots_;
+  // scheme => cache, for the other schemes in |handlers_|.
+  std::map<std::string, scoped_refptr<ProtocolResponseCache>> response_caches_;
 };
 
 }  // namespace api
@@ -11,8 +11,10 @@
 #include <utility>
 #include <vector>
 
+#include "base/bind.h"
 #include "base/command_line.h"
 #include "base/files/file_path.h"
+#include "base/files/file_util.h"
 #include "base/guid.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
@@ -224,6 +226,19 @@ void DestroyGlobalHandle(v8::Isolate* isolate,
   }
 }
 
+// Pref writes made while a session with |asyncPrefs| is still reading its
+// prefs would be overwritten by the read, so they wait for it.
+void WritePrefsWhenLoaded(ElectronBrowserContext* browser_context,
+                          base::OnceCallback<void(PrefService*)> write) {
+  browser_context->RunWhenPrefsLoaded(base::BindOnce(
+      [](base::WeakPtr<ElectronBrowserContext> browser_context,
+         base::OnceCallback<void(PrefService*)> write) {
+        if (browser_context)
+          std::move(write).Run(browser_context->prefs());
+      },
+      browser_context->GetWeakPtr(), std::move(write)));
+}
+
 }  // namespace
 
 Session::Session(v8::Isolate* isolate, ElectronBrowserContext* browser_context)
@@ -341,6 +356,37 @@ v8::Local<v8::Promise> Session::GetCacheSize() {
   return handle;
 }
 
+v8::Local<v8::Promise> Session::GetCodeCacheUsage() {
+  auto* isolate = v8::Isolate::GetCurrent();
+  util::Promise<base::DictionaryValue> promise(isolate);
+  auto handle = promise.GetHandle();
+
+  // In-memory sessions have no code cache, see StoragePartitionImpl.
+  base::FilePath path;
+  if (!browser_context_->IsOffTheRecord())
+    path = browser_context_->GetPath().AppendASCII("Code Cache");
+  base::PostTaskAndReplyWithResult(
+      FROM_HERE,
+      {base::ThreadPool(), base::MayBlock(),
+       base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(
+          [](const base::FilePath& path) {
+            return path.empty() ? 0 : base::ComputeDirectorySize(path);
+          },
+          path),
+      base::BindOnce(
+          [](util::Promise<base::DictionaryValue> promise, int max_size,
+             int64_t size) {
+            base::DictionaryValue usage;
+            usage.SetDouble("size", size);
+            usage.SetDouble("maxSize", max_size);
+            promise.Resolve(usage);
+          },
+          std::move(promise), browser_context_->GetMaxCodeCacheSize()));
+
+  return handle;
+}
+
 v8::Local<v8::Promise> Session::ClearCache() {
   auto* isolate = v8::Isolate::GetCurrent();
   util::Promise<void*> promise(isolate);
@@ -368,7 +414,8 @@ v8::Local<v8::Promise> Session::ClearStorageData(mate::Arguments* args) {
   if (options.storage_types & StoragePartition::REMOVE_DATA_MASK_COOKIES) {
     // Reset media device id salt when cookies are cleared.
     // https://w3c.github.io/mediacapture-main/#dom-mediadeviceinfo-deviceid
-    MediaDeviceIDSalt::Reset(browser_context()->prefs());
+    WritePrefsWhenLoaded(browser_context(),
+                         base::BindOnce(&MediaDeviceIDSalt::Reset));
   }
 
   storage_partition->ClearData(
@@ -427,8 +474,14 @@ v8::Local<v8::Promise> Session::SetProxy(mate::Arguments* args) {
 }
 
 void Session::SetDownloadPath(const base::FilePath& path) {
-  browser_context_->prefs()->SetFilePath(prefs::kDownloadDefaultDirectory,
-                                         path);
+  WritePrefsWhenLoaded(browser_context(),
+                       base::BindOnce(
+                           [](const base::FilePath& path,
+                              PrefService* pref_service) {
+                             pref_service->SetFilePath(
+                                 prefs::kDownloadDefaultDirectory, path);
+                           },
+                           path));
 }
 
 void Session::EnableNetworkEmulation(const mate::Dictionary& options) {
@@ -646,9 +699,19 @@ std::vector<base::FilePath::StringType> Session::GetPreloads() const {
 
 #if BUILDFLAG(ENABLE_ELECTRON_EXTENSIONS)
 void Session::LoadChromeExtension(const base::FilePath extension_path) {
-  auto* extension_system = static_cast<extensions::ElectronExtensionSystem*>(
-      extensions::ExtensionSystem::Get(browser_context()));
-  extension_system->LoadExtension(extension_path);
+  // The extension system is initialized once the prefs are read, see the
+  // |asyncPrefs| session option.
+  browser_context_->RunWhenPrefsLoaded(base::BindOnce(
+      [](base::WeakPtr<ElectronBrowserContext> browser_context,
+         const base::FilePath& extension_path) {
+        if (!browser_context)
+          return;
+        auto* extension_system =
+            static_cast<extensions::ElectronExtensionSystem*>(
+                extensions::ExtensionSystem::Get(browser_context.get()));
+        extension_system->LoadExtension(extension_path);
+      },
+      browser_context_->GetWeakPtr(), extension_path));
 }
 #endif
 
@@ -724,8 +787,7 @@ void Session::Preconnect(const mate::Dictionary& options,
 
 #if BUILDFLAG(ENABLE_BUILTIN_SPELLCHECKER)
 base::Value Session::GetSpellCheckerLanguages() {
-  return browser_context_->prefs()
-      ->Get(spellcheck::prefs::kSpellCheckDictionaries)
+  return browser_context_->GetPref(spellcheck::prefs::kSpellCheckDictionaries)
       ->Clone();
 }
 
@@ -742,8 +804,14 @@ void Session::SetSpellCheckerLanguages(
     }
     language_codes.AppendString(code);
   }
-  browser_context_->prefs()->Set(spellcheck::prefs::kSpellCheckDictionaries,
-                                 language_codes);
+  WritePrefsWhenLoaded(
+      browser_context(),
+      base::BindOnce(
+          [](base::Value language_codes, PrefService* pref_service) {
+            pref_service->Set(spellcheck::prefs::kSpellCheckDictionaries,
+                              language_codes);
+          },
+          base::Value(std::move(language_codes))));
 }
 
 void SetSpellCheckerDictionaryDownloadURL(gin_helper::ErrorThrower thrower,
@@ -817,6 +885,7 @@ void Session::BuildPrototype(v8::Isolate* isolate,
   mate::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
       .SetMethod("resolveProxy", &Session::ResolveProxy)
       .SetMethod("getCacheSize", &Session::GetCacheSize)
+      .SetMethod("getCodeCacheUsage", &Session::GetCodeCacheUsage)
       .SetMethod("clearCache", &Session::ClearCache)
       .SetMethod("clearStorageData", &Session::ClearStorageData)
       .SetMethod("flushStorageData", &Session::FlushStorageData)
@@ -69,6 +69,7 @@ class Session : public mate::TrackableObject<Session>,
   // Methods.
   v8::Local<v8::Promise> ResolveProxy(mate::Arguments* args);
   v8::Local<v8::Promise> GetCacheSize();
+  v8::Local<v8::Promise> GetCodeCacheUsage();
   v8::Local<v8::Promise> ClearCache();
   v8::Local<v8::Promise> ClearStorageData(mate::Arguments* args);
   void FlushStorageData();
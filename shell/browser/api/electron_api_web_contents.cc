@@ -4,6 +4,7 @@
 
 #include "shell/browser/api/electron_api_web_contents.h"
 
+#include <algorithm>
 #include <limits>
 #include <memory>
 #include <set>
@@ -11,12 +12,14 @@
 #include <utility>
 #include <vector>
 
+#include "base/memory/read_only_shared_memory_region.h"
 #include "base/message_loop/message_loop_current.h"
 #include "base/no_destructor.h"
 #include "base/optional.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/threading/thread_task_runner_handle.h"
+#include "base/time/time.h"
 #include "base/values.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/ssl/security_state_tab_helper.h"
@@ -46,13 +49,17 @@
 #include "electron/buildflags/buildflags.h"
 #include "electron/shell/common/api/api.mojom.h"
 #include "mojo/public/cpp/bindings/associated_remote.h"
-#include "mojo/public/cpp/system/platform_handle.h"
+#include "mojo/public/cpp/bindings/callback_helpers.h"
+#include "mojo/public/cpp/bindings/self_owned_receiver.h"
+#include "mojo/public/cpp/system/data_pipe.h"
 #include "native_mate/converter.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder_deprecated.h"
 #include "ppapi/buildflags/buildflags.h"
 #include "shell/browser/api/electron_api_browser_window.h"
 #include "shell/browser/api/electron_api_debugger.h"
+#include "shell/browser/api/electron_api_heap_snapshot_reader.h"
+#include "shell/browser/api/electron_api_ipc_raw_message.h"
 #include "shell/browser/api/electron_api_session.h"
 #include "shell/browser/browser.h"
 #include "shell/browser/child_web_contents_tracker.h"
@@ -63,6 +70,7 @@
 #include "shell/browser/electron_javascript_dialog_manager.h"
 #include "shell/browser/electron_navigation_throttle.h"
 #include "shell/browser/lib/bluetooth_chooser.h"
+#include "shell/browser/native_ipc_handler_registry.h"
 #include "shell/browser/native_window.h"
 #include "shell/browser/session_preferences.h"
 #include "shell/browser/ui/drag_util.h"
@@ -77,6 +85,7 @@
 #include "shell/common/gin_converters/callback_converter.h"
 #include "shell/common/gin_converters/gfx_converter.h"
 #include "shell/common/gin_helper/dictionary.h"
+#include "shell/common/heap_snapshot.h"
 #include "shell/common/language_util.h"
 #include "shell/common/mouse_util.h"
 #include "shell/common/native_mate_converters/blink_converter.h"
@@ -329,6 +338,83 @@ void OnCapturePageDone(util::Promise<gfx::Image> promise,
   promise.Resolve(gfx::Image::CreateFrom1xBitmap(bitmap));
 }
 
+// Capacity of the data pipe heap snapshots are streamed through.
+const uint32_t kHeapSnapshotPipeSize = 4 * 1024 * 1024;
+
+// How long the renderer waits for a heap snapshot stream to be read before
+// failing the snapshot, unless the caller chooses otherwise.
+const int kDefaultHeapSnapshotStallTimeoutMs = 30 * 1000;
+
+// Broadcast messages from this size on are put in shared memory mapped by
+// every target, as mojo would copy them into a new region for each one.
+const size_t kMinSharedMemoryBroadcastSize = 64 * 1024;
+
+// Channels listened to with ipcMain.onRaw().
+std::set<std::string>& GetRawIPCChannels() {
+  static base::NoDestructor<std::set<std::string>> channels;
+  return *channels;
+}
+
+// Creates the data pipe a heap snapshot is streamed through.
+bool CreateHeapSnapshotPipe(mojo::ScopedDataPipeProducerHandle* producer,
+                            mojo::ScopedDataPipeConsumerHandle* consumer) {
+  const MojoCreateDataPipeOptions pipe_options{
+      sizeof(MojoCreateDataPipeOptions), MOJO_CREATE_DATA_PIPE_FLAG_NONE, 1,
+      kHeapSnapshotPipeSize};
+  return mojo::CreateDataPipe(&pipe_options, producer, consumer) ==
+         MOJO_RESULT_OK;
+}
+
+// Forwards heap snapshot progress from the renderer to the JS object.
+class HeapSnapshotProgressObserver : public mojom::HeapSnapshotObserver {
+ public:
+  explicit HeapSnapshotProgressObserver(base::WeakPtr<WebContents> web_contents)
+      : web_contents_(web_contents) {}
+
+  // mojom::HeapSnapshotObserver:
+  void OnProgress(uint32_t done, uint32_t total) override {
+    if (web_contents_)
+      web_contents_->Emit("heap-snapshot-progress", done, total);
+  }
+
+ private:
+  base::WeakPtr<WebContents> web_contents_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeapSnapshotProgressObserver);
+};
+
+// Settles the takeHeapSnapshot promise once the renderer has finished
+// serializing and the browser has finished writing the file, whichever
+// happens last.
+class HeapSnapshotJob : public base::RefCounted<HeapSnapshotJob> {
+ public:
+  explicit HeapSnapshotJob(util::Promise<void*> promise)
+      : promise_(std::move(promise)) {}
+
+  void OnSerialized(bool success) { Finish(success); }
+  void OnWritten(bool success) { Finish(success); }
+
+ private:
+  friend class base::RefCounted<HeapSnapshotJob>;
+  ~HeapSnapshotJob() = default;
+
+  void Finish(bool success) {
+    success_ &= success;
+    if (++finished_steps_ < 2)
+      return;
+    if (success_)
+      promise_.Resolve();
+    else
+      promise_.RejectWithErrorMessage("takeHeapSnapshot failed");
+  }
+
+  util::Promise<void*> promise_;
+  int finished_steps_ = 0;
+  bool success_ = true;
+
+  DISALLOW_COPY_AND_ASSIGN(HeapSnapshotJob);
+};
+
 base::Optional<base::TimeDelta> GetCursorBlinkInterval() {
 #if defined(OS_MACOSX)
   base::TimeDelta interval;
@@ -393,6 +479,8 @@ WebContents::WebContents(v8::Isolate* isolate,
   InitZoomController(web_contents, mate::Dictionary::CreateEmpty(isolate));
   registry_.AddInterface(base::BindRepeating(&WebContents::BindElectronBrowser,
                                              base::Unretained(this)));
+  registry_.AddInterface(base::BindRepeating(
+      &WebContents::BindElectronNativeIpc, base::Unretained(this)));
   bindings_.set_connection_error_handler(base::BindRepeating(
       &WebContents::OnElectronBrowserConnectionError, base::Unretained(this)));
 }
@@ -576,6 +664,8 @@ void WebContents::InitWithSessionAndOptions(
 
   registry_.AddInterface(base::BindRepeating(&WebContents::BindElectronBrowser,
                                              base::Unretained(this)));
+  registry_.AddInterface(base::BindRepeating(
+      &WebContents::BindElectronNativeIpc, base::Unretained(this)));
   bindings_.set_connection_error_handler(base::BindRepeating(
       &WebContents::OnElectronBrowserConnectionError, base::Unretained(this)));
   AutofillDriverFactory::CreateForWebContents(web_contents());
@@ -946,6 +1036,8 @@ void WebContents::RenderViewCreated(content::RenderViewHost* render_view_host) {
 
 void WebContents::RenderFrameCreated(
     content::RenderFrameHost* render_frame_host) {
+  frames_by_routing_id_[render_frame_host->GetRoutingID()] = render_frame_host;
+
   auto* rwhv = render_frame_host->GetView();
   if (!rwhv)
     return;
@@ -1113,32 +1205,141 @@ void WebContents::OnElectronBrowserConnectionError() {
 void WebContents::Message(bool internal,
                           const std::string& channel,
                           blink::CloneableMessage arguments) {
-  TRACE_EVENT1("electron", "WebContents::Message", "channel", channel);
-  // webContents.emit('-ipc-message', new Event(), internal, channel,
-  // arguments);
-  EmitWithSender("-ipc-message", bindings_.dispatch_context(), base::nullopt,
-                 internal, channel, std::move(arguments));
+  ReceiveMessage(bindings_.dispatch_context(), internal, channel,
+                 std::move(arguments));
 }
 
 void WebContents::Invoke(bool internal,
                          const std::string& channel,
                          blink::CloneableMessage arguments,
                          InvokeCallback callback) {
-  TRACE_EVENT1("electron", "WebContents::Invoke", "channel", channel);
-  // webContents.emit('-ipc-invoke', new Event(), internal, channel, arguments);
-  EmitWithSender("-ipc-invoke", bindings_.dispatch_context(),
-                 std::move(callback), internal, channel, std::move(arguments));
+  ReceiveInvoke(bindings_.dispatch_context(), internal, channel,
+                std::move(arguments), std::move(callback));
 }
 
 void WebContents::MessageSync(bool internal,
                               const std::string& channel,
                               blink::CloneableMessage arguments,
                               MessageSyncCallback callback) {
+  ReceiveMessageSync(bindings_.dispatch_context(), internal, channel,
+                     std::move(arguments), std::move(callback));
+}
+
+void WebContents::ReceiveMessage(content::RenderFrameHost* sender,
+                                 bool internal,
+                                 const std::string& channel,
+                                 blink::CloneableMessage arguments) {
+  TRACE_EVENT1("electron", "WebContents::Message", "channel", channel);
+  ipc_stats_.RecordReceived(channel, arguments.encoded_message.size());
+  auto* native_handlers = NativeIpcHandlerRegistry::GetInstance();
+  if (!internal && native_handlers->CanHandle(channel, arguments)) {
+    native_handlers->Dispatch(ID(), channel, arguments,
+                              NativeIpcHandlerRegistry::ReplyType::kSendSync,
+                              NativeIpcHandlerRegistry::ReplyCallback());
+    return;
+  }
+  if (!internal && GetRawIPCChannels().count(channel)) {
+    v8::HandleScope handle_scope(isolate());
+    auto message =
+        IPCRawMessage::Create(isolate(), channel, std::move(arguments));
+    // webContents.emit('-ipc-message-raw', new Event(), message);
+    EmitWithSender("-ipc-message-raw", sender, base::nullopt, message.ToV8());
+    return;
+  }
+  // webContents.emit('-ipc-message', new Event(), internal, channel,
+  // arguments);
+  EmitWithSender("-ipc-message", sender, base::nullopt, internal, channel,
+                 std::move(arguments));
+}
+
+void WebContents::ReceiveInvoke(content::RenderFrameHost* sender,
+                                bool internal,
+                                const std::string& channel,
+                                blink::CloneableMessage arguments,
+                                InvokeCallback callback) {
+  TRACE_EVENT1("electron", "WebContents::Invoke", "channel", channel);
+  ipc_stats_.RecordReceived(channel, arguments.encoded_message.size());
+  auto reply = base::BindOnce(
+      [](base::WeakPtr<WebContents> self, const std::string& channel,
+         base::TimeTicks start, InvokeCallback callback,
+         blink::CloneableMessage result) {
+        if (self)
+          self->ipc_stats_.RecordInvoke(channel,
+                                        base::TimeTicks::Now() - start);
+        std::move(callback).Run(std::move(result));
+      },
+      GetWeakPtr(), channel, base::TimeTicks::Now(), std::move(callback));
+  auto* native_handlers = NativeIpcHandlerRegistry::GetInstance();
+  if (!internal && native_handlers->CanHandle(channel, arguments)) {
+    native_handlers->Dispatch(ID(), channel, arguments,
+                              NativeIpcHandlerRegistry::ReplyType::kInvoke,
+                              std::move(reply));
+    return;
+  }
+  // webContents.emit('-ipc-invoke', new Event(), internal, channel, arguments);
+  EmitWithSender("-ipc-invoke", sender, std::move(reply), internal, channel,
+                 std::move(arguments));
+}
+
+void WebContents::ReceiveMessageSync(content::RenderFrameHost* sender,
+                                     bool internal,
+                                     const std::string& channel,
+                                     blink::CloneableMessage arguments,
+                                     MessageSyncCallback callback) {
   TRACE_EVENT1("electron", "WebContents::MessageSync", "channel", channel);
+  ipc_stats_.RecordReceived(channel, arguments.encoded_message.size());
+  auto reply = base::BindOnce(
+      [](base::WeakPtr<WebContents> self, const std::string& channel,
+         base::TimeTicks start, MessageSyncCallback callback,
+         blink::CloneableMessage result) {
+        if (self)
+          self->ipc_stats_.RecordSendSync(channel,
+                                          base::TimeTicks::Now() - start);
+        std::move(callback).Run(std::move(result));
+      },
+      GetWeakPtr(), channel, base::TimeTicks::Now(), std::move(callback));
+  // Handled without waiting for the JavaScript of the main process.
+  auto* native_handlers = NativeIpcHandlerRegistry::GetInstance();
+  if (!internal && native_handlers->CanHandle(channel, arguments)) {
+    native_handlers->Dispatch(ID(), channel, arguments,
+                              NativeIpcHandlerRegistry::ReplyType::kSendSync,
+                              std::move(reply));
+    return;
+  }
   // webContents.emit('-ipc-message-sync', new Event(sender, message), internal,
   // channel, arguments);
-  EmitWithSender("-ipc-message-sync", bindings_.dispatch_context(),
-                 std::move(callback), internal, channel, std::move(arguments));
+  EmitWithSender("-ipc-message-sync", sender, std::move(reply), internal,
+                 channel, std::move(arguments));
+}
+
+void WebContents::BindElectronNativeIpc(
+    mojom::ElectronNativeIpcRequest request,
+    content::RenderFrameHost* render_frame_host) {
+  NativeIpcHandlerRegistry::GetInstance()->BindReceiver(
+      ID(),
+      base::BindRepeating(&WebContents::OnNativeIpcFallback, GetWeakPtr(),
+                          render_frame_host->GetProcess()->GetID(),
+                          render_frame_host->GetRoutingID()),
+      std::move(request));
+}
+
+void WebContents::OnNativeIpcFallback(
+    int process_id,
+    int routing_id,
+    NativeIpcHandlerRegistry::ReplyType reply_type,
+    const std::string& channel,
+    blink::CloneableMessage arguments,
+    NativeIpcHandlerRegistry::ReplyCallback reply) {
+  auto* sender = content::RenderFrameHost::FromID(process_id, routing_id);
+  if (!reply) {
+    ReceiveMessage(sender, false, channel, std::move(arguments));
+  } else if (reply_type == NativeIpcHandlerRegistry::ReplyType::kInvoke) {
+    ReceiveInvoke(sender, false, channel, std::move(arguments),
+                  std::move(reply));
+  } else {
+    ReceiveMessageSync(sender, false, channel, std::move(arguments),
+                       std::move(reply));
+  }
 }
 
 void WebContents::MessageTo(bool internal,
@@ -1147,6 +1348,7 @@ void WebContents::MessageTo(bool internal,
                             const std::string& channel,
                             blink::CloneableMessage arguments) {
   TRACE_EVENT1("electron", "WebContents::MessageTo", "channel", channel);
+  ipc_stats_.RecordReceived(channel, arguments.encoded_message.size());
   auto* web_contents = mate::TrackableObject<WebContents>::FromWeakMapID(
       isolate(), web_contents_id);
 
@@ -1159,11 +1361,37 @@ void WebContents::MessageTo(bool internal,
 void WebContents::MessageHost(const std::string& channel,
                               blink::CloneableMessage arguments) {
   TRACE_EVENT1("electron", "WebContents::MessageHost", "channel", channel);
+  ipc_stats_.RecordReceived(channel, arguments.encoded_message.size());
   // webContents.emit('ipc-message-host', new Event(), channel, args);
   EmitWithSender("ipc-message-host", bindings_.dispatch_context(),
                  base::nullopt, channel, std::move(arguments));
 }
 
+void WebContents::ConnectTo(int32_t web_contents_id,
+                            const std::string& channel,
+                            ConnectToCallback callback) {
+  TRACE_EVENT1("electron", "WebContents::ConnectTo", "channel", channel);
+  auto* web_contents = mate::TrackableObject<WebContents>::FromWeakMapID(
+      isolate(), web_contents_id);
+  content::RenderFrameHost* frame_host =
+      web_contents ? web_contents->web_contents()->GetMainFrame() : nullptr;
+  if (!frame_host || !frame_host->IsRenderFrameLive()) {
+    std::move(callback).Run(mojo::NullRemote(), mojo::NullReceiver());
+    return;
+  }
+
+  // Each direction gets its own pipe. Once both renderers hold their ends,
+  // the messages are routed between them without involving this process.
+  mojo::PendingRemote<mojom::ElectronPeerPort> to_target;
+  auto target_receiver = to_target.InitWithNewPipeAndPassReceiver();
+  mojo::PendingRemote<mojom::ElectronPeerPort> to_sender;
+  auto sender_receiver = to_sender.InitWithNewPipeAndPassReceiver();
+  web_contents->GetElectronRenderer(frame_host)
+      ->ConnectPeer(channel, std::move(to_sender), std::move(target_receiver),
+                    ID());
+  std::move(callback).Run(std::move(to_target), std::move(sender_receiver));
+}
+
 #if BUILDFLAG(ENABLE_REMOTE_MODULE)
 void WebContents::DereferenceRemoteJSObject(const std::string& context_id,
                                             int object_id,
@@ -1184,8 +1412,18 @@ void WebContents::UpdateDraggableRegions(
     observer.OnDraggableRegionsUpdated(regions);
 }
 
+void WebContents::RenderFrameHostChanged(content::RenderFrameHost* old_host,
+                                         content::RenderFrameHost* new_host) {
+  // The swapped out frame no longer receives the messages sent to this
+  // WebContents, even if it has not been deleted yet.
+  if (old_host)
+    ForgetRenderFrame(old_host);
+}
+
 void WebContents::RenderFrameDeleted(
     content::RenderFrameHost* render_frame_host) {
+  ForgetRenderFrame(render_frame_host);
+
   // A RenderFrameHost can be destroyed before the related Mojo binding is
   // closed, which can result in Mojo calls being sent for RenderFrameHosts
   // that no longer exist. To prevent this from happening, when a
@@ -1199,6 +1437,44 @@ void WebContents::RenderFrameDeleted(
   frame_to_bindings_map_.erase(it);
 }
 
+void WebContents::ForgetRenderFrame(
+    content::RenderFrameHost* render_frame_host) {
+  electron_renderers_.erase(render_frame_host);
+  auto it = frames_by_routing_id_.find(render_frame_host->GetRoutingID());
+  if (it != frames_by_routing_id_.end() && it->second == render_frame_host)
+    frames_by_routing_id_.erase(it);
+}
+
+mojom::ElectronRenderer* WebContents::GetElectronRenderer(
+    content::RenderFrameHost* frame_host) {
+  auto& electron_renderer = electron_renderers_[frame_host];
+  // Rebind if the renderer dropped the endpoint, e.g. after a crash.
+  if (!electron_renderer.is_bound() || !electron_renderer.is_connected()) {
+    electron_renderer.reset();
+    frame_host->GetRemoteAssociatedInterfaces()->GetInterface(
+        &electron_renderer);
+  }
+  return electron_renderer.get();
+}
+
+content::RenderFrameHost* WebContents::FindFrameByRoutingID(
+    int32_t routing_id) {
+  auto it = frames_by_routing_id_.find(routing_id);
+  if (it != frames_by_routing_id_.end())
+    return it->second;
+
+  // Frames created before this object started observing the WebContents are
+  // not indexed.
+  auto frames = web_contents()->GetAllFrames();
+  auto iter = std::find_if(frames.begin(), frames.end(), [routing_id](auto* f) {
+    return f->GetRoutingID() == routing_id;
+  });
+  if (iter == frames.end())
+    return nullptr;
+  frames_by_routing_id_[routing_id] = *iter;
+  return *iter;
+}
+
 void WebContents::DidStartNavigation(
     content::NavigationHandle* navigation_handle) {
   EmitNavigationEvent("did-start-navigation", navigation_handle);
@@ -1991,11 +2267,14 @@ std::vector<printing::PrinterBasicInfo> WebContents::GetPrinterList() {
 }
 
 v8::Local<v8::Promise> WebContents::PrintToPDF(
-    const base::DictionaryValue& settings) {
+    const base::DictionaryValue& settings,
+    mate::Arguments* args) {
   util::Promise<v8::Local<v8::Value>> promise(isolate());
   v8::Local<v8::Promise> handle = promise.GetHandle();
+  base::FilePath output_path;
+  args->GetNext(&output_path);
   PrintPreviewMessageHandler::FromWebContents(web_contents())
-      ->PrintToPDF(settings, std::move(promise));
+      ->PrintToPDF(settings, output_path, std::move(promise));
   return handle;
 }
 #endif
@@ -2129,13 +2408,15 @@ bool WebContents::SendIPCMessage(bool internal,
                                  const std::string& channel,
                                  v8::Local<v8::Value> args) {
   blink::CloneableMessage message;
-  if (!mate::ConvertFromV8(isolate(), args, &message)) {
+  if (!mate::ConvertIPCMessageFromV8(isolate(), args, channel, &message)) {
     isolate()->ThrowException(v8::Exception::Error(
         mate::StringToV8(isolate(), "Failed to serialize arguments")));
     return false;
   }
-  return SendIPCMessageWithSender(internal, send_to_all, channel,
-                                  std::move(message));
+  bool sent = SendIPCMessageWithSender(internal, send_to_all, channel,
+                                       message.ShallowClone());
+  mate::ReleaseIPCMessageBuffer(&message);
+  return sent;
 }
 
 bool WebContents::SendIPCMessageWithSender(bool internal,
@@ -2154,39 +2435,95 @@ bool WebContents::SendIPCMessageWithSender(bool internal,
   }
 
   for (auto* frame_host : target_hosts) {
-    mojo::AssociatedRemote<mojom::ElectronRenderer> electron_renderer;
-    frame_host->GetRemoteAssociatedInterfaces()->GetInterface(
-        &electron_renderer);
-    electron_renderer->Message(internal, false, channel, args.ShallowClone(),
-                               sender_id);
+    ipc_stats_.RecordSent(channel, args.encoded_message.size());
+    GetElectronRenderer(frame_host)
+        ->Message(internal, false, channel, args.ShallowClone(), sender_id);
   }
   return true;
 }
 
+// static
+void WebContents::SetRawIPCChannels(const std::vector<std::string>& channels) {
+  GetRawIPCChannels() = std::set<std::string>(channels.begin(), channels.end());
+}
+
+// static
+int WebContents::Broadcast(v8::Isolate* isolate,
+                           bool internal,
+                           const std::vector<WebContents*>& targets,
+                           const std::string& channel,
+                           v8::Local<v8::Value> args) {
+  blink::CloneableMessage message;
+  if (!mate::ConvertIPCMessageFromV8(isolate, args, channel, &message)) {
+    isolate->ThrowException(v8::Exception::Error(
+        mate::StringToV8(isolate, "Failed to serialize arguments")));
+    return 0;
+  }
+
+  size_t size = message.encoded_message.size();
+  base::ReadOnlySharedMemoryRegion region;
+  if (targets.size() > 1 && size >= kMinSharedMemoryBroadcastSize) {
+    base::MappedReadOnlyRegion shared_memory =
+        base::ReadOnlySharedMemoryRegion::Create(size);
+    if (shared_memory.IsValid()) {
+      memcpy(shared_memory.mapping.memory(), message.encoded_message.data(),
+             size);
+      region = std::move(shared_memory.region);
+    }
+  }
+
+  int count = 0;
+  for (auto* target : targets) {
+    auto* frame_host = target->web_contents()->GetMainFrame();
+    if (!frame_host)
+      continue;
+    auto* electron_renderer = target->GetElectronRenderer(frame_host);
+    target->ipc_stats_.RecordSent(channel, size);
+    if (region.IsValid()) {
+      electron_renderer->MessageFromSharedMemory(internal, channel,
+                                                 region.Duplicate(), 0);
+    } else {
+      electron_renderer->Message(internal, false, channel,
+                                 message.ShallowClone(), 0);
+    }
+    count++;
+  }
+  mate::ReleaseIPCMessageBuffer(&message);
+  return count;
+}
+
+bool WebContents::SendRawIPCMessage(v8::Isolate* isolate,
+                                    v8::Local<v8::Value> message) {
+  IPCRawMessage* raw_message = nullptr;
+  if (!gin::ConvertFromV8(isolate, message, &raw_message)) {
+    isolate->ThrowException(v8::Exception::TypeError(
+        mate::StringToV8(isolate, "Expected a message received with onRaw")));
+    return false;
+  }
+  return SendIPCMessageWithSender(false, false, raw_message->channel(),
+                                  raw_message->message().ShallowClone());
+}
+
 bool WebContents::SendIPCMessageToFrame(bool internal,
                                         bool send_to_all,
                                         int32_t frame_id,
                                         const std::string& channel,
                                         v8::Local<v8::Value> args) {
   blink::CloneableMessage message;
-  if (!mate::ConvertFromV8(isolate(), args, &message)) {
+  if (!mate::ConvertIPCMessageFromV8(isolate(), args, channel, &message)) {
     isolate()->ThrowException(v8::Exception::Error(
         mate::StringToV8(isolate(), "Failed to serialize arguments")));
     return false;
   }
-  auto frames = web_contents()->GetAllFrames();
-  auto iter = std::find_if(frames.begin(), frames.end(), [frame_id](auto* f) {
-    return f->GetRoutingID() == frame_id;
-  });
-  if (iter == frames.end())
-    return false;
-  if (!(*iter)->IsRenderFrameLive())
+  auto* frame_host = FindFrameByRoutingID(frame_id);
+  if (!frame_host || !frame_host->IsRenderFrameLive())
     return false;
 
-  mojo::AssociatedRemote<mojom::ElectronRenderer> electron_renderer;
-  (*iter)->GetRemoteAssociatedInterfaces()->GetInterface(&electron_renderer);
-  electron_renderer->Message(internal, send_to_all, channel, std::move(message),
-                             0 /* sender_id */);
+  ipc_stats_.RecordSent(channel, message.encoded_message.size());
+  GetElectronRenderer(frame_host)
+      ->Message(internal, send_to_all, channel, message.ShallowClone(),
+                0 /* sender_id */);
+  mate::ReleaseIPCMessageBuffer(&message);
   return true;
 }
 
@@ -2643,11 +2980,41 @@ void WebContents::GrantOriginAccess(const GURL& url) {
       url::Origin::Create(url));
 }
 
+void WebContents::StartHeapSnapshot(
+    mojo::ScopedDataPipeProducerHandle producer,
+    bool compress,
+    base::TimeDelta stall_timeout,
+    base::OnceCallback<void(bool)> callback) {
+  auto* frame_host = web_contents()->GetMainFrame();
+  if (!frame_host || !producer) {
+    std::move(callback).Run(false);
+    return;
+  }
+
+  mojo::PendingRemote<mojom::HeapSnapshotObserver> observer;
+  mojo::MakeSelfOwnedReceiver(
+      std::make_unique<HeapSnapshotProgressObserver>(GetWeakPtr()),
+      observer.InitWithNewPipeAndPassReceiver());
+
+  // The callback is dropped if the frame goes away before replying.
+  GetElectronRenderer(frame_host)
+      ->TakeHeapSnapshotToDataPipe(
+          std::move(producer), compress, stall_timeout, std::move(observer),
+          mojo::WrapCallbackWithDefaultInvokeIfNotRun(std::move(callback),
+                                                      false));
+}
+
 v8::Local<v8::Promise> WebContents::TakeHeapSnapshot(
-    const base::FilePath& file_path) {
+    const base::FilePath& file_path,
+    mate::Arguments* args) {
   util::Promise<void*> promise(isolate());
   v8::Local<v8::Promise> handle = promise.GetHandle();
 
+  bool compress = false;
+  mate::Dictionary options;
+  if (args->GetNext(&options))
+    options.Get("compress", &compress);
+
   base::ThreadRestrictions::ScopedAllowIO allow_io;
   base::File file(file_path,
                   base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
@@ -2656,32 +3023,76 @@ v8::Local<v8::Promise> WebContents::TakeHeapSnapshot(
     return handle;
   }
 
-  auto* frame_host = web_contents()->GetMainFrame();
-  if (!frame_host) {
+  mojo::ScopedDataPipeProducerHandle producer;
+  mojo::ScopedDataPipeConsumerHandle consumer;
+  if (!CreateHeapSnapshotPipe(&producer, &consumer)) {
     promise.RejectWithErrorMessage("takeHeapSnapshot failed");
     return handle;
   }
 
-  // This dance with `base::Owned` is to ensure that the interface stays alive
-  // until the callback is called. Otherwise it would be closed at the end of
-  // this function.
-  auto electron_renderer =
-      std::make_unique<mojo::AssociatedRemote<mojom::ElectronRenderer>>();
-  frame_host->GetRemoteAssociatedInterfaces()->GetInterface(
-      electron_renderer.get());
-  auto* raw_ptr = electron_renderer.get();
-  (*raw_ptr)->TakeHeapSnapshot(
-      mojo::WrapPlatformFile(file.TakePlatformFile()),
-      base::BindOnce(
-          [](mojo::AssociatedRemote<mojom::ElectronRenderer>* ep,
-             util::Promise<void*> promise, bool success) {
-            if (success) {
-              promise.Resolve();
-            } else {
-              promise.RejectWithErrorMessage("takeHeapSnapshot failed");
-            }
-          },
-          base::Owned(std::move(electron_renderer)), std::move(promise)));
+  // The snapshot is written to disk on a background sequence while the
+  // renderer is still serializing it.
+  auto job = base::MakeRefCounted<HeapSnapshotJob>(std::move(promise));
+  base::PostTaskAndReplyWithResult(
+      FROM_HERE,
+      {base::ThreadPool(), base::MayBlock(), base::WithBaseSyncPrimitives(),
+       base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(&WriteDataPipeToFile, std::move(consumer),
+                     std::move(file)),
+      base::BindOnce(&HeapSnapshotJob::OnWritten, job));
+  StartHeapSnapshot(
+      std::move(producer), compress,
+      base::TimeDelta::FromMilliseconds(kDefaultHeapSnapshotStallTimeoutMs),
+      base::BindOnce(&HeapSnapshotJob::OnSerialized, job));
+  return handle;
+}
+
+v8::Local<v8::Value> WebContents::TakeHeapSnapshotStream(
+    mate::Arguments* args) {
+  bool compress = false;
+  int stall_timeout_ms = kDefaultHeapSnapshotStallTimeoutMs;
+  mate::Dictionary options;
+  if (args->GetNext(&options)) {
+    options.Get("compress", &compress);
+    options.Get("stallTimeout", &stall_timeout_ms);
+  }
+
+  mojo::ScopedDataPipeProducerHandle producer;
+  mojo::ScopedDataPipeConsumerHandle consumer;
+  CreateHeapSnapshotPipe(&producer, &consumer);
+  auto reader = HeapSnapshotReader::Create(isolate(), std::move(consumer));
+  StartHeapSnapshot(
+      std::move(producer), compress,
+      base::TimeDelta::FromMilliseconds(std::max(stall_timeout_ms, 0)),
+      base::BindOnce(&HeapSnapshotReader::OnSerialized, reader->GetWeakPtr()));
+  return reader.ToV8();
+}
+
+v8::Local<v8::Promise> WebContents::GetIPCStats() {
+  util::Promise<base::Value> promise(isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  base::Value stats(base::Value::Type::DICTIONARY);
+  stats.SetKey("browser", ipc_stats_.ToValue());
+
+  auto* frame_host = web_contents()->GetMainFrame();
+  if (!frame_host || !frame_host->IsRenderFrameLive()) {
+    stats.SetKey("renderer", base::Value(base::Value::Type::DICTIONARY));
+    promise.Resolve(stats);
+    return handle;
+  }
+
+  // The renderer stats are left empty if the renderer goes away meanwhile.
+  GetElectronRenderer(frame_host)
+      ->GetIPCStats(mojo::WrapCallbackWithDefaultInvokeIfNotRun(
+          base::BindOnce(
+              [](util::Promise<base::Value> promise, base::Value stats,
+                 base::Value renderer_stats) {
+                stats.SetKey("renderer", std::move(renderer_stats));
+                promise.Resolve(stats);
+              },
+              std::move(promise), std::move(stats)),
+          base::Value(base::Value::Type::DICTIONARY)));
   return handle;
 }
 
@@ -2743,6 +3154,7 @@ void WebContents::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("tabTraverse", &WebContents::TabTraverse)
       .SetMethod("_send", &WebContents::SendIPCMessage)
       .SetMethod("_sendToFrame", &WebContents::SendIPCMessageToFrame)
+      .SetMethod("sendRaw", &WebContents::SendRawIPCMessage)
       .SetMethod("sendInputEvent", &WebContents::SendInputEvent)
       .SetMethod("beginFrameSubscription", &WebContents::BeginFrameSubscription)
       .SetMethod("endFrameSubscription", &WebContents::EndFrameSubscription)
@@ -2797,6 +3209,10 @@ void WebContents::BuildPrototype(v8::Isolate* isolate,
                  &WebContents::GetWebRTCIPHandlingPolicy)
       .SetMethod("_grantOriginAccess", &WebContents::GrantOriginAccess)
       .SetMethod("takeHeapSnapshot", &WebContents::TakeHeapSnapshot)
+      .SetMethod("_takeHeapSnapshotStream",
+                 &WebContents::TakeHeapSnapshotStream)
+      .SetMethod("getIPCStats", &WebContents::GetIPCStats)
+      .SetMethod("_setListenedEvents", &WebContents::SetListenedEvents)
       .SetProperty("id", &WebContents::ID)
       .SetProperty("session", &WebContents::Session)
       .SetProperty("hostWebContents", &WebContents::HostWebContents)
@@ -2866,6 +3282,8 @@ void Initialize(v8::Local<v8::Object> exports,
   dict.SetMethod("create", &WebContents::Create);
   dict.SetMethod("fromId", &WebContents::FromWeakMapID);
   dict.SetMethod("getAllWebContents", &WebContents::GetAll);
+  dict.SetMethod("_broadcast", &WebContents::Broadcast);
+  dict.SetMethod("_setRawIPCChannels", &WebContents::SetRawIPCChannels);
 }
 
 }  // namespace
@@ -21,7 +21,9 @@
 #include "content/public/common/favicon_url.h"
 #include "electron/buildflags/buildflags.h"
 #include "electron/shell/common/api/api.mojom.h"
+#include "mojo/public/cpp/bindings/associated_remote.h"
 #include "mojo/public/cpp/bindings/binding_set.h"
+#include "mojo/public/cpp/system/data_pipe.h"
 #include "native_mate/handle.h"
 #include "printing/buildflags/buildflags.h"
 #include "services/service_manager/public/cpp/binder_registry.h"
@@ -29,6 +31,8 @@
 #include "shell/browser/api/save_page_handler.h"
 #include "shell/browser/api/trackable_object.h"
 #include "shell/browser/common_web_contents_delegate.h"
+#include "shell/browser/native_ipc_handler_registry.h"
+#include "shell/common/ipc_stats.h"
 #include "ui/gfx/image/image.h"
 
 #if BUILDFLAG(ENABLE_PRINTING)
@@ -182,6 +186,18 @@ class WebContents : public mate::TrackableObject<WebContents>,
       v8::Isolate* isolate,
       content::WebContents* web_contents);
 
+  // Sends the same message to the main frame of every one of |targets|,
+  // serializing |args| only once, and returns the number of messages sent.
+  static int Broadcast(v8::Isolate* isolate,
+                       bool internal,
+                       const std::vector<WebContents*>& targets,
+                       const std::string& channel,
+                       v8::Local<v8::Value> args);
+
+  // Sets the channels listened to with ipcMain.onRaw(), whose messages are
+  // emitted without deserializing their arguments.
+  static void SetRawIPCChannels(const std::vector<std::string>& channels);
+
   static void BuildPrototype(v8::Isolate* isolate,
                              v8::Local<v8::FunctionTemplate> prototype);
 
@@ -261,7 +277,8 @@ class WebContents : public mate::TrackableObject<WebContents>,
   void Print(mate::Arguments* args);
   std::vector<printing::PrinterBasicInfo> GetPrinterList();
   // Print current page as PDF.
-  v8::Local<v8::Promise> PrintToPDF(const base::DictionaryValue& settings);
+  v8::Local<v8::Promise> PrintToPDF(const base::DictionaryValue& settings,
+                                    mate::Arguments* args);
 #endif
 
   // DevTools workspace api.
@@ -308,6 +325,9 @@ class WebContents : public mate::TrackableObject<WebContents>,
                              const std::string& channel,
                              v8::Local<v8::Value> args);
 
+  // Sends a message received with ipcMain.onRaw() to the main frame as is.
+  bool SendRawIPCMessage(v8::Isolate* isolate, v8::Local<v8::Value> message);
+
   // Send WebInputEvent to the page.
   void SendInputEvent(v8::Isolate* isolate, v8::Local<v8::Value> input_event);
 
@@ -384,7 +404,13 @@ class WebContents : public mate::TrackableObject<WebContents>,
   // the specified URL.
   void GrantOriginAccess(const GURL& url);
 
-  v8::Local<v8::Promise> TakeHeapSnapshot(const base::FilePath& file_path);
+  v8::Local<v8::Promise> TakeHeapSnapshot(const base::FilePath& file_path,
+                                          mate::Arguments* args);
+  v8::Local<v8::Value> TakeHeapSnapshotStream(mate::Arguments* args);
+
+  // Returns the IPC statistics kept for this WebContents and those of the
+  // renderer process of its main frame.
+  v8::Local<v8::Promise> GetIPCStats();
 
   // Properties.
   int32_t ID() const;
@@ -523,6 +549,8 @@ class WebContents : public mate::TrackableObject<WebContents>,
                          const base::TimeTicks& proceed_time) override;
   void RenderViewCreated(content::RenderViewHost* render_view_host) override;
   void RenderFrameCreated(content::RenderFrameHost* render_frame_host) override;
+  void RenderFrameHostChanged(content::RenderFrameHost* old_host,
+                              content::RenderFrameHost* new_host) override;
   void RenderViewHostChanged(content::RenderViewHost* old_host,
                              content::RenderViewHost* new_host) override;
   void RenderViewDeleted(content::RenderViewHost*) override;
@@ -581,6 +609,25 @@ class WebContents : public mate::TrackableObject<WebContents>,
                            content::RenderFrameHost* render_frame_host);
   void OnElectronBrowserConnectionError();
 
+  // Returns the ElectronRenderer interface of |frame_host|, which is bound the
+  // first time it is used and then reused until the frame goes away.
+  mojom::ElectronRenderer* GetElectronRenderer(
+      content::RenderFrameHost* frame_host);
+
+  // Returns the frame of this WebContents with |routing_id|, or nullptr.
+  content::RenderFrameHost* FindFrameByRoutingID(int32_t routing_id);
+
+  // Drops the cached state of a frame that is deleted or swapped out.
+  void ForgetRenderFrame(content::RenderFrameHost* render_frame_host);
+
+  // Asks the renderer to stream a heap snapshot into |producer|, failing it
+  // if nothing is read for |stall_timeout|. |callback| is run with whether the
+  // snapshot was serialized.
+  void StartHeapSnapshot(mojo::ScopedDataPipeProducerHandle producer,
+                         bool compress,
+                         base::TimeDelta stall_timeout,
+                         base::OnceCallback<void(bool)> callback);
+
   uint32_t GetNextRequestId() { return ++request_id_; }
 
 #if BUILDFLAG(ENABLE_OSR)
@@ -607,6 +654,9 @@ class WebContents : public mate::TrackableObject<WebContents>,
                  blink::CloneableMessage arguments) override;
   void MessageHost(const std::string& channel,
                    blink::CloneableMessage arguments) override;
+  void ConnectTo(int32_t web_contents_id,
+                 const std::string& channel,
+                 ConnectToCallback callback) override;
 #if BUILDFLAG(ENABLE_REMOTE_MODULE)
   void DereferenceRemoteJSObject(const std::string& context_id,
                                  int object_id,
@@ -617,6 +667,36 @@ class WebContents : public mate::TrackableObject<WebContents>,
   void SetTemporaryZoomLevel(double level) override;
   void DoGetZoomLevel(DoGetZoomLevelCallback callback) override;
 
+  // Handle the messages |sender| sent with ipcRenderer, whether they came
+  // through ElectronBrowser or ElectronNativeIpc.
+  void ReceiveMessage(content::RenderFrameHost* sender,
+                      bool internal,
+                      const std::string& channel,
+                      blink::CloneableMessage arguments);
+  void ReceiveInvoke(content::RenderFrameHost* sender,
+                     bool internal,
+                     const std::string& channel,
+                     blink::CloneableMessage arguments,
+                     InvokeCallback callback);
+  void ReceiveMessageSync(content::RenderFrameHost* sender,
+                          bool internal,
+                          const std::string& channel,
+                          blink::CloneableMessage arguments,
+                          MessageSyncCallback callback);
+
+  // Binds the pipe through which the frame sends the messages of channels
+  // handled by native addons, on the IPC handler thread.
+  void BindElectronNativeIpc(mojom::ElectronNativeIpcRequest request,
+                             content::RenderFrameHost* render_frame_host);
+  // Passes a message that arrived on the IPC handler thread after its channel
+  // lost its native handler to ipcMain.
+  void OnNativeIpcFallback(int process_id,
+                           int routing_id,
+                           NativeIpcHandlerRegistry::ReplyType reply_type,
+                           const std::string& channel,
+                           blink::CloneableMessage arguments,
+                           NativeIpcHandlerRegistry::ReplyCallback reply);
+
   // Called when received a synchronous message from renderer to
   // get the zoom level.
   void OnGetZoomLevel(content::RenderFrameHost* frame_host,
@@ -665,6 +745,16 @@ class WebContents : public mate::TrackableObject<WebContents>,
   std::map<content::RenderFrameHost*, std::vector<mojo::BindingId>>
       frame_to_bindings_map_;
 
+  // Remotes of the frames' ElectronRenderer interfaces, so that sending a
+  // message does not set up a new associated endpoint every time.
+  std::map<content::RenderFrameHost*,
+           mojo::AssociatedRemote<mojom::ElectronRenderer>>
+      electron_renderers_;
+  std::map<int32_t, content::RenderFrameHost*> frames_by_routing_id_;
+
+  // Messages exchanged with the renderers and time spent replying to them.
+  IpcStats ipc_stats_;
+
   base::WeakPtrFactory<WebContents> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(WebContents);
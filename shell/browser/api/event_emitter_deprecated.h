@@ -5,6 +5,7 @@
 #ifndef SHELL_BROWSER_API_EVENT_EMITTER_DEPRECATED_H_
 #define SHELL_BROWSER_API_EVENT_EMITTER_DEPRECATED_H_
 
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -13,6 +14,7 @@
 #include "electron/shell/common/api/api.mojom.h"
 #include "native_mate/wrappable.h"
 #include "shell/common/api/event_emitter_caller_deprecated.h"
+#include "shell/common/gin_helper/event_listener_cache.h"
 
 namespace content {
 class RenderFrameHost;
@@ -52,11 +54,19 @@ class EventEmitter : public Wrappable<T> {
     return Wrappable<T>::GetWrapper(isolate);
   }
 
+  // Sets the names of the events that have JS listeners, see
+  // gin_helper::EventListenerCache.
+  void SetListenedEvents(const std::vector<std::string>& names) {
+    listener_cache_.SetListenedEvents(names);
+  }
+
   // this.emit(name, event, args...);
   template <typename... Args>
   bool EmitCustomEvent(base::StringPiece name,
                        v8::Local<v8::Object> event,
                        Args&&... args) {
+    if (!listener_cache_.ShouldEmit(name))
+      return false;
     return EmitWithEvent(
         name, internal::CreateCustomEvent(isolate(), GetWrapper(), event),
         std::forward<Args>(args)...);
@@ -65,9 +75,14 @@ class EventEmitter : public Wrappable<T> {
   // this.emit(name, new Event(flags), args...);
   template <typename... Args>
   bool EmitWithFlags(base::StringPiece name, int flags, Args&&... args) {
-    return EmitCustomEvent(name,
-                           internal::CreateEventFromFlags(isolate(), flags),
-                           std::forward<Args>(args)...);
+    if (!listener_cache_.ShouldEmit(name))
+      return false;
+    return EmitWithEvent(
+        name,
+        internal::CreateCustomEvent(
+            isolate(), GetWrapper(),
+            internal::CreateEventFromFlags(isolate(), flags)),
+        std::forward<Args>(args)...);
   }
 
   // this.emit(name, new Event(), args...);
@@ -85,6 +100,10 @@ class EventEmitter : public Wrappable<T> {
       base::Optional<electron::mojom::ElectronBrowser::InvokeCallback> callback,
       Args&&... args) {
     DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+    // Events with a callback are always emitted, so that the callback still
+    // gets run when nobody listens.
+    if (!callback && !listener_cache_.ShouldEmit(name))
+      return false;
     v8::Locker locker(isolate());
     v8::HandleScope handle_scope(isolate());
     v8::Local<v8::Object> wrapper = GetWrapper();
@@ -121,6 +140,8 @@ class EventEmitter : public Wrappable<T> {
     return false;
   }
 
+  gin_helper::EventListenerCache listener_cache_;
+
   DISALLOW_COPY_AND_ASSIGN(EventEmitter);
 };
 
@@ -5,10 +5,22 @@
 #include "shell/browser/api/process_metric.h"
 
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "base/optional.h"
 
+#if defined(OS_LINUX)
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/threading/scoped_blocking_call.h"
+#endif
+
 #if defined(OS_WIN)
 #include <windows.h>
 
@@ -48,6 +60,45 @@ base::Optional<mach_task_basic_info_data_t> GetTaskInfo(mach_port_t task) {
 
 #endif  // defined(OS_MACOSX)
 
+#if defined(OS_LINUX)
+
+namespace {
+
+// Reads the "<key>: <value> kB" fields of a /proc file, returning the values
+// of |keys| in bytes, or 0 for the ones that are missing.
+std::vector<size_t> ReadProcKilobyteFields(
+    const base::FilePath& path,
+    const std::vector<base::StringPiece>& keys) {
+  std::vector<size_t> result(keys.size(), 0);
+  std::string contents;
+  if (!base::ReadFileToString(path, &contents))
+    return result;
+
+  for (const auto& line : base::SplitStringPiece(
+           contents, "\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    auto separator = line.find(':');
+    if (separator == base::StringPiece::npos)
+      continue;
+    auto key = line.substr(0, separator);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      if (key != keys[i])
+        continue;
+      auto value = base::TrimWhitespaceASCII(line.substr(separator + 1),
+                                             base::TRIM_ALL);
+      if (base::EndsWith(value, " kB", base::CompareCase::SENSITIVE))
+        value.remove_suffix(3);
+      size_t kilobytes = 0;
+      if (base::StringToSizeT(value, &kilobytes))
+        result[i] = kilobytes << 10;
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+#endif  // defined(OS_LINUX)
+
 namespace electron {
 
 ProcessMetric::ProcessMetric(int type,
@@ -163,6 +214,29 @@ bool ProcessMetric::IsSandboxed() const {
 #endif
 }
 
-#endif  // defined(OS_MACOSX)
+#elif defined(OS_LINUX)
+
+ProcessMemoryInfo ProcessMetric::GetMemoryInfo() const {
+  ProcessMemoryInfo result;
+  // Reading smaps_rollup walks the whole address space of the process under
+  // its mmap lock, which can take a while for large or busy processes.
+  base::ScopedBlockingCall scoped_blocking_call(FROM_HERE,
+                                                base::BlockingType::MAY_BLOCK);
+
+  auto proc_dir = base::FilePath("/proc").Append(
+      base::NumberToString(process.Pid()));
+  // smaps_rollup (Linux 4.14+) has the PSS without walking every mapping.
+  auto rollup =
+      ReadProcKilobyteFields(proc_dir.Append("smaps_rollup"), {"Rss", "Pss"});
+  auto status = ReadProcKilobyteFields(proc_dir.Append("status"),
+                                       {"VmRSS", "VmHWM"});
+  result.working_set_size = rollup[0] ? rollup[0] : status[0];
+  result.proportional_set_size = rollup[1];
+  result.peak_working_set_size = status[1];
+
+  return result;
+}
+
+#endif  // defined(OS_LINUX)
 
 }  // namespace electron
@@ -13,15 +13,15 @@
 
 namespace electron {
 
-#if !defined(OS_LINUX)
 struct ProcessMemoryInfo {
   size_t working_set_size = 0;
   size_t peak_working_set_size = 0;
 #if defined(OS_WIN)
   size_t private_bytes = 0;
+#elif defined(OS_LINUX)
+  size_t proportional_set_size = 0;
 #endif
 };
-#endif
 
 #if defined(OS_WIN)
 enum class ProcessIntegrityLevel {
@@ -43,9 +43,9 @@ struct ProcessMetric {
                 std::unique_ptr<base::ProcessMetrics> metrics);
   ~ProcessMetric();
 
-#if !defined(OS_LINUX)
+  // On Linux this reads from /proc and blocks, so it has to run on a sequence
+  // that allows blocking, see ProcessMetricsSampler.
   ProcessMemoryInfo GetMemoryInfo() const;
-#endif
 
 #if defined(OS_WIN)
   ProcessIntegrityLevel GetIntegrityLevel() const;
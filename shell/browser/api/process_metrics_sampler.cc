@@ -0,0 +1,225 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/api/process_metrics_sampler.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/synchronization/lock.h"
+#include "base/system/sys_info.h"
+#include "base/task/post_task.h"
+#include "base/timer/timer.h"
+#include "content/public/browser/browser_child_process_host.h"
+#include "shell/browser/api/process_metric.h"
+
+namespace electron {
+
+// static
+const char* const ProcessMetricsSampler::kFieldNames[kFieldCount] = {
+    "timestamp",       "pid",
+    "percentCPUUsage", "idleWakeupsPerSecond",
+    "workingSetSize",  "proportionalSetSize",
+    "readBytes",       "writeBytes",
+};
+
+// static
+// 100000 samples take a bit more than 6 MB.
+const size_t ProcessMetricsSampler::kMaxCapacity = 100000;
+
+class ProcessMetricsSampler::Core {
+ public:
+  Core() = default;
+
+  void Start(base::TimeDelta interval, size_t capacity) {
+    DCHECK_LE(capacity, kMaxCapacity);
+    {
+      base::AutoLock auto_lock(lock_);
+      samples_.assign(capacity * kFieldCount, 0);
+      capacity_ = capacity;
+      next_ = 0;
+      count_ = 0;
+    }
+    timer_.Start(FROM_HERE, interval,
+                 base::BindRepeating(&Core::Sample, base::Unretained(this)));
+  }
+
+  void Stop() { timer_.Stop(); }
+
+  void AddProcess(base::ProcessId pid, std::unique_ptr<ProcessMetric> metric) {
+    ProcessMemoryInfo memory_info = metric->GetMemoryInfo();
+    processes_[pid] = std::move(metric);
+    base::AutoLock auto_lock(lock_);
+    memory_info_[pid] = memory_info;
+  }
+
+  void RemoveProcess(base::ProcessId pid) {
+    processes_.erase(pid);
+    base::AutoLock auto_lock(lock_);
+    memory_info_.erase(pid);
+  }
+
+  void RefreshMemoryInfo() {
+    std::unordered_map<base::ProcessId, ProcessMemoryInfo> memory_info;
+    for (const auto& it : processes_)
+      memory_info[it.first] = it.second->GetMemoryInfo();
+    base::AutoLock auto_lock(lock_);
+    memory_info_ = std::move(memory_info);
+  }
+
+  // Called from the UI thread.
+  bool GetMemoryInfo(base::ProcessId pid, ProcessMemoryInfo* info) const {
+    base::AutoLock auto_lock(lock_);
+    auto it = memory_info_.find(pid);
+    if (it == memory_info_.end())
+      return false;
+    *info = it->second;
+    return true;
+  }
+
+  // Called from the UI thread.
+  std::vector<double> GetSamples() const {
+    base::AutoLock auto_lock(lock_);
+    std::vector<double> result;
+    if (count_ == 0)
+      return result;
+    result.reserve(count_ * kFieldCount);
+    size_t first = (next_ + capacity_ - count_) % capacity_;
+    for (size_t i = 0; i < count_; ++i) {
+      auto row = samples_.begin() + ((first + i) % capacity_) * kFieldCount;
+      result.insert(result.end(), row, row + kFieldCount);
+    }
+    return result;
+  }
+
+ private:
+  void Sample() {
+    double now = base::Time::Now().ToJsTime();
+    int processor_count = base::SysInfo::NumberOfProcessors();
+
+    std::vector<double> rows;
+    rows.reserve(processes_.size() * kFieldCount);
+    std::unordered_map<base::ProcessId, ProcessMemoryInfo> memory_info;
+    for (const auto& it : processes_) {
+      ProcessMetric* metric = it.second.get();
+      double row[kFieldCount] = {};
+      row[kTimestamp] = now;
+      row[kPid] = it.first;
+      row[kPercentCPUUsage] =
+          metric->metrics->GetPlatformIndependentCPUUsage() / processor_count;
+#if !defined(OS_WIN)
+      // Not implemented on Windows, see App::GetAppMetrics.
+      row[kIdleWakeupsPerSecond] = metric->metrics->GetIdleWakeupsPerSecond();
+#endif
+      ProcessMemoryInfo info = metric->GetMemoryInfo();
+      memory_info[it.first] = info;
+      row[kWorkingSetSize] = info.working_set_size >> 10;
+#if defined(OS_LINUX)
+      row[kProportionalSetSize] = info.proportional_set_size >> 10;
+#endif
+      base::IoCounters io_counters;
+      if (metric->metrics->GetIOCounters(&io_counters)) {
+        row[kReadBytes] = io_counters.ReadTransferCount;
+        row[kWriteBytes] = io_counters.WriteTransferCount;
+      }
+      rows.insert(rows.end(), row, row + kFieldCount);
+    }
+
+    base::AutoLock auto_lock(lock_);
+    memory_info_ = std::move(memory_info);
+    if (capacity_ == 0)
+      return;
+    for (size_t offset = 0; offset < rows.size(); offset += kFieldCount) {
+      std::copy(rows.begin() + offset, rows.begin() + offset + kFieldCount,
+                samples_.begin() + next_ * kFieldCount);
+      next_ = (next_ + 1) % capacity_;
+      count_ = std::min(count_ + 1, capacity_);
+    }
+  }
+
+  std::unordered_map<base::ProcessId, std::unique_ptr<ProcessMetric>>
+      processes_;
+  base::RepeatingTimer timer_;
+
+  mutable base::Lock lock_;
+  std::unordered_map<base::ProcessId, ProcessMemoryInfo> memory_info_;
+  // Ring buffer of |capacity_| rows, |next_| is the row written next.
+  std::vector<double> samples_;
+  size_t capacity_ = 0;
+  size_t next_ = 0;
+  size_t count_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(Core);
+};
+
+ProcessMetricsSampler::ProcessMetricsSampler()
+    : task_runner_(base::CreateSequencedTaskRunner(
+          {base::ThreadPool(), base::MayBlock(),
+           base::TaskPriority::USER_VISIBLE,
+           base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})),
+      core_(std::make_unique<Core>()) {}
+
+ProcessMetricsSampler::~ProcessMetricsSampler() {
+  task_runner_->DeleteSoon(FROM_HERE, std::move(core_));
+}
+
+void ProcessMetricsSampler::Start(base::TimeDelta interval, size_t capacity) {
+  task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(&Core::Start, base::Unretained(core_.get()),
+                                interval, capacity));
+}
+
+void ProcessMetricsSampler::Stop() {
+  task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(&Core::Stop, base::Unretained(core_.get())));
+}
+
+void ProcessMetricsSampler::AddProcess(int process_type,
+                                       base::ProcessHandle handle) {
+  // The sampler keeps its own ProcessMetrics, since their CPU usage is
+  // relative to the previous call on the same instance.
+  std::unique_ptr<base::ProcessMetrics> metrics;
+  if (handle == base::GetCurrentProcessHandle()) {
+    metrics = base::ProcessMetrics::CreateCurrentProcessMetrics();
+  } else {
+#if defined(OS_MACOSX)
+    metrics = base::ProcessMetrics::CreateProcessMetrics(
+        handle, content::BrowserChildProcessHost::GetPortProvider());
+#else
+    metrics = base::ProcessMetrics::CreateProcessMetrics(handle);
+#endif
+  }
+  auto metric = std::make_unique<ProcessMetric>(process_type, handle,
+                                                std::move(metrics));
+  task_runner_->PostTask(
+      FROM_HERE,
+      base::BindOnce(&Core::AddProcess, base::Unretained(core_.get()),
+                     base::GetProcId(handle), std::move(metric)));
+}
+
+void ProcessMetricsSampler::RemoveProcess(base::ProcessId pid) {
+  task_runner_->PostTask(FROM_HERE,
+                         base::BindOnce(&Core::RemoveProcess,
+                                        base::Unretained(core_.get()), pid));
+}
+
+std::vector<double> ProcessMetricsSampler::GetSamples() const {
+  return core_->GetSamples();
+}
+
+bool ProcessMetricsSampler::GetMemoryInfo(base::ProcessId pid,
+                                          ProcessMemoryInfo* info) const {
+  return core_->GetMemoryInfo(pid, info);
+}
+
+void ProcessMetricsSampler::RefreshMemoryInfo() {
+  task_runner_->PostTask(FROM_HERE,
+                         base::BindOnce(&Core::RefreshMemoryInfo,
+                                        base::Unretained(core_.get())));
+}
+
+}  // namespace electron
@@ -0,0 +1,80 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_API_PROCESS_METRICS_SAMPLER_H_
+#define SHELL_BROWSER_API_PROCESS_METRICS_SAMPLER_H_
+
+#include <memory>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/process/process_handle.h"
+#include "base/sequenced_task_runner.h"
+#include "base/time/time.h"
+#include "shell/browser/api/process_metric.h"
+
+namespace electron {
+
+// Samples the CPU usage, memory, idle wakeups and IO counters of the app's
+// processes on a background sequence, keeping the most recent samples in a
+// fixed-size ring buffer that can be read in bulk from the UI thread. It also
+// caches the latest memory info of each process, which is read from /proc on
+// Linux and can't be read on the UI thread.
+class ProcessMetricsSampler {
+ public:
+  // Columns of a sample. Memory is in kilobytes like in getAppMetrics(), IO
+  // counters are cumulative bytes. Fields a platform doesn't provide are 0.
+  enum Field {
+    kTimestamp = 0,
+    kPid,
+    kPercentCPUUsage,
+    kIdleWakeupsPerSecond,
+    kWorkingSetSize,
+    kProportionalSetSize,
+    kReadBytes,
+    kWriteBytes,
+    kFieldCount,
+  };
+  static const char* const kFieldNames[kFieldCount];
+
+  // Largest number of samples Start() accepts.
+  static const size_t kMaxCapacity;
+
+  ProcessMetricsSampler();
+  ~ProcessMetricsSampler();
+
+  // Starts sampling every |interval| into a buffer holding |capacity|
+  // samples, which must not exceed |kMaxCapacity|. Restarting discards the
+  // samples recorded so far.
+  void Start(base::TimeDelta interval, size_t capacity);
+  void Stop();
+
+  // Adding a process also reads its memory info in the background.
+  void AddProcess(int process_type, base::ProcessHandle handle);
+  void RemoveProcess(base::ProcessId pid);
+
+  // Returns the recorded samples oldest first, |kFieldCount| values each.
+  std::vector<double> GetSamples() const;
+
+  // Returns the memory info of |pid| as of the last sample or refresh, or
+  // false if it hasn't been read yet.
+  bool GetMemoryInfo(base::ProcessId pid, ProcessMemoryInfo* info) const;
+  // Reads the memory info of all processes again in the background.
+  void RefreshMemoryInfo();
+
+ private:
+  class Core;
+
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  // Lives on |task_runner_|, except for its ring buffer and memory info
+  // cache which are shared.
+  std::unique_ptr<Core> core_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProcessMetricsSampler);
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_API_PROCESS_METRICS_SAMPLER_H_
@@ -8,6 +8,7 @@
 #include <shlobj.h>
 #endif
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -673,7 +674,20 @@ ElectronBrowserClient::GetGeneratedCodeCacheSettings(
   // If we pass 0 for size, disk_cache will pick a default size using the
   // heuristics based on available disk size. These are implemented in
   // disk_cache::PreferredCacheSize in net/disk_cache/cache_util.cc.
-  return content::GeneratedCodeCacheSettings(true, 0, cache_path);
+  // The size applies to the JavaScript and WebAssembly caches separately,
+  // halve it so that the whole code cache stays within the limit, without
+  // rounding a small size down to 0.
+  int max_size =
+      static_cast<ElectronBrowserContext*>(context)->GetMaxCodeCacheSize();
+  if (max_size > 0)
+    max_size = std::max(max_size / 2, 1);
+  // Every session is a browser context of its own, whose only storage
+  // partition owns a code cache backend, the default session included.
+  // Returning one directory for all of them would not share the cache:
+  // disk_cache doesn't open a directory while another backend uses it, so
+  // only the first session would get a code cache. Sharing would take a
+  // single GeneratedCodeCacheContext across storage partitions in content.
+  return content::GeneratedCodeCacheSettings(true, max_size, cache_path);
 }
 
 void ElectronBrowserClient::AllowCertificateError(
@@ -847,7 +861,7 @@ void ElectronBrowserClient::WebNotificationAllowed(
     int render_process_id,
     base::OnceCallback<void(bool, bool)> callback) {
   content::WebContents* web_contents =
-      WebContentsPreferences::GetWebContentsFromProcessID(render_process_id);
+      GetWebContentsFromProcessID(render_process_id);
   if (!web_contents) {
     std::move(callback).Run(false, false);
     return;
@@ -4,17 +4,22 @@
 
 #include "shell/browser/electron_browser_context.h"
 
+#include <algorithm>
 #include <memory>
 
 #include <utility>
+#include <vector>
 
+#include "base/bind.h"
 #include "base/command_line.h"
 #include "base/files/file_path.h"
+#include "base/json/json_file_value_serializer.h"
 #include "base/path_service.h"
 #include "base/strings/string_util.h"
 #include "base/task/post_task.h"
 #include "base/threading/sequenced_task_runner_handle.h"
 #include "base/threading/thread_restrictions.h"
+#include "base/values.h"
 #include "chrome/common/chrome_paths.h"
 #include "chrome/common/pref_names.h"
 #include "components/keyed_service/content/browser_context_dependency_manager.h"
@@ -109,9 +114,16 @@ ElectronBrowserContext::ElectronBrowserContext(
   base::CommandLine* command_line = base::CommandLine::ForCurrentProcess();
   use_cache_ = !command_line->HasSwitch(switches::kDisableHttpCache);
   options.GetBoolean("cache", &use_cache_);
+  // In-memory partitions have nothing to read, so don't bother.
+  if (!in_memory)
+    options.GetBoolean("asyncPrefs", &async_prefs_);
 
   base::StringToInt(command_line->GetSwitchValueASCII(switches::kDiskCacheSize),
                     &max_cache_size_);
+  base::StringToInt(command_line->GetSwitchValueASCII(switches::kCodeCacheSize),
+                    &max_code_cache_size_);
+  options.GetInteger("codeCacheSize", &max_code_cache_size_);
+  max_code_cache_size_ = std::max(max_code_cache_size_, 0);
 
   if (!base::PathService::Get(DIR_USER_DATA, &path_)) {
     base::PathService::Get(DIR_APP_DATA, &path_);
@@ -143,8 +155,8 @@ ElectronBrowserContext::ElectronBrowserContext(
 
   extension_system_ = static_cast<extensions::ElectronExtensionSystem*>(
       extensions::ExtensionSystem::Get(this));
-  extension_system_->InitForRegularProfile(true /* extensions_enabled */);
-  extension_system_->FinishInitialization();
+  RunWhenPrefsLoaded(base::BindOnce(
+      &ElectronBrowserContext::InitExtensionSystem, GetWeakPtr()));
 #endif
 }
 
@@ -167,7 +179,12 @@ void ElectronBrowserContext::InitPrefs() {
   PrefServiceFactory prefs_factory;
   scoped_refptr<JsonPrefStore> pref_store =
       base::MakeRefCounted<JsonPrefStore>(prefs_path);
-  pref_store->ReadPrefs();  // Synchronous.
+  if (async_prefs_) {
+    // PrefService kicks off the read on the store's file task runner.
+    prefs_factory.set_async(true);
+  } else {
+    pref_store->ReadPrefs();  // Synchronous.
+  }
   prefs_factory.set_user_prefs(pref_store);
 
 #if BUILDFLAG(ENABLE_ELECTRON_EXTENSIONS)
@@ -215,6 +232,56 @@ void ElectronBrowserContext::InitPrefs() {
   user_prefs::UserPrefs::Set(this, prefs_.get());
 #endif
 
+  if (prefs_->GetInitializationStatus() ==
+      PrefService::INITIALIZATION_STATUS_WAITING) {
+    prefs_->AddPrefInitObserver(base::BindOnce(
+        &ElectronBrowserContext::OnPrefsLoaded, GetWeakPtr()));
+  } else {
+    prefs_loaded_ = true;
+  }
+
+  RunWhenPrefsLoaded(base::BindOnce(
+      &ElectronBrowserContext::InitSpellcheckDictionaries, GetWeakPtr()));
+}
+
+void ElectronBrowserContext::RunWhenPrefsLoaded(base::OnceClosure callback) {
+  if (prefs_loaded_)
+    std::move(callback).Run();
+  else
+    prefs_loaded_callbacks_.push_back(std::move(callback));
+}
+
+void ElectronBrowserContext::OnPrefsLoaded(bool success) {
+  if (!success)
+    LOG(ERROR) << "Failed to read preferences of " << GetPath().value();
+
+  prefs_loaded_ = true;
+  early_prefs_.reset();
+  std::vector<base::OnceClosure> callbacks;
+  callbacks.swap(prefs_loaded_callbacks_);
+  for (auto& callback : callbacks)
+    std::move(callback).Run();
+}
+
+const base::Value* ElectronBrowserContext::GetPref(const std::string& path) {
+  if (!prefs_loaded_) {
+    if (!early_prefs_) {
+      base::ThreadRestrictions::ScopedAllowIO allow_io;
+      JSONFileValueDeserializer deserializer(
+          GetPath().Append(FILE_PATH_LITERAL("Preferences")));
+      early_prefs_ = base::DictionaryValue::From(
+          deserializer.Deserialize(nullptr, nullptr));
+      if (!early_prefs_)
+        early_prefs_ = std::make_unique<base::DictionaryValue>();
+    }
+    const base::Value* value = nullptr;
+    if (early_prefs_->Get(path, &value))
+      return value;
+  }
+  return prefs_->Get(path);
+}
+
+void ElectronBrowserContext::InitSpellcheckDictionaries() {
 #if BUILDFLAG(ENABLE_BUILTIN_SPELLCHECKER)
   auto* current_dictionaries =
       prefs()->Get(spellcheck::prefs::kSpellCheckDictionaries);
@@ -231,6 +298,13 @@ void ElectronBrowserContext::InitPrefs() {
 #endif
 }
 
+#if BUILDFLAG(ENABLE_ELECTRON_EXTENSIONS)
+void ElectronBrowserContext::InitExtensionSystem() {
+  extension_system_->InitForRegularProfile(true /* extensions_enabled */);
+  extension_system_->FinishInitialization();
+}
+#endif
+
 void ElectronBrowserContext::SetUserAgent(const std::string& user_agent) {
   user_agent_ = user_agent;
 }
@@ -251,6 +325,10 @@ int ElectronBrowserContext::GetMaxCacheSize() const {
   return max_cache_size_;
 }
 
+int ElectronBrowserContext::GetMaxCodeCacheSize() const {
+  return max_code_cache_size_;
+}
+
 content::ResourceContext* ElectronBrowserContext::GetResourceContext() {
   if (!resource_context_)
     resource_context_ = std::make_unique<content::ResourceContext>();
@@ -258,6 +336,14 @@ content::ResourceContext* ElectronBrowserContext::GetResourceContext() {
 }
 
 std::string ElectronBrowserContext::GetMediaDeviceIDSalt() {
+  if (!prefs_loaded_) {
+    // Creating MediaDeviceIDSalt now would persist a salt that the pending
+    // read is about to overwrite, so use a temporary one until then.
+    if (pending_media_device_id_salt_.empty())
+      pending_media_device_id_salt_ =
+          content::BrowserContext::CreateRandomMediaDeviceIDSalt();
+    return pending_media_device_id_salt_;
+  }
   if (!media_device_id_salt_.get())
     media_device_id_salt_ = std::make_unique<MediaDeviceIDSalt>(prefs_.get());
   return media_device_id_salt_->GetSalt();
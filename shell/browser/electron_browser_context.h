@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 
+#include "base/callback_forward.h"
 #include "base/memory/ref_counted_delete_on_sequence.h"
 #include "base/memory/weak_ptr.h"
 #include "chrome/browser/net/proxy_config_monitor.h"
@@ -21,6 +22,11 @@
 #include "services/network/public/mojom/url_loader_factory.mojom.h"
 #include "shell/browser/media/media_device_id_salt.h"
 
+namespace base {
+class DictionaryValue;
+class Value;
+}  // namespace base
+
 class PrefRegistrySimple;
 class PrefService;
 class ValueMapPrefStore;
@@ -91,6 +97,7 @@ class ElectronBrowserContext
   std::string GetUserAgent() const;
   bool CanUseHttpCache() const;
   int GetMaxCacheSize() const;
+  int GetMaxCodeCacheSize() const;
   ResolveProxyHelper* GetResolveProxyHelper();
   predictors::PreconnectManager* GetPreconnectManager();
   scoped_refptr<network::SharedURLLoaderFactory> GetURLLoaderFactory();
@@ -131,6 +138,16 @@ class ElectronBrowserContext
     return proxy_config_monitor_.get();
   }
   PrefService* prefs() const { return prefs_.get(); }
+  // Whether the user prefs have been read from disk. Always true unless the
+  // context was created with the |asyncPrefs| option.
+  bool prefs_loaded() const { return prefs_loaded_; }
+  // Runs |callback| once the user prefs have been read, or immediately when
+  // they already are.
+  void RunWhenPrefsLoaded(base::OnceClosure callback);
+  // Returns the value of the pref at |path|. Until the user prefs have been
+  // read, the persisted value is read from the file on the calling thread so
+  // that early reads don't see the default value.
+  const base::Value* GetPref(const std::string& path);
   void set_in_memory_pref_store(ValueMapPrefStore* pref_store) {
     in_memory_pref_store_ = pref_store;
   }
@@ -158,6 +175,16 @@ class ElectronBrowserContext
   // Initialize pref registry.
   void InitPrefs();
 
+  // Called by PrefService when the asynchronous read of the user prefs
+  // finishes.
+  void OnPrefsLoaded(bool success);
+
+  // Parts of the initialization that read or write prefs.
+  void InitSpellcheckDictionaries();
+#if BUILDFLAG(ENABLE_ELECTRON_EXTENSIONS)
+  void InitExtensionSystem();
+#endif
+
   static BrowserContextMap browser_context_map_;
 
   ValueMapPrefStore* in_memory_pref_store_;
@@ -169,6 +196,8 @@ class ElectronBrowserContext
   std::unique_ptr<WebViewManager> guest_manager_;
   std::unique_ptr<ElectronPermissionManager> permission_manager_;
   std::unique_ptr<MediaDeviceIDSalt> media_device_id_salt_;
+  // Salt handed out while the prefs are still loading.
+  std::string pending_media_device_id_salt_;
   scoped_refptr<ResolveProxyHelper> resolve_proxy_helper_;
   scoped_refptr<storage::SpecialStoragePolicy> storage_policy_;
 
@@ -183,6 +212,14 @@ class ElectronBrowserContext
   bool in_memory_ = false;
   bool use_cache_ = true;
   int max_cache_size_ = 0;
+  // 0 lets disk_cache pick a size from the available disk space.
+  int max_code_cache_size_ = 0;
+  bool async_prefs_ = false;
+  bool prefs_loaded_ = false;
+  std::vector<base::OnceClosure> prefs_loaded_callbacks_;
+  // Contents of the user prefs file read by GetPref() before the prefs are
+  // loaded.
+  std::unique_ptr<base::DictionaryValue> early_prefs_;
 
 #if BUILDFLAG(ENABLE_ELECTRON_EXTENSIONS)
   // Owned by the KeyedService system.
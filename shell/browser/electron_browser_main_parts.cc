@@ -43,8 +43,10 @@
 #include "shell/browser/electron_paths.h"
 #include "shell/browser/electron_web_ui_controller_factory.h"
 #include "shell/browser/feature_list.h"
+#include "shell/browser/gc_scheduler.h"
 #include "shell/browser/javascript_environment.h"
 #include "shell/browser/media/media_capture_devices_dispatcher.h"
+#include "shell/browser/native_ipc_handler_registry.h"
 #include "shell/browser/node_debugger.h"
 #include "shell/browser/ui/devtools_manager_delegate.h"
 #include "shell/common/api/electron_bindings.h"
@@ -476,10 +478,9 @@ void ElectronBrowserMainParts::PreMainMessageLoopRun() {
   ui::TouchFactory::SetTouchDeviceListFromCommandLine();
 #endif
 
-  // Start idle gc.
-  gc_timer_.Start(FROM_HERE, base::TimeDelta::FromMinutes(1),
-                  base::BindRepeating(&v8::Isolate::LowMemoryNotification,
-                                      base::Unretained(js_env_->isolate())));
+  // Let V8 collect garbage while the main thread is idle.
+  gc_scheduler_ =
+      std::make_unique<GcScheduler>(js_env_->isolate(), js_env_->platform());
 
   content::WebUIControllerFactory::RegisterFactory(
       ElectronWebUIControllerFactory::GetInstance());
@@ -549,6 +550,12 @@ void ElectronBrowserMainParts::PostMainMessageLoopRun() {
     ++iter;
   }
 
+  gc_scheduler_.reset();
+
+  // Native IPC handlers belong to addons loaded in Node, stop calling them
+  // before it goes away.
+  NativeIpcHandlerRegistry::GetInstance()->Shutdown();
+
   // Destroy node platform after all destructors_ are executed, as they may
   // invoke Node/V8 APIs inside them.
   node_debugger_->Stop();
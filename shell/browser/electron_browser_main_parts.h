@@ -11,7 +11,6 @@
 
 #include "base/callback.h"
 #include "base/metrics/field_trial.h"
-#include "base/timer/timer.h"
 #include "content/public/browser/browser_context.h"
 #include "content/public/browser/browser_main_parts.h"
 #include "content/public/common/main_function_params.h"
@@ -34,6 +33,7 @@ namespace electron {
 class ElectronBrowserContext;
 class Browser;
 class ElectronBindings;
+class GcScheduler;
 class JavascriptEnvironment;
 class NodeBindings;
 class NodeDebugger;
@@ -85,6 +85,7 @@ class ElectronBrowserMainParts : public content::BrowserMainParts {
   Browser* browser() { return browser_.get(); }
   BrowserProcessImpl* browser_process() { return fake_browser_process_.get(); }
   NodeEnvironment* node_env() { return node_env_.get(); }
+  GcScheduler* gc_scheduler() { return gc_scheduler_.get(); }
 
  protected:
   // content::BrowserMainParts:
@@ -152,7 +153,7 @@ class ElectronBrowserMainParts : public content::BrowserMainParts {
   std::unique_ptr<ElectronExtensionsBrowserClient> extensions_browser_client_;
 #endif
 
-  base::RepeatingTimer gc_timer_;
+  std::unique_ptr<GcScheduler> gc_scheduler_;
 
   // List of callbacks should be executed before destroying JS env.
   std::list<base::OnceClosure> destructors_;
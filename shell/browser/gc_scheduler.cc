@@ -0,0 +1,160 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/gc_scheduler.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/message_loop/message_loop_current.h"
+
+namespace electron {
+
+namespace {
+
+// How often the main thread is checked for idleness.
+constexpr base::TimeDelta kIdleCheckInterval =
+    base::TimeDelta::FromMilliseconds(500);
+
+// How long no task must have run before the main thread is considered idle.
+constexpr base::TimeDelta kMinIdleTime =
+    base::TimeDelta::FromMilliseconds(250);
+
+// Idle time given to V8 on every check, short enough not to be noticed if a
+// user event arrives meanwhile.
+constexpr base::TimeDelta kIdleTimeBudget =
+    base::TimeDelta::FromMilliseconds(16);
+
+}  // namespace
+
+GcScheduler::GcScheduler(v8::Isolate* isolate, v8::Platform* platform)
+    : isolate_(isolate), platform_(platform) {
+  isolate_->AddGCPrologueCallback(&GcScheduler::OnGCPrologue, this);
+  isolate_->AddGCEpilogueCallback(&GcScheduler::OnGCEpilogue, this);
+  memory_pressure_listener_ = std::make_unique<base::MemoryPressureListener>(
+      base::BindRepeating(&GcScheduler::OnMemoryPressure,
+                          base::Unretained(this)));
+  base::MessageLoopCurrent::Get()->AddTaskObserver(this);
+  SetOptions(Options());
+}
+
+GcScheduler::~GcScheduler() {
+  base::MessageLoopCurrent::Get()->RemoveTaskObserver(this);
+  isolate_->RemoveGCPrologueCallback(&GcScheduler::OnGCPrologue, this);
+  isolate_->RemoveGCEpilogueCallback(&GcScheduler::OnGCEpilogue, this);
+}
+
+void GcScheduler::SetOptions(const Options& options) {
+  options_ = options;
+
+  if (options_.idle_gc) {
+    idle_work_done_ = false;
+    StartIdleTimer();
+  } else {
+    idle_timer_.Stop();
+  }
+
+  if (!options_.full_gc_interval.is_zero()) {
+    full_gc_timer_.Start(FROM_HERE, options_.full_gc_interval,
+                         base::BindRepeating(&GcScheduler::OnFullGCTimer,
+                                             base::Unretained(this)));
+  } else {
+    full_gc_timer_.Stop();
+  }
+}
+
+void GcScheduler::WillProcessTask(const base::PendingTask& pending_task,
+                                  bool was_blocked_or_low_priority) {}
+
+void GcScheduler::DidProcessTask(const base::PendingTask& pending_task) {
+  last_task_end_ = base::TimeTicks::Now();
+  task_count_++;
+
+  // The idle checks are stopped once V8 has nothing left to do, the first
+  // task run after the one that stopped them may leave garbage behind again.
+  if (idle_work_done_ && options_.idle_gc && !idle_timer_.IsRunning() &&
+      task_count_ - task_count_at_idle_check_ > 1) {
+    idle_work_done_ = false;
+    StartIdleTimer();
+  }
+}
+
+void GcScheduler::StartIdleTimer() {
+  idle_timer_.Start(
+      FROM_HERE, kIdleCheckInterval,
+      base::BindRepeating(&GcScheduler::OnIdleCheck, base::Unretained(this)));
+}
+
+// static
+void GcScheduler::OnGCPrologue(v8::Isolate* isolate,
+                               v8::GCType type,
+                               v8::GCCallbackFlags flags,
+                               void* data) {
+  auto* self = static_cast<GcScheduler*>(data);
+  self->gc_start_ = base::TimeTicks::Now();
+}
+
+// static
+void GcScheduler::OnGCEpilogue(v8::Isolate* isolate,
+                               v8::GCType type,
+                               v8::GCCallbackFlags flags,
+                               void* data) {
+  auto* self = static_cast<GcScheduler*>(data);
+  // Incremental marking steps and weak callback processing are reported too,
+  // only the atomic pauses of actual collections are counted.
+  if (type & (v8::kGCTypeScavenge | v8::kGCTypeMinorMarkCompact))
+    self->stats_.minor_gc_count++;
+  else if (type & v8::kGCTypeMarkSweepCompact)
+    self->stats_.major_gc_count++;
+  else
+    return;
+  base::TimeDelta pause = base::TimeTicks::Now() - self->gc_start_;
+  self->stats_.total_pause_time += pause;
+  self->stats_.max_pause_time = std::max(self->stats_.max_pause_time, pause);
+}
+
+void GcScheduler::OnIdleCheck() {
+  // The previous check is one of the tasks counted since then, any other one
+  // means the app did some work which may have left garbage behind.
+  if (task_count_ - task_count_at_idle_check_ > 1)
+    idle_work_done_ = false;
+  task_count_at_idle_check_ = task_count_;
+
+  // |last_task_end_| is the end of the task that ran before this one.
+  if (idle_work_done_ || base::TimeTicks::Now() - last_task_end_ < kMinIdleTime)
+    return;
+
+  v8::HandleScope handle_scope(isolate_);
+  double deadline = platform_->MonotonicallyIncreasingTime() +
+                    kIdleTimeBudget.InSecondsF();
+  idle_work_done_ = isolate_->IdleNotificationDeadline(deadline);
+  stats_.idle_notification_count++;
+
+  // Don't wake the main thread up again until some other task has run.
+  if (idle_work_done_)
+    idle_timer_.Stop();
+}
+
+void GcScheduler::OnFullGCTimer() {
+  isolate_->LowMemoryNotification();
+  stats_.forced_gc_count++;
+}
+
+void GcScheduler::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  switch (level) {
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE:
+      isolate_->MemoryPressureNotification(v8::MemoryPressureLevel::kNone);
+      break;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE:
+      isolate_->MemoryPressureNotification(v8::MemoryPressureLevel::kModerate);
+      break;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL:
+      // V8 runs a full GC right away under critical pressure.
+      isolate_->MemoryPressureNotification(v8::MemoryPressureLevel::kCritical);
+      break;
+  }
+}
+
+}  // namespace electron
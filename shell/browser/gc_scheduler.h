@@ -0,0 +1,94 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_GC_SCHEDULER_H_
+#define SHELL_BROWSER_GC_SCHEDULER_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "base/macros.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/task/task_observer.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "v8/include/v8.h"
+
+namespace electron {
+
+// Lets V8 collect garbage in the browser process while the main thread is
+// idle, and forwards memory pressure to it, instead of forcing a full GC on a
+// fixed interval regardless of what the app is doing.
+class GcScheduler : public base::TaskObserver {
+ public:
+  struct Options {
+    // Whether V8 is given idle time once the message loop has gone quiet.
+    bool idle_gc = true;
+    // Interval of the forced full GC, which is disabled when zero.
+    base::TimeDelta full_gc_interval;
+  };
+
+  struct Stats {
+    uint64_t minor_gc_count = 0;
+    uint64_t major_gc_count = 0;
+    // Time spent in the main thread pauses of the collections above.
+    base::TimeDelta total_pause_time;
+    base::TimeDelta max_pause_time;
+    uint64_t idle_notification_count = 0;
+    uint64_t forced_gc_count = 0;
+  };
+
+  GcScheduler(v8::Isolate* isolate, v8::Platform* platform);
+  ~GcScheduler() override;
+
+  void SetOptions(const Options& options);
+  const Options& options() const { return options_; }
+  const Stats& stats() const { return stats_; }
+
+  // base::TaskObserver:
+  void WillProcessTask(const base::PendingTask& pending_task,
+                       bool was_blocked_or_low_priority) override;
+  void DidProcessTask(const base::PendingTask& pending_task) override;
+
+ private:
+  static void OnGCPrologue(v8::Isolate* isolate,
+                           v8::GCType type,
+                           v8::GCCallbackFlags flags,
+                           void* data);
+  static void OnGCEpilogue(v8::Isolate* isolate,
+                           v8::GCType type,
+                           v8::GCCallbackFlags flags,
+                           void* data);
+
+  void StartIdleTimer();
+  void OnIdleCheck();
+  void OnFullGCTimer();
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+
+  v8::Isolate* isolate_;
+  v8::Platform* platform_;
+  Options options_;
+  Stats stats_;
+
+  base::RepeatingTimer idle_timer_;
+  base::RepeatingTimer full_gc_timer_;
+  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+
+  // End of the last task run by the main message loop, and the number of
+  // tasks run so far, including the idle checks.
+  base::TimeTicks last_task_end_;
+  uint64_t task_count_ = 0;
+  uint64_t task_count_at_idle_check_ = 0;
+  // Set when V8 has nothing left to do in idle time until more work happens.
+  bool idle_work_done_ = false;
+
+  base::TimeTicks gc_start_;
+
+  DISALLOW_COPY_AND_ASSIGN(GcScheduler);
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_GC_SCHEDULER_H_
@@ -8,9 +8,13 @@
 
 #include <string>
 
+#include "base/base_paths.h"
 #include "base/command_line.h"
+#include "base/files/memory_mapped_file.h"
 #include "base/message_loop/message_loop_current.h"
+#include "base/path_service.h"
 #include "base/task/thread_pool/initialization_util.h"
+#include "base/threading/thread_restrictions.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "content/public/common/content_switches.h"
 #include "gin/array_buffer.h"
@@ -19,6 +23,38 @@
 #include "shell/common/node_includes.h"
 #include "tracing/trace_event.h"
 
+namespace {
+
+// Startup snapshot used by the main process only, looked up next to the
+// snapshot_blob.bin shared by all processes.
+const base::FilePath::CharType kBrowserSnapshotFileName[] =
+    FILE_PATH_LITERAL("browser_snapshot_blob.bin");
+
+// Returns the browser snapshot if the app ships one, to be used instead of the
+// snapshot set for the whole process by gin. Since only the main process
+// reads it, it can hold the app's own module graph without growing the heap
+// of every renderer.
+v8::StartupData* LoadBrowserSnapshot() {
+  base::FilePath assets_dir;
+  if (!base::PathService::Get(base::DIR_ASSETS, &assets_dir))
+    return nullptr;
+
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  // Leaked on exit, V8 reads from it for the lifetime of the isolate.
+  auto* snapshot = new base::MemoryMappedFile;
+  if (!snapshot->Initialize(assets_dir.Append(kBrowserSnapshotFileName))) {
+    delete snapshot;
+    return nullptr;
+  }
+
+  static v8::StartupData startup_data;
+  startup_data.data = reinterpret_cast<const char*>(snapshot->data());
+  startup_data.raw_size = static_cast<int>(snapshot->length());
+  return &startup_data;
+}
+
+}  // namespace
+
 namespace electron {
 
 JavascriptEnvironment::JavascriptEnvironment(uv_loop_t* event_loop)
@@ -28,7 +64,8 @@ JavascriptEnvironment::JavascriptEnvironment(uv_loop_t* event_loop)
                       gin::IsolateHolder::kAllowAtomicsWait,
                       gin::IsolateHolder::IsolateType::kUtility,
                       gin::IsolateHolder::IsolateCreationMode::kNormal,
-                      isolate_),
+                      isolate_,
+                      snapshot_blob_),
       isolate_scope_(isolate_),
       locker_(isolate_),
       handle_scope_(isolate_),
@@ -59,6 +96,9 @@ v8::Isolate* JavascriptEnvironment::Initialize(uv_loop_t* event_loop) {
                                  gin::ArrayBufferAllocator::SharedInstance(),
                                  nullptr /* external_reference_table */,
                                  false /* create_v8_platform */);
+  // v8::V8::SetSnapshotDataBlob() has already been called by gin, the browser
+  // snapshot is passed to the isolate instead.
+  snapshot_blob_ = LoadBrowserSnapshot();
 
   v8::Isolate* isolate = v8::Isolate::Allocate();
   platform_->RegisterIsolate(isolate, event_loop);
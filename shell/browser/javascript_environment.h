@@ -38,6 +38,9 @@ class JavascriptEnvironment {
   v8::Isolate* Initialize(uv_loop_t* event_loop);
   // Leaked on exit.
   node::MultiIsolatePlatform* platform_;
+  // Startup snapshot of |isolate_|, or null to use the one of the process.
+  // Set by Initialize(), before |isolate_holder_| is constructed.
+  v8::StartupData* snapshot_blob_ = nullptr;
 
   v8::Isolate* isolate_;
   gin::IsolateHolder isolate_holder_;
@@ -0,0 +1,457 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/native_ipc_handler_registry.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/containers/span.h"
+#include "base/logging.h"
+#include "base/sequenced_task_runner.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/stl_util.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "base/threading/thread_restrictions.h"
+#include "mojo/public/cpp/bindings/callback_helpers.h"
+#include "mojo/public/cpp/bindings/receiver.h"
+#include "mojo/public/cpp/bindings/remote.h"
+#include "shell/common/native_mate_converters/serialized_message.h"
+
+namespace electron {
+
+namespace {
+
+using serialized_message::GetHeaderSize;
+using serialized_message::IsNewSerialization;
+using serialized_message::kArrayWrappedValueTag;
+using serialized_message::kNewSerializationTag;
+using serialized_message::kResultWrappedValueTag;
+
+class ScopedAllowBaseSyncPrimitives
+    : public base::ScopedAllowBaseSyncPrimitivesForTesting {};
+
+// Tags of the V8 wire format, which is stable since values are persisted
+// with it.
+constexpr uint8_t kUndefinedTag = '_';
+constexpr uint8_t kOneByteStringTag = '"';
+constexpr uint8_t kTwoByteStringTag = 'c';
+constexpr uint8_t kBeginJSObjectTag = 'o';
+constexpr uint8_t kEndJSObjectTag = '{';
+constexpr uint8_t kBeginDenseJSArrayTag = 'A';
+constexpr uint8_t kEndDenseJSArrayTag = '$';
+
+void WriteVarint(uint32_t value, std::vector<uint8_t>* out) {
+  do {
+    uint8_t byte = value & 0x7F;
+    value >>= 7;
+    out->push_back(value ? byte | 0x80 : byte);
+  } while (value);
+}
+
+void WriteOneByteString(base::StringPiece string, std::vector<uint8_t>* out) {
+  out->push_back(kOneByteStringTag);
+  WriteVarint(string.size(), out);
+  out->insert(out->end(), string.begin(), string.end());
+}
+
+void WriteTwoByteString(const base::string16& string,
+                        std::vector<uint8_t>* out) {
+  const auto* bytes = reinterpret_cast<const uint8_t*>(string.data());
+  size_t size = string.size() * sizeof(base::char16);
+  out->push_back(kTwoByteStringTag);
+  WriteVarint(size, out);
+  out->insert(out->end(), bytes, bytes + size);
+}
+
+std::vector<uint8_t> GetHeader(base::span<const uint8_t> message) {
+  return std::vector<uint8_t>(message.begin(),
+                              message.begin() + GetHeaderSize(message));
+}
+
+// Drops the serialization tag, so that handlers get what v8.serialize()
+// returns.
+std::vector<uint8_t> ToHandlerData(base::span<const uint8_t> message) {
+  size_t header_size = GetHeaderSize(message);
+  DCHECK(header_size);
+  std::vector<uint8_t> data(message.begin(), message.begin() + header_size);
+  data.insert(data.end(), message.begin() + header_size + 1, message.end());
+  return data;
+}
+
+blink::CloneableMessage ToCloneableMessage(std::vector<uint8_t> data) {
+  blink::CloneableMessage message;
+  message.owned_encoded_message = std::move(data);
+  message.encoded_message = message.owned_encoded_message;
+  return message;
+}
+
+class ReplyImpl : public api::ipc::Reply {
+ public:
+  ReplyImpl(NativeIpcHandlerRegistry::ReplyType type,
+            std::vector<uint8_t> header,
+            NativeIpcHandlerRegistry::ReplyCallback callback)
+      : type_(type),
+        header_(std::move(header)),
+        callback_(std::move(callback)),
+        task_runner_(base::SequencedTaskRunnerHandle::Get()) {}
+
+  // api::ipc::Reply:
+  void Send(const uint8_t* data, size_t size) override {
+    base::span<const uint8_t> value(data, size);
+    size_t header_size = GetHeaderSize(value);
+    if (!header_size) {
+      SendError("The reply is not a serialized value");
+      return;
+    }
+
+    // The value is wrapped by the renderer when it is read.
+    std::vector<uint8_t> out(value.begin(), value.begin() + header_size);
+    out.push_back(type_ == NativeIpcHandlerRegistry::ReplyType::kSendSync
+                      ? kArrayWrappedValueTag
+                      : kResultWrappedValueTag);
+    out.insert(out.end(), value.begin() + header_size, value.end());
+    Run(std::move(out));
+  }
+
+  void SendError(const char* message) override {
+    LOG(ERROR) << "Error occurred in native IPC handler: " << message;
+    std::vector<uint8_t> out(header_);
+    out.push_back(kNewSerializationTag);
+    if (type_ == NativeIpcHandlerRegistry::ReplyType::kSendSync) {
+      out.push_back(kBeginDenseJSArrayTag);
+      WriteVarint(1, &out);
+      out.push_back(kUndefinedTag);
+      out.push_back(kEndDenseJSArrayTag);
+      WriteVarint(0, &out);
+      WriteVarint(1, &out);
+    } else {
+      out.push_back(kBeginJSObjectTag);
+      WriteOneByteString("error", &out);
+      WriteTwoByteString(base::UTF8ToUTF16(message), &out);
+      out.push_back(kEndJSObjectTag);
+      WriteVarint(1, &out);
+    }
+    Run(std::move(out));
+  }
+
+ private:
+  ~ReplyImpl() override = default;
+
+  void Run(std::vector<uint8_t> data) {
+    task_runner_->PostTask(
+        FROM_HERE, base::BindOnce(std::move(callback_),
+                                  ToCloneableMessage(std::move(data))));
+    delete this;
+  }
+
+  NativeIpcHandlerRegistry::ReplyType type_;
+  // Header of the message being replied to, used when there is no reply
+  // value to take it from.
+  std::vector<uint8_t> header_;
+  NativeIpcHandlerRegistry::ReplyCallback callback_;
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReplyImpl);
+};
+
+}  // namespace
+
+// The end of a renderer's ElectronNativeIpc pipe, used on the handler thread.
+class NativeIpcHandlerRegistry::Receiver : public mojom::ElectronNativeIpc {
+ public:
+  Receiver(NativeIpcHandlerRegistry* registry,
+           int32_t web_contents_id,
+           FallbackCallback fallback,
+           mojo::PendingReceiver<mojom::ElectronNativeIpc> receiver)
+      : registry_(registry),
+        web_contents_id_(web_contents_id),
+        fallback_(std::move(fallback)),
+        fallback_task_runner_(base::SequencedTaskRunnerHandle::Get()),
+        pending_receiver_(std::move(receiver)) {}
+
+  void Bind() {
+    receiver_.Bind(std::move(pending_receiver_));
+    receiver_.set_disconnect_handler(
+        base::BindOnce(&NativeIpcHandlerRegistry::OnReceiverDisconnected,
+                       base::Unretained(registry_), base::Unretained(this)));
+  }
+
+  void OnChannelsChanged(const std::vector<std::string>& channels) {
+    if (observer_)
+      observer_->OnChannelsChanged(channels);
+  }
+
+  // mojom::ElectronNativeIpc:
+  void SetChannelsObserver(
+      mojo::PendingRemote<mojom::NativeIpcChannelsObserver> observer) override {
+    observer_.reset();
+    observer_.Bind(std::move(observer));
+    observer_->OnChannelsChanged(registry_->GetChannels());
+  }
+
+  void Message(const std::string& channel,
+               blink::CloneableMessage arguments) override {
+    Handle(ReplyType::kSendSync, channel, std::move(arguments),
+           ReplyCallback());
+  }
+
+  void Invoke(const std::string& channel,
+              blink::CloneableMessage arguments,
+              InvokeCallback callback) override {
+    Handle(ReplyType::kInvoke, channel, std::move(arguments),
+           std::move(callback));
+  }
+
+  void MessageSync(const std::string& channel,
+                   blink::CloneableMessage arguments,
+                   MessageSyncCallback callback) override {
+    Handle(ReplyType::kSendSync, channel, std::move(arguments),
+           std::move(callback));
+  }
+
+ private:
+  void Handle(ReplyType reply_type,
+              const std::string& channel,
+              blink::CloneableMessage arguments,
+              ReplyCallback reply) {
+    api::ipc::MessageHandler* handler = nullptr;
+    // Arguments serialized as a base::Value are left to ipcMain.
+    if (IsNewSerialization(arguments.encoded_message)) {
+      base::AutoLock auto_lock(registry_->handlers_lock_);
+      auto it = registry_->handlers_.find(channel);
+      if (it != registry_->handlers_.end())
+        handler = it->second;
+    }
+
+    if (!handler) {
+      // The renderer did not know yet that the channel lost its handler.
+      // The reply of ipcMain has to come back to this thread, even if the
+      // WebContents is gone by the time the fallback runs.
+      if (reply) {
+        reply = mojo::WrapCallbackWithDefaultInvokeIfNotRun(
+            base::BindOnce(
+                [](scoped_refptr<base::SequencedTaskRunner> task_runner,
+                   ReplyCallback reply, blink::CloneableMessage result) {
+                  task_runner->PostTask(
+                      FROM_HERE,
+                      base::BindOnce(std::move(reply), std::move(result)));
+                },
+                base::SequencedTaskRunnerHandle::Get(), std::move(reply)),
+            blink::CloneableMessage());
+      }
+      fallback_task_runner_->PostTask(
+          FROM_HERE, base::BindOnce(fallback_, reply_type, channel,
+                                    std::move(arguments), std::move(reply)));
+      return;
+    }
+
+    ReplyImpl* reply_impl = nullptr;
+    if (reply) {
+      reply_impl = new ReplyImpl(
+          reply_type, GetHeader(arguments.encoded_message), std::move(reply));
+    }
+    // A removed handler is only told so after this task, see RemoveHandler.
+    std::vector<uint8_t> data = ToHandlerData(arguments.encoded_message);
+    handler->OnMessage(web_contents_id_, channel.c_str(), data.data(),
+                       data.size(), reply_impl);
+  }
+
+  NativeIpcHandlerRegistry* registry_;
+  int32_t web_contents_id_;
+  FallbackCallback fallback_;
+  scoped_refptr<base::SequencedTaskRunner> fallback_task_runner_;
+  mojo::PendingReceiver<mojom::ElectronNativeIpc> pending_receiver_;
+  mojo::Receiver<mojom::ElectronNativeIpc> receiver_{this};
+  mojo::Remote<mojom::NativeIpcChannelsObserver> observer_;
+
+  DISALLOW_COPY_AND_ASSIGN(Receiver);
+};
+
+NativeIpcHandlerRegistry::NativeIpcHandlerRegistry() = default;
+
+NativeIpcHandlerRegistry::~NativeIpcHandlerRegistry() = default;
+
+// static
+NativeIpcHandlerRegistry* NativeIpcHandlerRegistry::GetInstance() {
+  static base::NoDestructor<NativeIpcHandlerRegistry> instance;
+  return instance.get();
+}
+
+bool NativeIpcHandlerRegistry::AddHandler(const std::string& channel,
+                                          api::ipc::MessageHandler* handler) {
+  base::AutoLock auto_lock(handlers_lock_);
+  if (shut_down_)
+    return false;
+  if (!thread_) {
+    thread_ = std::make_unique<base::Thread>("Electron_IPCHandlerThread");
+    if (!thread_->Start()) {
+      thread_.reset();
+      return false;
+    }
+  }
+  if (!handlers_.emplace(channel, handler).second)
+    return false;
+  thread_->task_runner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&NativeIpcHandlerRegistry::NotifyChannelsChanged,
+                     base::Unretained(this)));
+  return true;
+}
+
+void NativeIpcHandlerRegistry::RemoveHandler(const std::string& channel) {
+  api::ipc::MessageHandler* handler = nullptr;
+  {
+    base::AutoLock auto_lock(handlers_lock_);
+    auto it = handlers_.find(channel);
+    if (it == handlers_.end())
+      return;
+    handler = it->second;
+    handlers_.erase(it);
+
+    if (thread_) {
+      // Handlers are only called on |thread_|, so the handler has returned
+      // from any message it was handling once this task runs.
+      thread_->task_runner()->PostTask(
+          FROM_HERE, base::BindOnce(&api::ipc::MessageHandler::OnRemoved,
+                                    base::Unretained(handler)));
+      thread_->task_runner()->PostTask(
+          FROM_HERE,
+          base::BindOnce(&NativeIpcHandlerRegistry::NotifyChannelsChanged,
+                         base::Unretained(this)));
+      return;
+    }
+  }
+  // The handler thread has been stopped.
+  handler->OnRemoved();
+}
+
+bool NativeIpcHandlerRegistry::CanHandle(
+    const std::string& channel,
+    const blink::CloneableMessage& arguments) {
+  {
+    base::AutoLock auto_lock(handlers_lock_);
+    if (!thread_ || !handlers_.count(channel))
+      return false;
+  }
+  // Arguments serialized as a base::Value are left to ipcMain.
+  return IsNewSerialization(arguments.encoded_message);
+}
+
+void NativeIpcHandlerRegistry::Dispatch(
+    int32_t web_contents_id,
+    const std::string& channel,
+    const blink::CloneableMessage& arguments,
+    ReplyType reply_type,
+    ReplyCallback reply) {
+  std::vector<uint8_t> data = ToHandlerData(arguments.encoded_message);
+
+  ReplyImpl* reply_impl = nullptr;
+  if (reply) {
+    reply_impl = new ReplyImpl(
+        reply_type, GetHeader(arguments.encoded_message), std::move(reply));
+  }
+
+  base::AutoLock auto_lock(handlers_lock_);
+  // CanHandle was true, and the thread is only stopped on the UI thread.
+  DCHECK(thread_);
+  thread_->task_runner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&NativeIpcHandlerRegistry::HandleMessage,
+                     base::Unretained(this), web_contents_id, channel,
+                     std::move(data), reply_impl));
+}
+
+void NativeIpcHandlerRegistry::BindReceiver(
+    int32_t web_contents_id,
+    FallbackCallback fallback,
+    mojo::PendingReceiver<mojom::ElectronNativeIpc> receiver) {
+  auto receiver_impl = std::make_unique<Receiver>(
+      this, web_contents_id, std::move(fallback), std::move(receiver));
+  base::AutoLock auto_lock(handlers_lock_);
+  if (!thread_)
+    return;
+  thread_->task_runner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&NativeIpcHandlerRegistry::BindReceiverOnHandlerThread,
+                     base::Unretained(this), std::move(receiver_impl)));
+}
+
+void NativeIpcHandlerRegistry::Shutdown() {
+  std::unique_ptr<base::Thread> thread;
+  {
+    base::AutoLock auto_lock(handlers_lock_);
+    shut_down_ = true;
+    thread = std::move(thread_);
+  }
+  if (!thread)
+    return;
+
+  thread->task_runner()->PostTask(
+      FROM_HERE, base::BindOnce(&NativeIpcHandlerRegistry::CloseReceivers,
+                                base::Unretained(this)));
+  // The thread is started by the first AddHandler, on whichever thread the
+  // addon called it.
+  thread->DetachFromSequence();
+  ScopedAllowBaseSyncPrimitives allow_join;
+  thread->Stop();
+}
+
+std::vector<std::string> NativeIpcHandlerRegistry::GetChannels() {
+  base::AutoLock auto_lock(handlers_lock_);
+  std::vector<std::string> channels;
+  for (const auto& handler : handlers_)
+    channels.push_back(handler.first);
+  return channels;
+}
+
+void NativeIpcHandlerRegistry::HandleMessage(int32_t web_contents_id,
+                                             const std::string& channel,
+                                             std::vector<uint8_t> data,
+                                             api::ipc::Reply* reply) {
+  api::ipc::MessageHandler* handler = nullptr;
+  {
+    base::AutoLock auto_lock(handlers_lock_);
+    auto it = handlers_.find(channel);
+    if (it != handlers_.end())
+      handler = it->second;
+  }
+
+  // The handler was removed after the message was dispatched.
+  if (!handler) {
+    if (reply) {
+      std::string error = "No handler registered for '" + channel + "'";
+      reply->SendError(error.c_str());
+    }
+    return;
+  }
+
+  handler->OnMessage(web_contents_id, channel.c_str(), data.data(),
+                     data.size(), reply);
+}
+
+void NativeIpcHandlerRegistry::BindReceiverOnHandlerThread(
+    std::unique_ptr<Receiver> receiver) {
+  receiver->Bind();
+  receivers_.push_back(std::move(receiver));
+}
+
+void NativeIpcHandlerRegistry::OnReceiverDisconnected(Receiver* receiver) {
+  base::EraseIf(receivers_, [receiver](const std::unique_ptr<Receiver>& item) {
+    return item.get() == receiver;
+  });
+}
+
+void NativeIpcHandlerRegistry::NotifyChannelsChanged() {
+  std::vector<std::string> channels = GetChannels();
+  for (const auto& receiver : receivers_)
+    receiver->OnChannelsChanged(channels);
+}
+
+void NativeIpcHandlerRegistry::CloseReceivers() {
+  receivers_.clear();
+}
+
+}  // namespace electron
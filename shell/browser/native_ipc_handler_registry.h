@@ -0,0 +1,114 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_NATIVE_IPC_HANDLER_REGISTRY_H_
+#define SHELL_BROWSER_NATIVE_IPC_HANDLER_REGISTRY_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/no_destructor.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/thread.h"
+#include "electron/native_api/ipc.h"
+#include "mojo/public/cpp/bindings/pending_receiver.h"
+#include "shell/common/api/api.mojom.h"
+#include "third_party/blink/public/common/messaging/cloneable_message.h"
+
+namespace electron {
+
+// IPC channels handled by native addons through the native_api, see
+// native_api/ipc.h. The handlers are called on a dedicated thread, so that
+// their messages are not queued behind the JavaScript of the main process.
+class NativeIpcHandlerRegistry {
+ public:
+  using ReplyCallback = base::OnceCallback<void(blink::CloneableMessage)>;
+
+  // How the renderer expects the return value to be wrapped, see
+  // lib/browser/api/web-contents.js.
+  enum class ReplyType {
+    kSendSync,  // [value]
+    kInvoke,    // {result: value} or {error: message}
+  };
+
+  // Passes a message received by BindReceiver to ipcMain. |reply| is null
+  // for messages that do not expect a return value.
+  using FallbackCallback =
+      base::RepeatingCallback<void(ReplyType reply_type,
+                                   const std::string& channel,
+                                   blink::CloneableMessage arguments,
+                                   ReplyCallback reply)>;
+
+  static NativeIpcHandlerRegistry* GetInstance();
+
+  bool AddHandler(const std::string& channel,
+                  api::ipc::MessageHandler* handler);
+  // Does not wait for the handler, which is told when it is no longer called
+  // through MessageHandler::OnRemoved.
+  void RemoveHandler(const std::string& channel);
+
+  // Whether |arguments| sent on |channel| are handled natively.
+  bool CanHandle(const std::string& channel,
+                 const blink::CloneableMessage& arguments);
+
+  // Passes the message to the handler of |channel| on the handler thread.
+  // |reply| is null for messages that do not expect a return value, otherwise
+  // it is run on the calling sequence.
+  void Dispatch(int32_t web_contents_id,
+                const std::string& channel,
+                const blink::CloneableMessage& arguments,
+                ReplyType reply_type,
+                ReplyCallback reply);
+
+  // Binds |receiver| on the handler thread, so that the messages a renderer
+  // of |web_contents_id| sends on native channels skip the UI thread. Those
+  // whose channel has no handler anymore are passed to |fallback| on the
+  // calling sequence. |receiver| is dropped if no handler was ever added, and
+  // the renderer keeps sending everything to the UI thread.
+  void BindReceiver(int32_t web_contents_id,
+                    FallbackCallback fallback,
+                    mojo::PendingReceiver<mojom::ElectronNativeIpc> receiver);
+
+  // Stops the handler thread, once the main message loop has quit.
+  void Shutdown();
+
+ private:
+  friend class base::NoDestructor<NativeIpcHandlerRegistry>;
+
+  class Receiver;
+
+  NativeIpcHandlerRegistry();
+  ~NativeIpcHandlerRegistry();
+
+  std::vector<std::string> GetChannels();
+
+  // Called on |thread_|.
+  void HandleMessage(int32_t web_contents_id,
+                     const std::string& channel,
+                     std::vector<uint8_t> data,
+                     api::ipc::Reply* reply);
+  void BindReceiverOnHandlerThread(std::unique_ptr<Receiver> receiver);
+  void OnReceiverDisconnected(Receiver* receiver);
+  void NotifyChannelsChanged();
+  void CloseReceivers();
+
+  // Guards the members below.
+  base::Lock handlers_lock_;
+  std::map<std::string, api::ipc::MessageHandler*> handlers_;
+  std::unique_ptr<base::Thread> thread_;
+  bool shut_down_ = false;
+
+  // Used on |thread_| only.
+  std::vector<std::unique_ptr<Receiver>> receivers_;
+
+  DISALLOW_COPY_AND_ASSIGN(NativeIpcHandlerRegistry);
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_NATIVE_IPC_HANDLER_REGISTRY_H_
@@ -4,11 +4,14 @@
 
 #include "shell/browser/net/asar/asar_url_loader.h"
 
+#include <cinttypes>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/task/post_task.h"
 #include "content/public/browser/file_url_loader.h"
@@ -20,6 +23,7 @@
 #include "net/base/mime_sniffer.h"
 #include "net/base/mime_util.h"
 #include "net/http/http_byte_range.h"
+#include "net/http/http_response_headers.h"
 #include "net/http/http_util.h"
 #include "services/network/public/cpp/resource_response.h"
 #include "shell/common/asar/archive.h"
@@ -53,11 +57,49 @@ static_assert(kDefaultFileUrlPipeSize >= net::kMaxBytesToSniff,
               "Default file data pipe size must be at least as large as a MIME-"
               "type sniffing buffer.");
 
+// Returns an entity tag for the file of |size| bytes at |offset| of a file
+// last modified at |last_modified|.
+std::string MakeETag(base::Time last_modified, uint64_t offset, uint64_t size) {
+  return base::StringPrintf(
+      "\"%" PRIx64 "-%" PRIx64 "-%" PRIx64 "\"",
+      last_modified.ToDeltaSinceWindowsEpoch().InMicroseconds(), offset, size);
+}
+
+// Whether the If-None-Match header of |request| matches |etag|.
+bool MatchesIfNoneMatch(const network::ResourceRequest& request,
+                        const std::string& etag) {
+  std::string if_none_match;
+  if (!request.headers.GetHeader(net::HttpRequestHeaders::kIfNoneMatch,
+                                 &if_none_match))
+    return false;
+  for (base::StringPiece tag :
+       base::SplitStringPiece(if_none_match, ",", base::TRIM_WHITESPACE,
+                              base::SPLIT_WANT_NONEMPTY)) {
+    // Weak comparison is used for If-None-Match.
+    if (base::StartsWith(tag, "W/", base::CompareCase::SENSITIVE))
+      tag.remove_prefix(2);
+    if (tag == "*" || tag == etag)
+      return true;
+  }
+  return false;
+}
+
 // Modified from the |FileURLLoader| in |file_url_loader_factory.cc|, to serve
 // asar files instead of normal files.
 class AsarURLLoader : public network::mojom::URLLoader {
  public:
+  enum class Mode {
+    // Serves the file of a file: URL, where files out of asar archives are
+    // passed to the FileURLLoader.
+    kFileURL,
+    // Serves a file path, inside an asar archive or not, and answers range
+    // and conditional requests with 206 and 304 responses.
+    kFilePath,
+  };
+
   static void CreateAndStart(
+      Mode mode,
+      const base::FilePath& path,
       const network::ResourceRequest& request,
       network::mojom::URLLoaderRequest loader,
       mojo::PendingRemote<network::mojom::URLLoaderClient> client,
@@ -66,7 +108,8 @@ class AsarURLLoader : public network::mojom::URLLoader {
     // bindings are alive - essentially until either the client gives up or all
     // file data has been sent to it.
     auto* asar_url_loader = new AsarURLLoader;
-    asar_url_loader->Start(request, std::move(loader), std::move(client),
+    asar_url_loader->Start(mode, path, request, std::move(loader),
+                           std::move(client),
                            std::move(extra_response_headers));
   }
 
@@ -83,7 +126,9 @@ class AsarURLLoader : public network::mojom::URLLoader {
   AsarURLLoader() {}
   ~AsarURLLoader() override = default;
 
-  void Start(const network::ResourceRequest& request,
+  void Start(Mode mode,
+             base::FilePath path,
+             const network::ResourceRequest& request,
              mojo::PendingReceiver<network::mojom::URLLoader> loader,
              mojo::PendingRemote<network::mojom::URLLoaderClient> client,
              scoped_refptr<net::HttpResponseHeaders> extra_response_headers) {
@@ -92,8 +137,8 @@ class AsarURLLoader : public network::mojom::URLLoader {
     head.response_start = base::TimeTicks::Now();
     head.headers = extra_response_headers;
 
-    base::FilePath path;
-    if (!net::FileURLToFilePath(request.url, &path)) {
+    if (mode == Mode::kFileURL &&
+        !net::FileURLToFilePath(request.url, &path)) {
       mojo::Remote<network::mojom::URLLoaderClient> client_remote(
           std::move(client));
       client_remote->OnComplete(
@@ -104,7 +149,8 @@ class AsarURLLoader : public network::mojom::URLLoader {
 
     // Determine whether it is an asar file.
     base::FilePath asar_path, relative_path;
-    if (!GetAsarArchivePath(path, &asar_path, &relative_path)) {
+    bool is_asar = GetAsarArchivePath(path, &asar_path, &relative_path);
+    if (!is_asar && mode == Mode::kFileURL) {
       content::CreateFileURLLoader(request, std::move(loader),
                                    std::move(client), nullptr, false,
                                    extra_response_headers);
@@ -117,19 +163,49 @@ class AsarURLLoader : public network::mojom::URLLoader {
     receiver_.set_disconnect_handler(base::BindOnce(
         &AsarURLLoader::OnConnectionError, base::Unretained(this)));
 
-    // Parse asar archive.
-    std::shared_ptr<Archive> archive = GetOrCreateAsarArchive(asar_path);
     Archive::FileInfo info;
-    if (!archive || !archive->GetFileInfo(relative_path, &info)) {
+    base::FilePath real_path = path;
+    if (is_asar) {
+      // Parse asar archive.
+      std::shared_ptr<Archive> archive = GetOrCreateAsarArchive(asar_path);
+      if (!archive || !archive->GetFileInfo(relative_path, &info)) {
+        OnClientComplete(net::ERR_FILE_NOT_FOUND);
+        return;
+      }
+
+      // For unpacked path, read like normal file.
+      if (info.unpacked) {
+        archive->CopyFileOut(relative_path, &real_path);
+        info.offset = 0;
+      } else {
+        real_path = archive->path();
+      }
+    }
+
+    // Note that while the |Archive| already opens a |base::File|, we still need
+    // to create a new |base::File| here, as it might be accessed by multiple
+    // requests at the same time.
+    base::File file(real_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+    base::File::Info file_info;
+    if (mode == Mode::kFilePath &&
+        (!file.GetInfo(&file_info) || file_info.is_directory)) {
       OnClientComplete(net::ERR_FILE_NOT_FOUND);
       return;
     }
-
-    // For unpacked path, read like normal file.
-    base::FilePath real_path;
-    if (info.unpacked) {
-      archive->CopyFileOut(relative_path, &real_path);
-      info.offset = 0;
+    // Plain files may be larger than the ones in asar archives.
+    uint64_t file_size = is_asar ? info.size : file_info.size;
+
+    if (mode == Mode::kFilePath && head.headers) {
+      // Files in an archive share its modification time, their offset tells
+      // them apart.
+      std::string etag =
+          MakeETag(file_info.last_modified, info.offset, file_size);
+      head.headers->AddHeader("ETag: " + etag);
+      head.headers->AddHeader("Accept-Ranges: bytes");
+      if (MatchesIfNoneMatch(request, etag)) {
+        SendNotModified(std::move(head));
+        return;
+      }
     }
 
     mojo::DataPipe pipe(kDefaultFileUrlPipeSize);
@@ -138,11 +214,6 @@ class AsarURLLoader : public network::mojom::URLLoader {
       return;
     }
 
-    // Note that while the |Archive| already opens a |base::File|, we still need
-    // to create a new |base::File| here, as it might be accessed by multiple
-    // requests at the same time.
-    base::File file(info.unpacked ? real_path : archive->path(),
-                    base::File::FLAG_OPEN | base::File::FLAG_READ);
     auto file_data_source =
         std::make_unique<mojo::FileDataSource>(std::move(file));
     mojo::DataPipeProducer::DataSource* data_source = file_data_source.get();
@@ -165,7 +236,7 @@ class AsarURLLoader : public network::mojom::URLLoader {
       if (net::HttpUtil::ParseRangeHeader(range_header, &ranges) &&
           ranges.size() == 1) {
         byte_range = ranges[0];
-        if (!byte_range.ComputeBounds(info.size))
+        if (!byte_range.ComputeBounds(file_size))
           fail = true;
       } else {
         fail = true;
@@ -178,7 +249,7 @@ class AsarURLLoader : public network::mojom::URLLoader {
     }
 
     uint64_t first_byte_to_send = 0;
-    uint64_t total_bytes_to_send = info.size;
+    uint64_t total_bytes_to_send = file_size;
 
     if (byte_range.IsValid()) {
       first_byte_to_send = byte_range.first_byte_position();
@@ -189,6 +260,13 @@ class AsarURLLoader : public network::mojom::URLLoader {
     total_bytes_written_ = total_bytes_to_send;
 
     head.content_length = base::saturated_cast<int64_t>(total_bytes_to_send);
+    if (mode == Mode::kFilePath && head.headers && byte_range.IsValid()) {
+      head.headers->ReplaceStatusLine("HTTP/1.1 206 Partial Content");
+      head.headers->AddHeader(base::StringPrintf(
+          "Content-Range: bytes %" PRId64 "-%" PRId64 "/%" PRIu64,
+          byte_range.first_byte_position(), byte_range.last_byte_position(),
+          file_size));
+    }
 
     if (first_byte_to_send < read_result.bytes_read) {
       // Write any data we read for MIME sniffing, constraining by range where
@@ -249,6 +327,21 @@ class AsarURLLoader : public network::mojom::URLLoader {
         base::BindOnce(&AsarURLLoader::OnFileWritten, base::Unretained(this)));
   }
 
+  // Sends a body-less 304 response, for a file the client already has.
+  void SendNotModified(network::ResourceResponseHead head) {
+    head.headers->ReplaceStatusLine("HTTP/1.1 304 Not Modified");
+    mojo::DataPipe pipe(kDefaultFileUrlPipeSize);
+    if (!pipe.consumer_handle.is_valid()) {
+      OnClientComplete(net::ERR_FAILED);
+      return;
+    }
+    client_->OnReceiveResponse(head);
+    // The body is empty.
+    pipe.producer_handle.reset();
+    client_->OnStartLoadingResponseBody(std::move(pipe.consumer_handle));
+    OnClientComplete(net::OK);
+  }
+
   void OnConnectionError() {
     receiver_.reset();
     MaybeDeleteSelf();
@@ -309,8 +402,27 @@ void CreateAsarURLLoader(
        base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN});
   task_runner->PostTask(
       FROM_HERE,
-      base::BindOnce(&AsarURLLoader::CreateAndStart, request, std::move(loader),
-                     std::move(client), std::move(extra_response_headers)));
+      base::BindOnce(&AsarURLLoader::CreateAndStart,
+                     AsarURLLoader::Mode::kFileURL, base::FilePath(), request,
+                     std::move(loader), std::move(client),
+                     std::move(extra_response_headers)));
+}
+
+void CreateAsarFileURLLoader(
+    const base::FilePath& path,
+    const network::ResourceRequest& request,
+    network::mojom::URLLoaderRequest loader,
+    mojo::PendingRemote<network::mojom::URLLoaderClient> client,
+    scoped_refptr<net::HttpResponseHeaders> extra_response_headers) {
+  auto task_runner = base::CreateSequencedTaskRunner(
+      {base::ThreadPool(), base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+       base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN});
+  task_runner->PostTask(
+      FROM_HERE,
+      base::BindOnce(&AsarURLLoader::CreateAndStart,
+                     AsarURLLoader::Mode::kFilePath, path, request,
+                     std::move(loader), std::move(client),
+                     std::move(extra_response_headers)));
 }
 
 }  // namespace asar
@@ -5,6 +5,7 @@
 #ifndef SHELL_BROWSER_NET_ASAR_ASAR_URL_LOADER_H_
 #define SHELL_BROWSER_NET_ASAR_ASAR_URL_LOADER_H_
 
+#include "base/files/file_path.h"
 #include "mojo/public/cpp/bindings/pending_remote.h"
 #include "services/network/public/mojom/url_loader.mojom.h"
 
@@ -16,6 +17,15 @@ void CreateAsarURLLoader(
     mojo::PendingRemote<network::mojom::URLLoaderClient> client,
     scoped_refptr<net::HttpResponseHeaders> extra_response_headers);
 
+// Serves |path|, which may be in an asar archive or not, with an ETag, and
+// answers Range and If-None-Match requests with 206 and 304 responses.
+void CreateAsarFileURLLoader(
+    const base::FilePath& path,
+    const network::ResourceRequest& request,
+    network::mojom::URLLoaderRequest loader,
+    mojo::PendingRemote<network::mojom::URLLoaderClient> client,
+    scoped_refptr<net::HttpResponseHeaders> extra_response_headers);
+
 }  // namespace asar
 
 #endif  // SHELL_BROWSER_NET_ASAR_ASAR_URL_LOADER_H_
@@ -4,16 +4,21 @@
 
 #include "shell/browser/net/electron_url_loader_factory.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/guid.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/numerics/ranges.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/storage_partition.h"
 #include "mojo/public/cpp/bindings/binding.h"
 #include "mojo/public/cpp/system/data_pipe_producer.h"
 #include "mojo/public/cpp/system/string_data_source.h"
+#include "net/base/escape.h"
 #include "net/base/filename_util.h"
 #include "net/http/http_status_code.h"
 #include "services/network/public/cpp/url_loader_completion_status.h"
@@ -28,6 +33,7 @@
 #include "shell/common/gin_converters/gurl_converter.h"
 #include "shell/common/gin_converters/net_converter.h"
 #include "shell/common/gin_converters/value_converter_gin_adapter.h"
+#include "url/third_party/mozilla/url_parse.h"
 
 #include "shell/common/node_includes.h"
 
@@ -139,23 +145,108 @@ network::ResourceResponseHead ToResponseHead(
   return head;
 }
 
-// Helper to write string to pipe.
+// Returns the host and path of |url|, which is parsed as a standard URL even
+// when its scheme has not been registered as standard.
+void GetHostAndPath(const GURL& url, std::string* host, std::string* path) {
+  if (url.IsStandard()) {
+    *host = url.host();
+    *path = url.path();
+    return;
+  }
+  const std::string& spec = url.possibly_invalid_spec();
+  url::Parsed parsed;
+  url::ParseStandardURL(spec.data(), spec.size(), &parsed);
+  if (parsed.host.is_nonempty())
+    *host = base::ToLowerASCII(
+        base::StringPiece(spec).substr(parsed.host.begin, parsed.host.len));
+  if (parsed.path.is_nonempty())
+    *path = spec.substr(parsed.path.begin, parsed.path.len);
+}
+
+// Maps the path of a URL to a file under |root|, returns false if it would
+// point out of it.
+bool GetFilePathUnderRoot(const base::FilePath& root,
+                          const std::string& url_path,
+                          base::FilePath* out) {
+  std::string path = net::UnescapeBinaryURLComponent(url_path);
+  if (path.find('\0') != std::string::npos)
+    return false;
+  if (path.empty() || path.back() == '/')
+    path += "index.html";
+
+  base::FilePath relative_path = base::FilePath::FromUTF8Unsafe(path);
+  if (relative_path.ReferencesParent())
+    return false;
+  std::vector<base::FilePath::StringType> components;
+  relative_path.GetComponents(&components);
+  *out = root;
+  for (const auto& component : components) {
+    // Skip the leading separator.
+    if (base::FilePath::IsSeparator(component[0]))
+      continue;
+    if (base::FilePath(component).IsAbsolute())
+      return false;
+    *out = out->Append(component);
+  }
+  return true;
+}
+
+// Responses up to this size are written to the data pipe in one go, larger
+// ones in chunks of this size.
+const uint32_t kMaxDataPipeSize = 2 * 1024 * 1024;
+
+// Default and maximum capacity of the data pipe of stream responses, which
+// is the amount of data read from the stream ahead of the consumer.
+const uint32_t kDefaultStreamPipeSize = 512 * 1024;
+const uint32_t kMaxStreamPipeSize = 16 * 1024 * 1024;
+
+// The contents of a Buffer, kept alive by a reference to its backing store
+// instead of being copied.
+class RefCountedBackingStore : public base::RefCountedMemory {
+ public:
+  RefCountedBackingStore(std::shared_ptr<v8::BackingStore> backing_store,
+                         size_t offset,
+                         size_t length)
+      : backing_store_(std::move(backing_store)),
+        offset_(offset),
+        length_(length) {}
+
+  // base::RefCountedMemory:
+  const unsigned char* front() const override {
+    return static_cast<const unsigned char*>(backing_store_->Data()) + offset_;
+  }
+  size_t size() const override { return length_; }
+
+ private:
+  ~RefCountedBackingStore() override = default;
+
+  std::shared_ptr<v8::BackingStore> backing_store_;
+  size_t offset_;
+  size_t length_;
+
+  DISALLOW_COPY_AND_ASSIGN(RefCountedBackingStore);
+};
+
+// Helper to write data to pipe.
 struct WriteData {
   mojo::Remote<network::mojom::URLLoaderClient> client;
-  std::string data;
+  // Released on the UI thread once the write has completed, the producer
+  // reads it directly on its own sequence meanwhile.
+  scoped_refptr<base::RefCountedMemory> data;
   std::unique_ptr<mojo::DataPipeProducer> producer;
 };
 
 void OnWrite(std::unique_ptr<WriteData> write_data, MojoResult result) {
   if (result != MOJO_RESULT_OK) {
-    network::URLLoaderCompletionStatus status(net::ERR_FAILED);
+    write_data->client->OnComplete(
+        network::URLLoaderCompletionStatus(net::ERR_FAILED));
     return;
   }
 
   network::URLLoaderCompletionStatus status(net::OK);
-  status.encoded_data_length = write_data->data.size();
-  status.encoded_body_length = write_data->data.size();
-  status.decoded_body_length = write_data->data.size();
+  status.encoded_data_length = write_data->data->size();
+  status.encoded_body_length = write_data->data->size();
+  status.decoded_body_length = write_data->data->size();
   write_data->client->OnComplete(status);
 }
 
@@ -163,8 +254,12 @@ void OnWrite(std::unique_ptr<WriteData> write_data, MojoResult result) {
 
 ElectronURLLoaderFactory::ElectronURLLoaderFactory(
     ProtocolType type,
-    const ProtocolHandler& handler)
-    : type_(type), handler_(handler) {}
+    const ProtocolHandler& handler,
+    scoped_refptr<ProtocolResponseCache> cache)
+    : type_(type), handler_(handler), cache_(std::move(cache)) {}
+
+ElectronURLLoaderFactory::ElectronURLLoaderFactory(const DirectoryRoots& roots)
+    : type_(ProtocolType::kDirectory), roots_(roots) {}
 
 ElectronURLLoaderFactory::~ElectronURLLoaderFactory() = default;
 
@@ -177,11 +272,26 @@ void ElectronURLLoaderFactory::CreateLoaderAndStart(
     mojo::PendingRemote<network::mojom::URLLoaderClient> client,
     const net::MutableNetworkTrafficAnnotationTag& traffic_annotation) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  if (type_ == ProtocolType::kDirectory) {
+    StartLoadingDirectory(std::move(loader), request, std::move(client));
+    return;
+  }
+
+  // Responses served from the cache don't involve the JS handler at all.
+  network::ResourceResponseHead head;
+  scoped_refptr<base::RefCountedMemory> data;
+  if (cache_->Get(request, &head, &data)) {
+    SendContents(std::move(client), std::move(head), std::move(data));
+    return;
+  }
+
   handler_.Run(
       request,
       base::BindOnce(&ElectronURLLoaderFactory::StartLoading, std::move(loader),
                      routing_id, request_id, options, request,
-                     std::move(client), traffic_annotation, nullptr, type_));
+                     std::move(client), traffic_annotation, nullptr, cache_,
+                     type_));
 }
 
 void ElectronURLLoaderFactory::Clone(
@@ -199,6 +309,7 @@ void ElectronURLLoaderFactory::StartLoading(
     mojo::PendingRemote<network::mojom::URLLoaderClient> client,
     const net::MutableNetworkTrafficAnnotationTag& traffic_annotation,
     network::mojom::URLLoaderFactory* proxy_factory,
+    scoped_refptr<ProtocolResponseCache> cache,
     ProtocolType type,
     gin::Arguments* args) {
   // Send network error when there is no argument passed.
@@ -274,11 +385,12 @@ void ElectronURLLoaderFactory::StartLoading(
 
   switch (type) {
     case ProtocolType::kBuffer:
-      StartLoadingBuffer(std::move(client), std::move(head), dict);
+      StartLoadingBuffer(request, std::move(client), std::move(head),
+                         cache.get(), dict);
       break;
     case ProtocolType::kString:
-      StartLoadingString(std::move(client), std::move(head), dict,
-                         args->isolate(), response);
+      StartLoadingString(request, std::move(client), std::move(head),
+                         cache.get(), dict, args->isolate(), response);
       break;
     case ProtocolType::kFile:
       StartLoadingFile(std::move(loader), request, std::move(client),
@@ -302,16 +414,22 @@ void ElectronURLLoaderFactory::StartLoading(
         return;
       }
       StartLoading(std::move(loader), routing_id, request_id, options, request,
-                   std::move(client), traffic_annotation, proxy_factory, type,
-                   args);
+                   std::move(client), traffic_annotation, proxy_factory,
+                   std::move(cache), type, args);
+      break;
+    case ProtocolType::kDirectory:
+      // Served without a handler, see CreateLoaderAndStart.
+      NOTREACHED();
       break;
   }
 }
 
 // static
 void ElectronURLLoaderFactory::StartLoadingBuffer(
+    const network::ResourceRequest& request,
     mojo::PendingRemote<network::mojom::URLLoaderClient> client,
     network::ResourceResponseHead head,
+    ProtocolResponseCache* cache,
     const gin_helper::Dictionary& dict) {
   v8::Local<v8::Value> buffer = dict.GetHandle();
   dict.Get("data", &buffer);
@@ -323,15 +441,34 @@ void ElectronURLLoaderFactory::StartLoadingBuffer(
     return;
   }
 
-  SendContents(
-      std::move(client), std::move(head),
-      std::string(node::Buffer::Data(buffer), node::Buffer::Length(buffer)));
+  auto view = buffer.As<v8::ArrayBufferView>();
+  v8::Local<v8::ArrayBuffer> array_buffer = view->Buffer();
+  std::shared_ptr<v8::BackingStore> backing_store =
+      array_buffer->GetBackingStore();
+  bool cached = cache && cache->enabled();
+  scoped_refptr<base::RefCountedMemory> data;
+  // The cache keeps its own copy, as the Buffer may be changed later. The
+  // backing store of an externalized buffer does not own its memory, which
+  // may be freed as soon as the Buffer is collected, so it is copied too.
+  if (cached || array_buffer->IsExternal()) {
+    data = base::MakeRefCounted<base::RefCountedBytes>(
+        static_cast<const uint8_t*>(backing_store->Data()) + view->ByteOffset(),
+        view->ByteLength());
+  } else {
+    data = base::MakeRefCounted<RefCountedBackingStore>(
+        std::move(backing_store), view->ByteOffset(), view->ByteLength());
+  }
+  if (cached)
+    cache->Put(request, head, data);
+  SendContents(std::move(client), std::move(head), std::move(data));
 }
 
 // static
 void ElectronURLLoaderFactory::StartLoadingString(
+    const network::ResourceRequest& request,
     mojo::PendingRemote<network::mojom::URLLoaderClient> client,
     network::ResourceResponseHead head,
+    ProtocolResponseCache* cache,
     const gin_helper::Dictionary& dict,
     v8::Isolate* isolate,
     v8::Local<v8::Value> response) {
@@ -348,7 +485,11 @@ void ElectronURLLoaderFactory::StartLoadingString(
     return;
   }
 
-  SendContents(std::move(client), std::move(head), std::move(contents));
+  scoped_refptr<base::RefCountedMemory> data =
+      base::RefCountedString::TakeString(&contents);
+  if (cache)
+    cache->Put(request, head, data);
+  SendContents(std::move(client), std::move(head), std::move(data));
 }
 
 // static
@@ -431,6 +572,7 @@ void ElectronURLLoaderFactory::StartLoadingStream(
     network::ResourceResponseHead head,
     const gin_helper::Dictionary& dict) {
   v8::Local<v8::Value> stream;
+  uint32_t pipe_size = kDefaultStreamPipeSize;
   if (!dict.Get("data", &stream)) {
     // Assume the opts is already a stream.
     stream = dict.GetHandle();
@@ -460,6 +602,8 @@ void ElectronURLLoaderFactory::StartLoadingStream(
     client_remote->OnComplete(
         network::URLLoaderCompletionStatus(net::ERR_FAILED));
     return;
+  } else if (dict.Get("bufferSize", &pipe_size)) {
+    pipe_size = base::ClampToRange<uint32_t>(pipe_size, 1, kMaxStreamPipeSize);
   }
 
   gin_helper::Dictionary data = ToDict(dict.isolate(), stream);
@@ -474,23 +618,59 @@ void ElectronURLLoaderFactory::StartLoadingStream(
   }
 
   new NodeStreamLoader(std::move(head), std::move(loader), std::move(client),
-                       data.isolate(), data.GetHandle());
+                       data.isolate(), data.GetHandle(), pipe_size);
+}
+
+void ElectronURLLoaderFactory::StartLoadingDirectory(
+    mojo::PendingReceiver<network::mojom::URLLoader> loader,
+    const network::ResourceRequest& request,
+    mojo::PendingRemote<network::mojom::URLLoaderClient> client) {
+  std::string host, url_path;
+  GetHostAndPath(request.url, &host, &url_path);
+  auto root = roots_.find(host);
+  if (root == roots_.end())
+    root = roots_.find(std::string());
+
+  base::FilePath path;
+  if (root == roots_.end() ||
+      !GetFilePathUnderRoot(root->second, url_path, &path)) {
+    mojo::Remote<network::mojom::URLLoaderClient> client_remote(
+        std::move(client));
+    client_remote->OnComplete(
+        network::URLLoaderCompletionStatus(net::ERR_FILE_NOT_FOUND));
+    return;
+  }
+
+  // The file is read and its MIME type detected on a background sequence.
+  auto headers = base::MakeRefCounted<net::HttpResponseHeaders>(
+      "HTTP/1.1 200 OK");
+  headers->AddHeader(kCORSHeader);
+  asar::CreateAsarFileURLLoader(path, request, std::move(loader),
+                                std::move(client), std::move(headers));
 }
 
 // static
 void ElectronURLLoaderFactory::SendContents(
     mojo::PendingRemote<network::mojom::URLLoaderClient> client,
     network::ResourceResponseHead head,
-    std::string data) {
+    scoped_refptr<base::RefCountedMemory> data) {
   mojo::Remote<network::mojom::URLLoaderClient> client_remote(
       std::move(client));
   head.headers->AddHeader(kCORSHeader);
   client_remote->OnReceiveResponse(head);
 
-  // Code bellow follows the pattern of data_url_loader_factory.cc.
+  // Code bellow follows the pattern of data_url_loader_factory.cc, with the
+  // pipe sized after the response instead of the default 64KB.
+  MojoCreateDataPipeOptions options;
+  options.struct_size = sizeof(MojoCreateDataPipeOptions);
+  options.flags = MOJO_CREATE_DATA_PIPE_FLAG_NONE;
+  options.element_num_bytes = 1;
+  // Zero picks the default size.
+  options.capacity_num_bytes =
+      static_cast<uint32_t>(std::min<size_t>(data->size(), kMaxDataPipeSize));
   mojo::ScopedDataPipeProducerHandle producer;
   mojo::ScopedDataPipeConsumerHandle consumer;
-  if (mojo::CreateDataPipe(nullptr, &producer, &consumer) != MOJO_RESULT_OK) {
+  if (mojo::CreateDataPipe(&options, &producer, &consumer) != MOJO_RESULT_OK) {
     client_remote->OnComplete(
         network::URLLoaderCompletionStatus(net::ERR_INSUFFICIENT_RESOURCES));
     return;
@@ -504,7 +684,8 @@ void ElectronURLLoaderFactory::SendContents(
   write_data->producer =
       std::make_unique<mojo::DataPipeProducer>(std::move(producer));
 
-  base::StringPiece string_piece(write_data->data);
+  base::StringPiece string_piece(write_data->data->front_as<char>(),
+                                 write_data->data->size());
   write_data->producer->Write(
       std::make_unique<mojo::StringDataSource>(
           string_piece, mojo::StringDataSource::AsyncWritingMode::
@@ -9,6 +9,8 @@
 #include <string>
 #include <utility>
 
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted_memory.h"
 #include "mojo/public/cpp/bindings/pending_receiver.h"
 #include "mojo/public/cpp/bindings/pending_remote.h"
 #include "mojo/public/cpp/bindings/receiver_set.h"
@@ -16,6 +18,7 @@
 #include "net/url_request/url_request_job_factory.h"
 #include "services/network/public/cpp/resource_response.h"
 #include "services/network/public/mojom/url_loader_factory.mojom.h"
+#include "shell/browser/net/protocol_response_cache.h"
 #include "shell/common/gin_helper/dictionary.h"
 
 namespace electron {
@@ -28,6 +31,8 @@ enum class ProtocolType {
   kHttp,
   kStream,
   kFree,  // special type for returning arbitrary type of response.
+  // Files served from a directory, without calling a JS handler.
+  kDirectory,
 };
 
 using StartLoadingCallback = base::OnceCallback<void(gin::Arguments*)>;
@@ -38,10 +43,18 @@ using ProtocolHandler =
 using HandlersMap =
     std::map<std::string, std::pair<ProtocolType, ProtocolHandler>>;
 
+// host => root directory or asar archive, where an empty host matches all the
+// hosts without a root of their own.
+using DirectoryRoots = std::map<std::string, base::FilePath>;
+
 // Implementation of URLLoaderFactory.
 class ElectronURLLoaderFactory : public network::mojom::URLLoaderFactory {
  public:
-  ElectronURLLoaderFactory(ProtocolType type, const ProtocolHandler& handler);
+  ElectronURLLoaderFactory(ProtocolType type,
+                           const ProtocolHandler& handler,
+                           scoped_refptr<ProtocolResponseCache> cache);
+  // Creates a factory of ProtocolType::kDirectory.
+  explicit ElectronURLLoaderFactory(const DirectoryRoots& roots);
   ~ElectronURLLoaderFactory() override;
 
   // network::mojom::URLLoaderFactory:
@@ -66,17 +79,22 @@ class ElectronURLLoaderFactory : public network::mojom::URLLoaderFactory {
       mojo::PendingRemote<network::mojom::URLLoaderClient> client,
       const net::MutableNetworkTrafficAnnotationTag& traffic_annotation,
       network::mojom::URLLoaderFactory* proxy_factory,
+      scoped_refptr<ProtocolResponseCache> cache,
       ProtocolType type,
       gin::Arguments* args);
 
  private:
   static void StartLoadingBuffer(
+      const network::ResourceRequest& request,
       mojo::PendingRemote<network::mojom::URLLoaderClient> client,
       network::ResourceResponseHead head,
+      ProtocolResponseCache* cache,
       const gin_helper::Dictionary& dict);
   static void StartLoadingString(
+      const network::ResourceRequest& request,
       mojo::PendingRemote<network::mojom::URLLoaderClient> client,
       network::ResourceResponseHead head,
+      ProtocolResponseCache* cache,
       const gin_helper::Dictionary& dict,
       v8::Isolate* isolate,
       v8::Local<v8::Value> response);
@@ -100,11 +118,18 @@ class ElectronURLLoaderFactory : public network::mojom::URLLoaderFactory {
       network::ResourceResponseHead head,
       const gin_helper::Dictionary& dict);
 
-  // Helper to send string as response.
+  // Serves the file |request| maps to under |roots_|.
+  void StartLoadingDirectory(
+      mojo::PendingReceiver<network::mojom::URLLoader> loader,
+      const network::ResourceRequest& request,
+      mojo::PendingRemote<network::mojom::URLLoaderClient> client);
+
+  // Helper to send |data| as response, which is read while it is written to
+  // the data pipe and released afterwards.
   static void SendContents(
       mojo::PendingRemote<network::mojom::URLLoaderClient> client,
       network::ResourceResponseHead head,
-      std::string data);
+      scoped_refptr<base::RefCountedMemory> data);
 
   // TODO(zcbenz): This comes from extensions/browser/extension_protocols.cc
   // but I don't know what it actually does, find out the meanings of |Clone|
@@ -113,6 +138,10 @@ class ElectronURLLoaderFactory : public network::mojom::URLLoaderFactory {
 
   ProtocolType type_;
   ProtocolHandler handler_;
+  // Shared by the factories of the scheme, it is disabled unless the app
+  // opts in.
+  scoped_refptr<ProtocolResponseCache> cache_;
+  DirectoryRoots roots_;
 
   DISALLOW_COPY_AND_ASSIGN(ElectronURLLoaderFactory);
 };
@@ -6,7 +6,8 @@
 
 #include <utility>
 
-#include "mojo/public/cpp/system/string_data_source.h"
+#include "base/numerics/safe_conversions.h"
+#include "base/threading/sequenced_task_runner_handle.h"
 #include "shell/common/gin_converters/callback_converter.h"
 #include "shell/common/node_includes.h"
 
@@ -17,17 +18,21 @@ NodeStreamLoader::NodeStreamLoader(
     network::mojom::URLLoaderRequest loader,
     mojo::PendingRemote<network::mojom::URLLoaderClient> client,
     v8::Isolate* isolate,
-    v8::Local<v8::Object> emitter)
+    v8::Local<v8::Object> emitter,
+    uint32_t pipe_size)
     : binding_(this, std::move(loader)),
       client_(std::move(client)),
       isolate_(isolate),
       emitter_(isolate, emitter),
+      handle_watcher_(FROM_HERE,
+                      mojo::SimpleWatcher::ArmingPolicy::MANUAL,
+                      base::SequencedTaskRunnerHandle::Get()),
       weak_factory_(this) {
   binding_.set_connection_error_handler(
       base::BindOnce(&NodeStreamLoader::NotifyComplete,
                      weak_factory_.GetWeakPtr(), net::ERR_FAILED));
 
-  Start(std::move(head));
+  Start(std::move(head), pipe_size);
 }
 
 NodeStreamLoader::~NodeStreamLoader() {
@@ -50,20 +55,27 @@ NodeStreamLoader::~NodeStreamLoader() {
   }
 }
 
-void NodeStreamLoader::Start(network::ResourceResponseHead head) {
-  mojo::ScopedDataPipeProducerHandle producer;
+void NodeStreamLoader::Start(network::ResourceResponseHead head,
+                             uint32_t pipe_size) {
+  MojoCreateDataPipeOptions options;
+  options.struct_size = sizeof(MojoCreateDataPipeOptions);
+  options.flags = MOJO_CREATE_DATA_PIPE_FLAG_NONE;
+  options.element_num_bytes = 1;
+  options.capacity_num_bytes = pipe_size;
   mojo::ScopedDataPipeConsumerHandle consumer;
-  MojoResult rv = mojo::CreateDataPipe(nullptr, &producer, &consumer);
+  MojoResult rv = mojo::CreateDataPipe(&options, &producer_, &consumer);
   if (rv != MOJO_RESULT_OK) {
     NotifyComplete(net::ERR_INSUFFICIENT_RESOURCES);
     return;
   }
 
-  producer_ = std::make_unique<mojo::DataPipeProducer>(std::move(producer));
   client_->OnReceiveResponse(head);
   client_->OnStartLoadingResponseBody(std::move(consumer));
 
   auto weak = weak_factory_.GetWeakPtr();
+  handle_watcher_.Watch(
+      producer_.get(), MOJO_HANDLE_SIGNAL_WRITABLE,
+      base::BindRepeating(&NodeStreamLoader::OnHandleWritable, weak));
   On("end",
      base::BindRepeating(&NodeStreamLoader::NotifyComplete, weak, net::OK));
   On("error", base::BindRepeating(&NodeStreamLoader::NotifyComplete, weak,
@@ -72,11 +84,15 @@ void NodeStreamLoader::Start(network::ResourceResponseHead head) {
 }
 
 void NodeStreamLoader::NotifyReadable() {
-  if (!readable_)
+  // The flag is set before reading, as ReadMore clears it once the stream is
+  // drained. While the pipe is full or the client paused, the reading resumes
+  // by itself later.
+  if (!readable_) {
+    readable_ = true;
     ReadMore();
-  else if (is_reading_)
+  } else if (is_reading_) {
     has_read_waiting_ = true;
-  readable_ = true;
+  }
 }
 
 void NodeStreamLoader::NotifyComplete(int result) {
@@ -92,64 +108,113 @@ void NodeStreamLoader::NotifyComplete(int result) {
 }
 
 void NodeStreamLoader::ReadMore() {
-  if (is_reading_) {
+  if (is_reading_ || is_writing_) {
     // Calling read() can trigger the "readable" event again, making this
     // function re-entrant. If we're already reading, we don't want to start
-    // a nested read, so short-circuit.
+    // a nested read, so short-circuit. The reading also resumes by itself
+    // once the pipe has room.
     return;
   }
   is_reading_ = true;
   auto weak = weak_factory_.GetWeakPtr();
-  // buffer = emitter.read()
-  v8::MaybeLocal<v8::Value> ret = node::MakeCallback(
-      isolate_, emitter_.Get(isolate_), "read", 0, nullptr, {0, 0});
-  DCHECK(weak) << "We shouldn't have been destroyed when calling read()";
-
-  // If there is no buffer read, wait until |readable| is emitted again.
-  v8::Local<v8::Value> buffer;
-  if (!ret.ToLocal(&buffer) || !node::Buffer::HasInstance(buffer)) {
-    is_reading_ = false;
-
-    // If 'readable' was called after 'read()', try again
-    if (has_read_waiting_) {
-      has_read_waiting_ = false;
-      ReadMore();
-      return;
+
+  // Copy the chunks buffered in the stream until the pipe is full, so that a
+  // stream of small chunks does not wait for the pipe after each of them.
+  for (;;) {
+    if (!buffer_.IsEmpty()) {
+      MojoResult result = WriteBuffer();
+      if (result == MOJO_RESULT_SHOULD_WAIT) {
+        // Stop reading until the pipe has room, the data is left in the
+        // stream meanwhile so it can apply backpressure to its source.
+        is_reading_ = false;
+        is_writing_ = true;
+        handle_watcher_.ArmOrNotify();
+        return;
+      } else if (result != MOJO_RESULT_OK) {
+        is_reading_ = false;
+        NotifyComplete(net::ERR_FAILED);
+        return;
+      }
     }
 
-    readable_ = false;
-    if (ended_) {
-      NotifyComplete(result_);
+    // Data that was already read is still written while paused.
+    if (ended_ || is_paused_)
+      break;
+
+    // buffer = emitter.read()
+    v8::MaybeLocal<v8::Value> ret = node::MakeCallback(
+        isolate_, emitter_.Get(isolate_), "read", 0, nullptr, {0, 0});
+    DCHECK(weak) << "We shouldn't have been destroyed when calling read()";
+
+    // If there is no buffer read, wait until |readable| is emitted again.
+    v8::Local<v8::Value> buffer;
+    if (!ret.ToLocal(&buffer) || !node::Buffer::HasInstance(buffer)) {
+      // If 'readable' was called after 'read()', try again
+      if (has_read_waiting_) {
+        has_read_waiting_ = false;
+        continue;
+      }
+      readable_ = false;
+      break;
     }
-    return;
-  }
 
-  // Hold the buffer until the write is done.
-  buffer_.Reset(isolate_, buffer);
+    buffer_.Reset(isolate_, buffer);
+    buffer_offset_ = 0;
+  }
 
-  // Write buffer to mojo pipe asyncronously.
   is_reading_ = false;
-  is_writing_ = true;
-  producer_->Write(std::make_unique<mojo::StringDataSource>(
-                       base::StringPiece(node::Buffer::Data(buffer),
-                                         node::Buffer::Length(buffer)),
-                       mojo::StringDataSource::AsyncWritingMode::
-                           STRING_STAYS_VALID_UNTIL_COMPLETION),
-                   base::BindOnce(&NodeStreamLoader::DidWrite, weak));
+  if (ended_)
+    NotifyComplete(result_);
 }
 
-void NodeStreamLoader::DidWrite(MojoResult result) {
+MojoResult NodeStreamLoader::WriteBuffer() {
+  v8::Local<v8::Value> buffer = buffer_.Get(isolate_);
+  size_t length = node::Buffer::Length(buffer) - buffer_offset_;
+  if (length == 0) {
+    buffer_.Reset();
+    return MOJO_RESULT_OK;
+  }
+  uint32_t num_bytes = base::saturated_cast<uint32_t>(length);
+  MojoResult result =
+      producer_->WriteData(node::Buffer::Data(buffer) + buffer_offset_,
+                           &num_bytes, MOJO_WRITE_DATA_FLAG_NONE);
+  if (result != MOJO_RESULT_OK)
+    return result;
+  buffer_offset_ += num_bytes;
+  if (num_bytes < length)
+    return MOJO_RESULT_SHOULD_WAIT;
+  buffer_.Reset();
+  return MOJO_RESULT_OK;
+}
+
+void NodeStreamLoader::OnHandleWritable(MojoResult result) {
   is_writing_ = false;
-  // We were told to end streaming.
-  if (ended_) {
-    NotifyComplete(result_);
+  if (result != MOJO_RESULT_OK) {
+    // The consumer went away.
+    NotifyComplete(net::ERR_FAILED);
     return;
   }
 
-  if (result == MOJO_RESULT_OK && readable_)
+  v8::Locker locker(isolate_);
+  v8::Isolate::Scope isolate_scope(isolate_);
+  v8::HandleScope handle_scope(isolate_);
+  ReadMore();
+}
+
+void NodeStreamLoader::PauseReadingBodyFromNet() {
+  is_paused_ = true;
+}
+
+void NodeStreamLoader::ResumeReadingBodyFromNet() {
+  if (!is_paused_)
+    return;
+  is_paused_ = false;
+  if (readable_) {
+    v8::Locker locker(isolate_);
+    v8::Isolate::Scope isolate_scope(isolate_);
+    v8::HandleScope handle_scope(isolate_);
     ReadMore();
-  else
-    NotifyComplete(net::ERR_FAILED);
+  }
 }
 
 void NodeStreamLoader::On(const char* event, EventCallback callback) {
@@ -13,7 +13,8 @@
 #include "mojo/public/cpp/bindings/pending_remote.h"
 #include "mojo/public/cpp/bindings/remote.h"
 #include "mojo/public/cpp/bindings/strong_binding.h"
-#include "mojo/public/cpp/system/data_pipe_producer.h"
+#include "mojo/public/cpp/system/data_pipe.h"
+#include "mojo/public/cpp/system/simple_watcher.h"
 #include "services/network/public/cpp/resource_response.h"
 #include "services/network/public/mojom/url_loader.mojom.h"
 #include "v8/include/v8.h"
@@ -25,27 +26,33 @@ namespace electron {
 // This class manages its own lifetime and should delete itself when the
 // connection is lost or finished.
 //
-// We use |paused mode| to read data from |Readable| stream, so we don't need to
-// copy data from buffer and hold it in memory, and we only need to make sure
-// the passed |Buffer| is alive while writing data to pipe.
+// We use |paused mode| to read data from |Readable| stream, and copy as many
+// of the buffered chunks as fit into the data pipe each time it has room, so
+// that we only need to hold the |Buffer| that did not fit. The stream is not
+// read while the pipe is full, which lets its own backpressure pause the
+// source of the data.
 class NodeStreamLoader : public network::mojom::URLLoader {
  public:
   NodeStreamLoader(network::ResourceResponseHead head,
                    network::mojom::URLLoaderRequest loader,
                    mojo::PendingRemote<network::mojom::URLLoaderClient> client,
                    v8::Isolate* isolate,
-                   v8::Local<v8::Object> emitter);
+                   v8::Local<v8::Object> emitter,
+                   uint32_t pipe_size);
 
  private:
   ~NodeStreamLoader() override;
 
   using EventCallback = base::RepeatingCallback<void()>;
 
-  void Start(network::ResourceResponseHead head);
+  void Start(network::ResourceResponseHead head, uint32_t pipe_size);
   void NotifyReadable();
   void NotifyComplete(int result);
   void ReadMore();
-  void DidWrite(MojoResult result);
+  // Writes what the pipe can take of |buffer_|, and releases it once it has
+  // been written entirely.
+  MojoResult WriteBuffer();
+  void OnHandleWritable(MojoResult result);
 
   // Subscribe to events of |emitter|.
   void On(const char* event, EventCallback callback);
@@ -56,22 +63,30 @@ class NodeStreamLoader : public network::mojom::URLLoader {
                       const base::Optional<GURL>& new_url) override {}
   void SetPriority(net::RequestPriority priority,
                    int32_t intra_priority_value) override {}
-  void PauseReadingBodyFromNet() override {}
-  void ResumeReadingBodyFromNet() override {}
+  void PauseReadingBodyFromNet() override;
+  void ResumeReadingBodyFromNet() override;
 
   mojo::Binding<network::mojom::URLLoader> binding_;
   mojo::Remote<network::mojom::URLLoaderClient> client_;
 
   v8::Isolate* isolate_;
   v8::Global<v8::Object> emitter_;
+
+  // The chunk that did not fit in the pipe, and how much of it was written.
   v8::Global<v8::Value> buffer_;
+  size_t buffer_offset_ = 0;
 
-  // Mojo data pipe where the data that is being read is written to.
-  std::unique_ptr<mojo::DataPipeProducer> producer_;
+  // Mojo data pipe where the data that is being read is written to, and the
+  // watcher telling when it has room again.
+  mojo::ScopedDataPipeProducerHandle producer_;
+  mojo::SimpleWatcher handle_watcher_;
 
-  // Whether we are in the middle of write.
+  // Whether we are waiting for room in the pipe to write |buffer_|.
   bool is_writing_ = false;
 
+  // Whether the client asked to stop reading the body for now.
+  bool is_paused_ = false;
+
   // Whether we are in the middle of a stream.read().
   bool is_reading_ = false;
 
@@ -0,0 +1,161 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/protocol_response_cache.h"
+
+#include <iterator>
+#include <utility>
+
+#include "net/base/load_flags.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_status_code.h"
+
+namespace electron {
+
+namespace {
+
+// Requests with these flags are not answered from the cache, but their
+// responses are still stored.
+const int kSkipCacheLoadFlags =
+    net::LOAD_BYPASS_CACHE | net::LOAD_VALIDATE_CACHE;
+
+// Returns a copy of |headers|, since the ones of a response are modified
+// while it is being sent.
+scoped_refptr<net::HttpResponseHeaders> CloneHeaders(
+    const net::HttpResponseHeaders& headers) {
+  return base::MakeRefCounted<net::HttpResponseHeaders>(headers.raw_headers());
+}
+
+}  // namespace
+
+ProtocolResponseCache::Entry::Entry() = default;
+
+ProtocolResponseCache::Entry::Entry(Entry&&) = default;
+
+ProtocolResponseCache::Entry::~Entry() = default;
+
+ProtocolResponseCache::ProtocolResponseCache()
+    : entries_(EntryCache::NO_AUTO_EVICT) {}
+
+ProtocolResponseCache::~ProtocolResponseCache() = default;
+
+void ProtocolResponseCache::Enable(size_t max_size) {
+  max_size_ = max_size;
+  while (size_ > max_size_)
+    Erase(std::prev(entries_.end()));
+}
+
+void ProtocolResponseCache::Disable() {
+  max_size_ = 0;
+  entries_.Clear();
+  size_ = 0;
+}
+
+bool ProtocolResponseCache::Get(const network::ResourceRequest& request,
+                                network::ResourceResponseHead* head,
+                                scoped_refptr<base::RefCountedMemory>* data) {
+  if (!enabled() || !IsCacheableRequest(request))
+    return false;
+
+  auto it = entries_.end();
+  if (!(request.load_flags & kSkipCacheLoadFlags))
+    it = entries_.Get(request.url.spec());
+  if (it == entries_.end()) {
+    miss_count_++;
+    return false;
+  }
+
+  const Entry& entry = it->second;
+  if (base::TimeTicks::Now() >= entry.expiry) {
+    Erase(it);
+    miss_count_++;
+    return false;
+  }
+  for (const auto& vary_header : entry.vary_headers.DictItems()) {
+    std::string value;
+    bool has_value = request.headers.GetHeader(vary_header.first, &value);
+    bool matches = vary_header.second.is_none()
+                       ? !has_value
+                       : has_value && vary_header.second.GetString() == value;
+    if (!matches) {
+      miss_count_++;
+      return false;
+    }
+  }
+
+  hit_count_++;
+  *head = entry.head;
+  head->headers = CloneHeaders(*entry.head.headers);
+  *data = entry.data;
+  return true;
+}
+
+void ProtocolResponseCache::Put(const network::ResourceRequest& request,
+                                const network::ResourceResponseHead& head,
+                                scoped_refptr<base::RefCountedMemory> data) {
+  if (!enabled() || !IsCacheableRequest(request) || data->size() > max_size_)
+    return;
+
+  const net::HttpResponseHeaders& headers = *head.headers;
+  if (headers.response_code() != net::HTTP_OK)
+    return;
+  // No freshness lifetime is given to "no-cache" and "no-store" responses.
+  base::TimeDelta lifetime =
+      headers.GetFreshnessLifetimes(base::Time::Now()).freshness;
+  if (lifetime <= base::TimeDelta())
+    return;
+
+  Entry entry;
+  entry.vary_headers = base::Value(base::Value::Type::DICTIONARY);
+  size_t iter = 0;
+  std::string name;
+  while (headers.EnumerateHeader(&iter, "vary", &name)) {
+    if (name == "*")
+      return;
+    std::string value;
+    if (request.headers.GetHeader(name, &value))
+      entry.vary_headers.SetStringKey(name, value);
+    else
+      entry.vary_headers.SetKey(name, base::Value());
+  }
+  entry.head = head;
+  entry.head.headers = CloneHeaders(headers);
+  entry.data = std::move(data);
+  entry.expiry = base::TimeTicks::Now() + lifetime;
+
+  const std::string key = request.url.spec();
+  auto it = entries_.Peek(key);
+  if (it != entries_.end())
+    Erase(it);
+  size_ += entry.data->size();
+  entries_.Put(key, std::move(entry));
+  while (size_ > max_size_)
+    Erase(std::prev(entries_.end()));
+}
+
+base::Value ProtocolResponseCache::GetStats() const {
+  base::Value stats(base::Value::Type::DICTIONARY);
+  stats.SetDoubleKey("hits", hit_count_);
+  stats.SetDoubleKey("misses", miss_count_);
+  stats.SetDoubleKey("count", entries_.size());
+  stats.SetDoubleKey("size", size_);
+  stats.SetDoubleKey("maxSize", max_size_);
+  return stats;
+}
+
+// static
+bool ProtocolResponseCache::IsCacheableRequest(
+    const network::ResourceRequest& request) {
+  return request.method == net::HttpRequestHeaders::kGetMethod &&
+         !(request.load_flags & net::LOAD_DISABLE_CACHE) &&
+         !request.headers.HasHeader(net::HttpRequestHeaders::kRange);
+}
+
+void ProtocolResponseCache::Erase(EntryCache::iterator it) {
+  size_ -= it->second.data->size();
+  entries_.Erase(it);
+}
+
+}  // namespace electron
@@ -0,0 +1,97 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
+#define SHELL_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "services/network/public/cpp/resource_request.h"
+#include "services/network/public/cpp/resource_response.h"
+
+namespace electron {
+
+// In-memory cache of the Buffer and String responses of a registered scheme,
+// so that requests for immutable content can be answered without calling
+// the JS handler again.
+//
+// Only successful GET responses with a freshness lifetime given by their
+// Cache-Control or Expires headers are stored, and they are served until
+// that lifetime expires. Requests that vary on request headers are matched
+// against the headers of the request the response was stored for.
+//
+// The cache is shared by all the URLLoaderFactories created for the scheme
+// and must only be used on the UI thread.
+class ProtocolResponseCache : public base::RefCounted<ProtocolResponseCache> {
+ public:
+  ProtocolResponseCache();
+
+  // Starts caching responses, up to |max_size| bytes of response bodies.
+  void Enable(size_t max_size);
+  // Stops caching responses and drops the cached ones.
+  void Disable();
+  bool enabled() const { return max_size_ > 0; }
+
+  // Returns whether a response is cached for |request|, filling |head| and
+  // |data| with it.
+  bool Get(const network::ResourceRequest& request,
+           network::ResourceResponseHead* head,
+           scoped_refptr<base::RefCountedMemory>* data);
+
+  // Stores the response to |request| if it can be cached.
+  void Put(const network::ResourceRequest& request,
+           const network::ResourceResponseHead& head,
+           scoped_refptr<base::RefCountedMemory> data);
+
+  // Returns the hit and miss counts and the size of the cache.
+  base::Value GetStats() const;
+
+ private:
+  friend class base::RefCounted<ProtocolResponseCache>;
+
+  struct Entry {
+    Entry();
+    Entry(Entry&&);
+    ~Entry();
+
+    network::ResourceResponseHead head;
+    scoped_refptr<base::RefCountedMemory> data;
+    base::TimeTicks expiry;
+    // Values of the request headers named by the Vary header of the
+    // response, where an absent header is kept as null.
+    base::Value vary_headers;
+
+    DISALLOW_COPY_AND_ASSIGN(Entry);
+  };
+
+  // Entries are keyed by URL and evicted in least recently used order.
+  using EntryCache = base::MRUCache<std::string, Entry>;
+
+  ~ProtocolResponseCache();
+
+  // Returns whether |request| may be answered from the cache, or its
+  // response stored into it.
+  static bool IsCacheableRequest(const network::ResourceRequest& request);
+
+  void Erase(EntryCache::iterator it);
+
+  EntryCache entries_;
+  size_t max_size_ = 0;
+  size_t size_ = 0;
+  uint64_t hit_count_ = 0;
+  uint64_t miss_count_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(ProtocolResponseCache);
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
@@ -735,7 +735,8 @@ void ProxyingURLLoaderFactory::CreateLoaderAndStart(
         request, base::BindOnce(&ElectronURLLoaderFactory::StartLoading,
                                 std::move(loader), routing_id, request_id,
                                 options, request, std::move(client),
-                                traffic_annotation, this, it->second.first));
+                                traffic_annotation, this, nullptr,
+                                it->second.first));
     return;
   }
 
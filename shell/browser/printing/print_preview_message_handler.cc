@@ -8,9 +8,11 @@
 #include <utility>
 
 #include "base/bind.h"
+#include "base/files/file_util.h"
 #include "base/memory/read_only_shared_memory_region.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/ref_counted_memory.h"
+#include "base/numerics/safe_conversions.h"
 #include "base/task/post_task.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/printing/print_job_manager.h"
@@ -48,6 +50,28 @@ void StopWorker(int document_cookie) {
   }
 }
 
+bool WritePdfFile(const base::FilePath& path,
+                  scoped_refptr<base::RefCountedMemory> data) {
+  if (!base::IsValueInRangeForNumericType<int>(data->size()))
+    return false;
+  int size = static_cast<int>(data->size());
+  return base::WriteFile(path, data->front_as<char>(), size) == size;
+}
+
+void OnPdfFileWritten(util::Promise<v8::Local<v8::Value>> promise,
+                      int page_count,
+                      bool success) {
+  if (!success) {
+    promise.RejectWithErrorMessage("Failed to write PDF file");
+    return;
+  }
+
+  v8::Isolate* isolate = promise.isolate();
+  mate::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  promise.Resolve(v8::Integer::New(isolate, page_count));
+}
+
 }  // namespace
 
 PrintPreviewMessageHandler::PrintPreviewMessageHandler(
@@ -95,6 +119,10 @@ void PrintPreviewMessageHandler::OnMetafileReadyForPrinting(
     return;
   }
 
+  auto it = output_files_.find(ids.request_id);
+  if (it != output_files_.end())
+    it->second.page_count = params.expected_pages_count;
+
   if (printing::IsOopifEnabled()) {
     auto* client =
         printing::PrintCompositeClient::FromWebContents(web_contents());
@@ -151,10 +179,13 @@ void PrintPreviewMessageHandler::OnPrintPreviewCancelled(
 
 void PrintPreviewMessageHandler::PrintToPDF(
     const base::DictionaryValue& options,
+    const base::FilePath& output_path,
     electron::util::Promise<v8::Local<v8::Value>> promise) {
   int request_id;
   options.GetInteger(printing::kPreviewRequestID, &request_id);
   promise_map_.emplace(request_id, std::move(promise));
+  if (!output_path.empty())
+    output_files_[request_id].path = output_path;
 
   auto* focused_frame = web_contents()->GetFocusedFrame();
   auto* rfh = focused_frame && focused_frame->HasSelection()
@@ -181,15 +212,32 @@ void PrintPreviewMessageHandler::ResolvePromise(
 
   util::Promise<v8::Local<v8::Value>> promise = GetPromise(request_id);
 
+  // Write the PDF without it ever entering the JS heap.
+  auto it = output_files_.find(request_id);
+  if (it != output_files_.end()) {
+    OutputFile file = it->second;
+    output_files_.erase(it);
+    base::PostTaskAndReplyWithResult(
+        FROM_HERE,
+        {base::ThreadPool(), base::MayBlock(),
+         base::TaskPriority::USER_VISIBLE},
+        base::BindOnce(&WritePdfFile, file.path, std::move(data_bytes)),
+        base::BindOnce(&OnPdfFileWritten, std::move(promise),
+                       file.page_count));
+    return;
+  }
+
   v8::Isolate* isolate = promise.isolate();
   mate::Locker locker(isolate);
   v8::HandleScope handle_scope(isolate);
   v8::Context::Scope context_scope(
       v8::Local<v8::Context>::New(isolate, promise.GetContext()));
 
+  // The PDF is mapped read-only, while the Buffer must be writable, and V8
+  // has no read-only or copy-on-write ArrayBuffers. Callers that can not
+  // afford the copy pass an output path instead.
   v8::Local<v8::Value> buffer =
-      node::Buffer::Copy(isolate,
-                         reinterpret_cast<const char*>(data_bytes->front()),
+      node::Buffer::Copy(isolate, data_bytes->front_as<char>(),
                          data_bytes->size())
           .ToLocalChecked();
 
@@ -200,6 +248,7 @@ void PrintPreviewMessageHandler::RejectPromise(int request_id) {
   DCHECK_CURRENTLY_ON(BrowserThread::UI);
 
   util::Promise<v8::Local<v8::Value>> promise = GetPromise(request_id);
+  output_files_.erase(request_id);
   promise.RejectWithErrorMessage("Failed to generate PDF");
 }
 
@@ -7,6 +7,7 @@
 
 #include <map>
 
+#include "base/files/file_path.h"
 #include "base/memory/ref_counted_memory.h"
 #include "base/memory/weak_ptr.h"
 #include "components/services/pdf_compositor/public/mojom/pdf_compositor.mojom.h"
@@ -31,7 +32,10 @@ class PrintPreviewMessageHandler
  public:
   ~PrintPreviewMessageHandler() override;
 
+  // Resolves |promise| with the PDF, or writes it to |output_path| when it is
+  // not empty and resolves |promise| with its page count.
   void PrintToPDF(const base::DictionaryValue& options,
+                  const base::FilePath& output_path,
                   util::Promise<v8::Local<v8::Value>> promise);
 
  protected:
@@ -65,6 +69,12 @@ class PrintPreviewMessageHandler
   using PromiseMap =
       std::map<int, electron::util::Promise<v8::Local<v8::Value>>>;
   PromiseMap promise_map_;
+  struct OutputFile {
+    base::FilePath path;
+    int page_count = 0;
+  };
+  // request id => file the PDF is written to.
+  std::map<int, OutputFile> output_files_;
 
   base::WeakPtrFactory<PrintPreviewMessageHandler> weak_ptr_factory_;
 
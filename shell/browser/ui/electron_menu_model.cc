@@ -4,6 +4,7 @@
 
 #include "shell/browser/ui/electron_menu_model.h"
 
+#include "base/no_destructor.h"
 #include "base/stl_util.h"
 
 namespace electron {
@@ -14,6 +15,12 @@ bool ElectronMenuModel::Delegate::GetAcceleratorForCommandId(
   return GetAcceleratorForCommandIdWithParams(command_id, false, accelerator);
 }
 
+ElectronMenuModel::CommandState::CommandState() = default;
+
+ElectronMenuModel::CommandState::CommandState(const CommandState&) = default;
+
+ElectronMenuModel::CommandState::~CommandState() = default;
+
 ElectronMenuModel::ElectronMenuModel(Delegate* delegate)
     : ui::SimpleMenuModel(delegate), delegate_(delegate) {}
 
@@ -78,6 +85,20 @@ bool ElectronMenuModel::WorksWhenHiddenAt(int index) const {
   return true;
 }
 
+void ElectronMenuModel::SetCommandState(int command_id,
+                                        const CommandState& state) {
+  command_states_[command_id] = state;
+}
+
+const ElectronMenuModel::CommandState& ElectronMenuModel::GetCommandState(
+    int command_id) const {
+  const auto iter = command_states_.find(command_id);
+  if (iter != std::end(command_states_))
+    return iter->second;
+  static const base::NoDestructor<CommandState> default_state;
+  return *default_state;
+}
+
 void ElectronMenuModel::MenuWillClose() {
   ui::SimpleMenuModel::MenuWillClose();
   for (Observer& observer : observers_) {
@@ -10,6 +10,8 @@
 #include "base/memory/weak_ptr.h"
 #include "base/observer_list.h"
 #include "base/observer_list_types.h"
+#include "base/optional.h"
+#include "ui/base/accelerators/accelerator.h"
 #include "ui/base/models/simple_menu_model.h"
 
 namespace electron {
@@ -48,6 +50,23 @@ class ElectronMenuModel : public ui::SimpleMenuModel {
     virtual void OnMenuWillClose() {}
   };
 
+  // State of a command that the platform menus query while they are shown,
+  // kept here so that answering them does not call into JS.
+  struct CommandState {
+    CommandState();
+    CommandState(const CommandState&);
+    ~CommandState();
+
+    bool checked = false;
+    bool enabled = true;
+    bool visible = true;
+    bool works_when_hidden = true;
+    bool register_accelerator = true;
+    base::Optional<ui::Accelerator> accelerator;
+    // Used when |accelerator| is not set and the default one is asked for.
+    base::Optional<ui::Accelerator> default_accelerator;
+  };
+
   explicit ElectronMenuModel(Delegate* delegate);
   ~ElectronMenuModel() override;
 
@@ -65,6 +84,8 @@ class ElectronMenuModel : public ui::SimpleMenuModel {
                                   ui::Accelerator* accelerator) const;
   bool ShouldRegisterAcceleratorAt(int index) const;
   bool WorksWhenHiddenAt(int index) const;
+  void SetCommandState(int command_id, const CommandState& state);
+  const CommandState& GetCommandState(int command_id) const;
 
   // ui::SimpleMenuModel:
   void MenuWillClose() override;
@@ -80,9 +101,10 @@ class ElectronMenuModel : public ui::SimpleMenuModel {
  private:
   Delegate* delegate_;  // weak ref.
 
-  std::map<int, base::string16> toolTips_;   // command id -> tooltip
-  std::map<int, base::string16> roles_;      // command id -> role
-  std::map<int, base::string16> sublabels_;  // command id -> sublabel
+  std::map<int, base::string16> toolTips_;      // command id -> tooltip
+  std::map<int, base::string16> roles_;         // command id -> role
+  std::map<int, base::string16> sublabels_;     // command id -> sublabel
+  std::map<int, CommandState> command_states_;  // command id -> state
   base::ObserverList<Observer> observers_;
 
   base::WeakPtrFactory<ElectronMenuModel> weak_factory_{this};
@@ -71,6 +71,10 @@ const char kDevToolsBoundsPref[] = "electron.devtools.bounds";
 const char kDevToolsZoomPref[] = "electron.devtools.zoom";
 const char kDevToolsPreferences[] = "electron.devtools.preferences";
 
+// How long devtools bounds changes are held before being written to prefs.
+constexpr base::TimeDelta kDevToolsBoundsWriteDelay =
+    base::TimeDelta::FromSeconds(1);
+
 const char kFrontendHostId[] = "id";
 const char kFrontendHostMethod[] = "method";
 const char kFrontendHostParams[] = "params";
@@ -363,6 +367,8 @@ InspectableWebContentsImpl::InspectableWebContentsImpl(
 
 InspectableWebContentsImpl::~InspectableWebContentsImpl() {
   g_web_contents_instances_.remove(this);
+  if (save_bounds_timer_.IsRunning())
+    CommitDevToolsBounds();
   // Unsubscribe from devtools and Clean up resources.
   if (GetDevToolsWebContents()) {
     if (managed_devtools_web_contents_)
@@ -528,8 +534,18 @@ gfx::Rect InspectableWebContentsImpl::GetDevToolsBounds() const {
 }
 
 void InspectableWebContentsImpl::SaveDevToolsBounds(const gfx::Rect& bounds) {
-  pref_service_->Set(kDevToolsBoundsPref, RectToDictionary(bounds));
   devtools_bounds_ = bounds;
+  if (!save_bounds_timer_.IsRunning()) {
+    save_bounds_timer_.Start(
+        FROM_HERE, kDevToolsBoundsWriteDelay,
+        base::BindOnce(&InspectableWebContentsImpl::CommitDevToolsBounds,
+                       base::Unretained(this)));
+  }
+}
+
+void InspectableWebContentsImpl::CommitDevToolsBounds() {
+  save_bounds_timer_.Stop();
+  pref_service_->Set(kDevToolsBoundsPref, RectToDictionary(devtools_bounds_));
 }
 
 double InspectableWebContentsImpl::GetDevToolsZoomLevel() const {
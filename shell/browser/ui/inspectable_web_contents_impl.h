@@ -15,6 +15,7 @@
 
 #include "base/containers/unique_ptr_adapters.h"
 #include "base/memory/weak_ptr.h"
+#include "base/timer/timer.h"
 #include "chrome/browser/devtools/devtools_contents_resizing_strategy.h"
 #include "chrome/browser/devtools/devtools_embedder_message_dispatcher.h"
 #include "content/public/browser/devtools_agent_host.h"
@@ -72,6 +73,7 @@ class InspectableWebContentsImpl
 
   // Return the last position and size of devtools window.
   gfx::Rect GetDevToolsBounds() const;
+  // The bounds change on every resize, so writing them to prefs is deferred.
   void SaveDevToolsBounds(const gfx::Rect& bounds);
 
   // Return the last set zoom level of devtools window.
@@ -79,6 +81,8 @@ class InspectableWebContentsImpl
   void UpdateDevToolsZoomLevel(double level);
 
  private:
+  void CommitDevToolsBounds();
+
   // DevToolsEmbedderMessageDispacher::Delegate
   void ActivateWindow() override;
   void CloseWindow() override;
@@ -201,6 +205,7 @@ class InspectableWebContentsImpl
 
   DevToolsContentsResizingStrategy contents_resizing_strategy_;
   gfx::Rect devtools_bounds_;
+  base::OneShotTimer save_bounds_timer_;
   bool can_dock_;
   std::string dock_state_;
   bool activate_ = true;
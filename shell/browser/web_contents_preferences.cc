@@ -16,6 +16,8 @@
 #include "cc/base/switches.h"
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/render_process_host.h"
+#include "content/public/browser/render_view_host.h"
+#include "content/public/common/child_process_host.h"
 #include "content/public/common/content_switches.h"
 #include "content/public/common/web_preferences.h"
 #include "electron/buildflags/buildflags.h"
@@ -98,12 +100,15 @@ bool GetAsAutoplayPolicy(const base::Value* val,
 namespace electron {
 
 // static
-std::vector<WebContentsPreferences*> WebContentsPreferences::instances_;
+std::map<int, std::vector<WebContentsPreferences*>>
+    WebContentsPreferences::process_index_;
 
 WebContentsPreferences::WebContentsPreferences(
     content::WebContents* web_contents,
     const mate::Dictionary& web_preferences)
-    : web_contents_(web_contents) {
+    : content::WebContentsObserver(web_contents),
+      web_contents_(web_contents),
+      indexed_process_id_(content::ChildProcessHost::kInvalidUniqueID) {
   v8::Isolate* isolate = web_preferences.isolate();
   mate::Dictionary copied(isolate, web_preferences.GetHandle()->Clone());
   // Following fields should not be stored.
@@ -114,7 +119,7 @@ WebContentsPreferences::WebContentsPreferences(
   mate::ConvertFromV8(isolate, copied.GetHandle(), &preference_);
   web_contents->SetUserData(UserDataKey(), base::WrapUnique(this));
 
-  instances_.push_back(this);
+  UpdateProcessIndex();
 
   // Set WebPreferences defaults onto the JS object
   SetDefaultBoolIfUndefined(options::kPlugins, false);
@@ -171,8 +176,47 @@ WebContentsPreferences::WebContentsPreferences(
 }
 
 WebContentsPreferences::~WebContentsPreferences() {
-  instances_.erase(std::remove(instances_.begin(), instances_.end(), this),
-                   instances_.end());
+  RemoveFromProcessIndex();
+}
+
+void WebContentsPreferences::RenderFrameHostChanged(
+    content::RenderFrameHost* old_host,
+    content::RenderFrameHost* new_host) {
+  // Only swaps of the main frame can move us to another process.
+  if (new_host && !new_host->GetParent())
+    UpdateProcessIndex();
+}
+
+void WebContentsPreferences::RenderViewHostChanged(
+    content::RenderViewHost* old_host,
+    content::RenderViewHost* new_host) {
+  UpdateProcessIndex();
+}
+
+void WebContentsPreferences::UpdateProcessIndex() {
+  content::RenderFrameHost* main_frame = web_contents_->GetMainFrame();
+  int process_id = main_frame ? main_frame->GetProcess()->GetID()
+                              : content::ChildProcessHost::kInvalidUniqueID;
+  if (process_id == indexed_process_id_)
+    return;
+
+  RemoveFromProcessIndex();
+  if (process_id != content::ChildProcessHost::kInvalidUniqueID) {
+    process_index_[process_id].push_back(this);
+    indexed_process_id_ = process_id;
+  }
+}
+
+void WebContentsPreferences::RemoveFromProcessIndex() {
+  auto it = process_index_.find(indexed_process_id_);
+  if (it != process_index_.end()) {
+    auto& entries = it->second;
+    entries.erase(std::remove(entries.begin(), entries.end(), this),
+                  entries.end());
+    if (entries.empty())
+      process_index_.erase(it);
+  }
+  indexed_process_id_ = content::ChildProcessHost::kInvalidUniqueID;
 }
 
 void WebContentsPreferences::SetDefaults() {
@@ -256,12 +300,10 @@ bool WebContentsPreferences::GetPreloadPath(
 // static
 content::WebContents* WebContentsPreferences::GetWebContentsFromProcessID(
     int process_id) {
-  for (WebContentsPreferences* preferences : instances_) {
-    content::WebContents* web_contents = preferences->web_contents_;
-    if (web_contents->GetMainFrame()->GetProcess()->GetID() == process_id)
-      return web_contents;
-  }
-  return nullptr;
+  auto it = process_index_.find(process_id);
+  if (it == process_index_.end() || it->second.empty())
+    return nullptr;
+  return it->second.front()->web_contents_;
 }
 
 // static
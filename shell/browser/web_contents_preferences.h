@@ -5,10 +5,12 @@
 #ifndef SHELL_BROWSER_WEB_CONTENTS_PREFERENCES_H_
 #define SHELL_BROWSER_WEB_CONTENTS_PREFERENCES_H_
 
+#include <map>
 #include <string>
 #include <vector>
 
 #include "base/values.h"
+#include "content/public/browser/web_contents_observer.h"
 #include "content/public/browser/web_contents_user_data.h"
 
 namespace base {
@@ -27,7 +29,8 @@ namespace electron {
 
 // Stores and applies the preferences of WebContents.
 class WebContentsPreferences
-    : public content::WebContentsUserData<WebContentsPreferences> {
+    : public content::WebContentsObserver,
+      public content::WebContentsUserData<WebContentsPreferences> {
  public:
   // Get self from WebContents.
   static WebContentsPreferences* From(content::WebContents* web_contents);
@@ -65,6 +68,13 @@ class WebContentsPreferences
   base::Value* preference() { return &preference_; }
   base::Value* last_preference() { return &last_preference_; }
 
+ protected:
+  // content::WebContentsObserver:
+  void RenderFrameHostChanged(content::RenderFrameHost* old_host,
+                              content::RenderFrameHost* new_host) override;
+  void RenderViewHostChanged(content::RenderViewHost* old_host,
+                             content::RenderViewHost* new_host) override;
+
  private:
   friend class content::WebContentsUserData<WebContentsPreferences>;
   friend class ElectronBrowserClient;
@@ -72,16 +82,27 @@ class WebContentsPreferences
   // Get WebContents according to process ID.
   static content::WebContents* GetWebContentsFromProcessID(int process_id);
 
+  // Keep |process_index_| in sync with the process of the main frame.
+  void UpdateProcessIndex();
+  void RemoveFromProcessIndex();
+
   // Set preference value to given bool if user did not provide value
   bool SetDefaultBoolIfUndefined(base::StringPiece key, bool val);
 
   // Set preference value to given bool
   void SetBool(base::StringPiece key, bool value);
 
-  static std::vector<WebContentsPreferences*> instances_;
+  // Maps the ID of the main frame's render process to the preferences of the
+  // WebContents hosted in it, so lookups by process ID don't have to walk
+  // every WebContents.
+  static std::map<int, std::vector<WebContentsPreferences*>> process_index_;
 
   content::WebContents* web_contents_;
 
+  // The process ID this instance is currently registered under in
+  // |process_index_|.
+  int indexed_process_id_;
+
   base::Value preference_ = base::Value(base::Value::Type::DICTIONARY);
   base::Value last_preference_ = base::Value(base::Value::Type::DICTIONARY);
 
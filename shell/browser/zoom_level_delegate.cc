@@ -30,6 +30,9 @@ const char kPartitionDefaultZoomLevel[] = "partition.default_zoom_level";
 // be displayed at the default zoom level.
 const char kPartitionPerHostZoomLevels[] = "partition.per_host_zoom_levels";
 
+// How long per-host zoom changes are held before being written to prefs.
+constexpr base::TimeDelta kPrefWriteDelay = base::TimeDelta::FromSeconds(1);
+
 std::string GetHash(const base::FilePath& partition_path) {
   size_t int_key = std::hash<base::FilePath>()(partition_path);
   return base::NumberToString(int_key);
@@ -50,18 +53,32 @@ ZoomLevelDelegate::ZoomLevelDelegate(PrefService* pref_service,
   partition_key_ = GetHash(partition_path);
 }
 
-ZoomLevelDelegate::~ZoomLevelDelegate() = default;
+ZoomLevelDelegate::~ZoomLevelDelegate() {
+  CommitPendingZoomLevels();
+}
 
 void ZoomLevelDelegate::SetDefaultZoomLevelPref(double level) {
   if (blink::PageZoomValuesEqual(level, host_zoom_map_->GetDefaultZoomLevel()))
     return;
 
+  // Writing now would be undone by the pending read of the prefs, so the
+  // level is written once it completes.
+  if (pref_service_->GetInitializationStatus() ==
+      PrefService::INITIALIZATION_STATUS_WAITING) {
+    pending_default_zoom_level_ = level;
+    host_zoom_map_->SetDefaultZoomLevel(level);
+    return;
+  }
+
   DictionaryPrefUpdate update(pref_service_, kPartitionDefaultZoomLevel);
   update->SetDouble(partition_key_, level);
   host_zoom_map_->SetDefaultZoomLevel(level);
 }
 
 double ZoomLevelDelegate::GetDefaultZoomLevelPref() const {
+  if (pending_default_zoom_level_)
+    return *pending_default_zoom_level_;
+
   double default_zoom_level = 0.0;
 
   const base::DictionaryValue* default_zoom_level_dictionary =
@@ -77,14 +94,29 @@ void ZoomLevelDelegate::OnZoomLevelChanged(
   if (change.mode != content::HostZoomMap::ZOOM_CHANGED_FOR_HOST)
     return;
 
-  double level = change.zoom_level;
+  // Levels equal to the default are removed from prefs instead of stored.
+  bool modification_is_removal = blink::PageZoomValuesEqual(
+      change.zoom_level, host_zoom_map_->GetDefaultZoomLevel());
+  pending_host_zoom_levels_[change.host] =
+      modification_is_removal ? base::nullopt
+                              : base::make_optional(change.zoom_level);
+  if (!commit_timer_.IsRunning()) {
+    commit_timer_.Start(
+        FROM_HERE, kPrefWriteDelay,
+        base::BindOnce(&ZoomLevelDelegate::CommitPendingZoomLevels,
+                       base::Unretained(this)));
+  }
+}
+
+void ZoomLevelDelegate::CommitPendingZoomLevels() {
+  commit_timer_.Stop();
+  if (pending_host_zoom_levels_.empty())
+    return;
+
   DictionaryPrefUpdate update(pref_service_, kPartitionPerHostZoomLevels);
   base::DictionaryValue* host_zoom_dictionaries = update.Get();
   DCHECK(host_zoom_dictionaries);
 
-  bool modification_is_removal =
-      blink::PageZoomValuesEqual(level, host_zoom_map_->GetDefaultZoomLevel());
-
   base::DictionaryValue* host_zoom_dictionary = nullptr;
   if (!host_zoom_dictionaries->GetDictionary(partition_key_,
                                              &host_zoom_dictionary)) {
@@ -92,10 +124,13 @@ void ZoomLevelDelegate::OnZoomLevelChanged(
         partition_key_, std::make_unique<base::DictionaryValue>());
   }
 
-  if (modification_is_removal)
-    host_zoom_dictionary->RemoveWithoutPathExpansion(change.host, nullptr);
-  else
-    host_zoom_dictionary->SetKey(change.host, base::Value(level));
+  for (const auto& it : pending_host_zoom_levels_) {
+    if (it.second)
+      host_zoom_dictionary->SetKey(it.first, base::Value(*it.second));
+    else
+      host_zoom_dictionary->RemoveWithoutPathExpansion(it.first, nullptr);
+  }
+  pending_host_zoom_levels_.clear();
 }
 
 void ZoomLevelDelegate::ExtractPerHostZoomLevels(
@@ -145,6 +180,24 @@ void ZoomLevelDelegate::InitHostZoomMap(content::HostZoomMap* host_zoom_map) {
   DCHECK(host_zoom_map);
   host_zoom_map_ = host_zoom_map;
 
+  // The partition may have been created before its prefs were read from disk,
+  // see the |asyncPrefs| session option.
+  if (pref_service_->GetInitializationStatus() ==
+      PrefService::INITIALIZATION_STATUS_WAITING) {
+    pref_service_->AddPrefInitObserver(base::BindOnce(
+        &ZoomLevelDelegate::OnPrefsInitialized, weak_factory_.GetWeakPtr()));
+    return;
+  }
+  OnPrefsInitialized(true);
+}
+
+void ZoomLevelDelegate::OnPrefsInitialized(bool success) {
+  if (pending_default_zoom_level_) {
+    DictionaryPrefUpdate update(pref_service_, kPartitionDefaultZoomLevel);
+    update->SetDouble(partition_key_, *pending_default_zoom_level_);
+    pending_default_zoom_level_.reset();
+  }
+
   // Initialize the default zoom level.
   host_zoom_map_->SetDefaultZoomLevel(GetDefaultZoomLevelPref());
 
@@ -5,11 +5,15 @@
 #ifndef SHELL_BROWSER_ZOOM_LEVEL_DELEGATE_H_
 #define SHELL_BROWSER_ZOOM_LEVEL_DELEGATE_H_
 
+#include <map>
 #include <memory>
 #include <string>
 
 #include "base/files/file_path.h"
 #include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/optional.h"
+#include "base/timer/timer.h"
 #include "components/prefs/pref_service.h"
 #include "content/public/browser/host_zoom_map.h"
 #include "content/public/browser/zoom_level_delegate.h"
@@ -27,7 +31,9 @@ namespace electron {
 // levels in HostZoomMap and preference system. All changes
 // to the per-partition default zoom levels flow through this
 // class. Any changes to per-host levels are updated when HostZoomMap calls
-// OnZoomLevelChanged.
+// OnZoomLevelChanged. Per-host changes are batched and written to the
+// preferences at most once per kPrefWriteDelay, since zooming with a
+// trackpad or the keyboard produces a burst of them.
 class ZoomLevelDelegate : public content::ZoomLevelDelegate {
  public:
   static void RegisterPrefs(PrefRegistrySimple* pref_registry);
@@ -46,6 +52,12 @@ class ZoomLevelDelegate : public content::ZoomLevelDelegate {
   void ExtractPerHostZoomLevels(
       const base::DictionaryValue* host_zoom_dictionary);
 
+  // Does the actual work of InitHostZoomMap once the prefs are readable.
+  void OnPrefsInitialized(bool success);
+
+  // Writes the zoom levels queued in |pending_host_zoom_levels_|.
+  void CommitPendingZoomLevels();
+
   // This is a callback function that receives notifications from HostZoomMap
   // when per-host zoom levels change. It is used to update the per-host
   // zoom levels (if any) managed by this class (for its associated partition).
@@ -56,6 +68,17 @@ class ZoomLevelDelegate : public content::ZoomLevelDelegate {
   std::unique_ptr<content::HostZoomMap::Subscription> zoom_subscription_;
   std::string partition_key_;
 
+  // host => zoom level waiting to be written to prefs, or base::nullopt when
+  // the host's entry should be removed.
+  std::map<std::string, base::Optional<double>> pending_host_zoom_levels_;
+  base::OneShotTimer commit_timer_;
+
+  // Default zoom level set before the prefs were read, see the |asyncPrefs|
+  // session option.
+  base::Optional<double> pending_default_zoom_level_;
+
+  base::WeakPtrFactory<ZoomLevelDelegate> weak_factory_{this};
+
   DISALLOW_COPY_AND_ASSIGN(ZoomLevelDelegate);
 };
 
@@ -4,14 +4,19 @@
 
 #include "shell/common/api/electron_api_native_image.h"
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "base/bind.h"
 #include "base/files/file_util.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/strings/pattern.h"
 #include "base/strings/string_util.h"
+#include "base/task/post_task.h"
 #include "base/threading/thread_restrictions.h"
 #include "net/base/data_url.h"
 #include "shell/common/asar/asar_util.h"
@@ -21,8 +26,11 @@
 #include "shell/common/gin_converters/value_converter_gin_adapter.h"
 #include "shell/common/gin_helper/dictionary.h"
 #include "shell/common/gin_helper/object_template_builder.h"
+#include "shell/common/native_image_cache.h"
 #include "shell/common/node_includes.h"
+#include "shell/common/promise_util.h"
 #include "shell/common/skia_util.h"
+#include "skia/ext/image_operations.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkImageInfo.h"
 #include "third_party/skia/include/core/SkPixelRef.h"
@@ -34,6 +42,7 @@
 #include "ui/gfx/image/image_skia.h"
 #include "ui/gfx/image/image_skia_operations.h"
 #include "ui/gfx/image/image_util.h"
+#include "ui/gfx/skia_util.h"
 
 #if defined(OS_WIN)
 #include "base/win/scoped_gdi_object.h"
@@ -97,7 +106,187 @@ base::win::ScopedHICON ReadICOFromPath(int size, const base::FilePath& path) {
 }
 #endif
 
-void Noop(char*, void*) {}
+void UnrefPixelRef(char* data, void* hint) {
+  static_cast<SkPixelRef*>(hint)->unref();
+}
+
+void ReleaseBackingStore(void* pixels, void* context) {
+  delete static_cast<std::shared_ptr<v8::BackingStore>*>(context);
+}
+
+// Makes |bitmap| use the memory of the node Buffer |buffer| as its pixels
+// instead of copying them. The memory stays alive until the bitmap is gone,
+// even if the Buffer is garbage collected first.
+bool InstallPixelsFromBuffer(v8::Local<v8::Value> buffer,
+                             const SkImageInfo& info,
+                             SkBitmap* bitmap) {
+  if (node::Buffer::Length(buffer) < info.computeMinByteSize())
+    return false;
+  v8::Local<v8::ArrayBuffer> array_buffer =
+      buffer.As<v8::ArrayBufferView>()->Buffer();
+  // The backing store of an externalized buffer, like those returned by
+  // getBitmap() or printToPDF(), does not own its memory, which may be freed
+  // as soon as the Buffer is collected. Those are copied instead.
+  if (array_buffer->IsExternal()) {
+    return bitmap->tryAllocPixels(info) &&
+           bitmap->writePixels(
+               {info, node::Buffer::Data(buffer), info.minRowBytes()});
+  }
+  auto* backing_store =
+      new std::shared_ptr<v8::BackingStore>(array_buffer->GetBackingStore());
+  // |backing_store| is released by Skia even when this fails.
+  return bitmap->installPixels(info, node::Buffer::Data(buffer),
+                               info.minRowBytes(), &ReleaseBackingStore,
+                               backing_store);
+}
+
+skia::ImageOperations::ResizeMethod GetResizeMethod(
+    const std::string& quality) {
+  if (quality == "good")
+    return skia::ImageOperations::ResizeMethod::RESIZE_GOOD;
+  else if (quality == "better")
+    return skia::ImageOperations::ResizeMethod::RESIZE_BETTER;
+  return skia::ImageOperations::ResizeMethod::RESIZE_BEST;
+}
+
+// Runs on the thread pool.
+std::vector<gfx::ImageSkiaRep> ReadImageSkiaRepsFromPath(
+    const base::FilePath& path) {
+  return electron::util::ReadImageSkiaRepsFromPath(NormalizePath(path));
+}
+
+// Runs on the thread pool.
+std::vector<gfx::ImageSkiaRep> DecodeImageSkiaReps(
+    const std::vector<unsigned char>& data,
+    int width,
+    int height,
+    double scale_factor) {
+  gfx::ImageSkia image_skia;
+  if (!electron::util::AddImageSkiaRepFromBuffer(
+          &image_skia, data.data(), data.size(), width, height, scale_factor))
+    return {};
+  return image_skia.image_reps();
+}
+
+// One step of a job of nativeImage.transformImages().
+struct ImageOperation {
+  enum class Type {
+    kResize,
+    kCrop,
+  };
+
+  Type type = Type::kResize;
+  // Resize, a dimension left to 0 keeps the aspect ratio.
+  int width = 0;
+  int height = 0;
+  skia::ImageOperations::ResizeMethod method =
+      skia::ImageOperations::ResizeMethod::RESIZE_BEST;
+  // Crop.
+  gfx::Rect rect;
+};
+
+struct ImageTransformJob {
+  SkBitmap bitmap;
+  std::vector<ImageOperation> operations;
+  bool jpeg = false;
+  int quality = 90;
+};
+
+// Runs on the thread pool.
+scoped_refptr<base::RefCountedBytes> RunImageTransformJob(
+    const ImageTransformJob& job) {
+  SkBitmap bitmap = job.bitmap;
+  for (const ImageOperation& operation : job.operations) {
+    if (bitmap.drawsNothing())
+      break;
+    if (operation.type == ImageOperation::Type::kCrop) {
+      SkBitmap subset;
+      if (!bitmap.extractSubset(&subset, gfx::RectToSkIRect(operation.rect)))
+        subset.reset();
+      bitmap = subset;
+      continue;
+    }
+
+    int width = operation.width;
+    int height = operation.height;
+    if (!width && !height)
+      continue;
+    if (!height)
+      height = std::round(static_cast<double>(width) * bitmap.height() /
+                          bitmap.width());
+    else if (!width)
+      width = std::round(static_cast<double>(height) * bitmap.width() /
+                         bitmap.height());
+    bitmap = skia::ImageOperations::Resize(bitmap, operation.method,
+                                           std::max(width, 1),
+                                           std::max(height, 1));
+  }
+
+  std::vector<unsigned char> encoded;
+  if (!bitmap.drawsNothing()) {
+    if (job.jpeg)
+      gfx::JPEGCodec::Encode(bitmap, job.quality, &encoded);
+    else
+      gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &encoded);
+  }
+  return base::RefCountedBytes::TakeVector(&encoded);
+}
+
+void FreeRefCountedBytes(char* data, void* hint) {
+  static_cast<base::RefCountedBytes*>(hint)->Release();
+}
+
+// Collects the results of the jobs of nativeImage.transformImages() on the
+// calling thread, and resolves the promise once they are all done.
+class ImageTransformBatch : public base::RefCounted<ImageTransformBatch> {
+ public:
+  ImageTransformBatch(util::Promise<v8::Local<v8::Value>> promise,
+                      size_t job_count)
+      : promise_(std::move(promise)),
+        results_(job_count),
+        pending_(job_count) {}
+
+  void OnJobDone(size_t index, scoped_refptr<base::RefCountedBytes> result) {
+    results_[index] = std::move(result);
+    if (--pending_ == 0)
+      Resolve();
+  }
+
+ private:
+  friend class base::RefCounted<ImageTransformBatch>;
+
+  ~ImageTransformBatch() = default;
+
+  void Resolve() {
+    v8::Isolate* isolate = promise_.isolate();
+    v8::HandleScope handle_scope(isolate);
+    v8::Context::Scope context_scope(promise_.GetContext());
+    v8::Local<v8::Context> context = promise_.GetContext();
+    v8::Local<v8::Array> buffers = v8::Array::New(isolate, results_.size());
+    for (size_t i = 0; i < results_.size(); i++) {
+      base::RefCountedBytes* data = results_[i].get();
+      v8::Local<v8::Value> buffer;
+      if (data->size() == 0) {
+        buffer = node::Buffer::New(isolate, 0).ToLocalChecked();
+      } else {
+        // The Buffer takes over the encoded data instead of copying it.
+        data->AddRef();
+        buffer = node::Buffer::New(isolate, data->front_as<char>(),
+                                   data->size(), &FreeRefCountedBytes, data)
+                     .ToLocalChecked();
+      }
+      buffers->Set(context, i, buffer).Check();
+    }
+    results_.clear();
+    promise_.Resolve(buffers);
+  }
+
+  util::Promise<v8::Local<v8::Value>> promise_;
+  std::vector<scoped_refptr<base::RefCountedBytes>> results_;
+  size_t pending_;
+
+  DISALLOW_COPY_AND_ASSIGN(ImageTransformBatch);
+};
 
 }  // namespace
 
@@ -221,9 +410,19 @@ v8::Local<v8::Value> NativeImage::GetBitmap(gin::Arguments* args) {
   SkPixelRef* ref = bitmap.pixelRef();
   if (!ref)
     return node::Buffer::New(args->isolate(), 0).ToLocalChecked();
+  // Immutable pixels, like those of the image cache, may be shared with other
+  // images, and must not be handed to JavaScript as a writable Buffer.
+  if (bitmap.isImmutable())
+    return node::Buffer::Copy(args->isolate(),
+                              static_cast<const char*>(bitmap.getPixels()),
+                              bitmap.computeByteSize())
+        .ToLocalChecked();
+  // The Buffer shares the pixels of the image, and keeps them alive until it
+  // is garbage collected.
+  ref->ref();
   return node::Buffer::New(args->isolate(),
-                           reinterpret_cast<char*>(ref->pixels()),
-                           bitmap.computeByteSize(), &Noop, nullptr)
+                           static_cast<char*>(bitmap.getPixels()),
+                           bitmap.computeByteSize(), &UnrefPixelRef, ref)
       .ToLocalChecked();
 }
 
@@ -290,17 +489,11 @@ gin::Handle<NativeImage> NativeImage::Resize(gin::Arguments* args,
     size = gfx::ScaleToRoundedSize(size, GetAspectRatio(scale_factor), 1.f);
   }
 
-  skia::ImageOperations::ResizeMethod method =
-      skia::ImageOperations::ResizeMethod::RESIZE_BEST;
   std::string quality;
   options.GetString("quality", &quality);
-  if (quality == "good")
-    method = skia::ImageOperations::ResizeMethod::RESIZE_GOOD;
-  else if (quality == "better")
-    method = skia::ImageOperations::ResizeMethod::RESIZE_BETTER;
 
   gfx::ImageSkia resized = gfx::ImageSkiaOperations::CreateResizedImage(
-      image_.AsImageSkia(), method, size);
+      image_.AsImageSkia(), GetResizeMethod(quality), size);
   return gin::CreateHandle(
       args->isolate(), new NativeImage(args->isolate(), gfx::Image(resized)));
 }
@@ -410,6 +603,50 @@ gin::Handle<NativeImage> NativeImage::CreateFromPath(
   return handle;
 }
 
+// static
+void NativeImage::ResolveWithImageSkiaReps(
+    util::Promise<v8::Local<v8::Value>> promise,
+    bool is_template,
+    std::vector<gfx::ImageSkiaRep> reps) {
+  v8::Isolate* isolate = promise.isolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(promise.GetContext());
+  gfx::ImageSkia image_skia;
+  for (const gfx::ImageSkiaRep& rep : reps)
+    image_skia.AddRepresentation(rep);
+  gin::Handle<NativeImage> handle = Create(isolate, gfx::Image(image_skia));
+  if (is_template)
+    handle->SetTemplateImage(true);
+  promise.Resolve(handle.ToV8());
+}
+
+// static
+v8::Local<v8::Promise> NativeImage::CreateFromPathAsync(
+    v8::Isolate* isolate,
+    const base::FilePath& path) {
+  util::Promise<v8::Local<v8::Value>> promise(isolate);
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+#if defined(OS_WIN)
+  // Icons are loaded by the system for every size they are used at.
+  if (path.MatchesExtension(FILE_PATH_LITERAL(".ico"))) {
+    promise.Resolve(CreateFromPath(isolate, path).ToV8());
+    return handle;
+  }
+#endif
+  bool is_template = false;
+#if defined(OS_MACOSX)
+  is_template = IsTemplateFilename(path);
+#endif
+  base::PostTaskAndReplyWithResult(
+      FROM_HERE,
+      {base::ThreadPool(), base::MayBlock(),
+       base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(&ReadImageSkiaRepsFromPath, path),
+      base::BindOnce(&NativeImage::ResolveWithImageSkiaReps,
+                     std::move(promise), is_template));
+  return handle;
+}
+
 // static
 gin::Handle<NativeImage> NativeImage::CreateFromBitmap(
     gin_helper::ErrorThrower thrower,
@@ -442,15 +679,22 @@ gin::Handle<NativeImage> NativeImage::CreateFromBitmap(
     return gin::Handle<NativeImage>();
   }
 
+  bool copy = true;
   options.Get("scaleFactor", &scale_factor);
+  options.Get("copy", &copy);
 
   if (width == 0 || height == 0) {
     return CreateEmpty(thrower.isolate());
   }
 
   SkBitmap bitmap;
-  bitmap.allocN32Pixels(width, height, false);
-  bitmap.writePixels({info, node::Buffer::Data(buffer), bitmap.rowBytes()});
+  if (copy) {
+    bitmap.allocN32Pixels(width, height, false);
+    bitmap.writePixels({info, node::Buffer::Data(buffer), bitmap.rowBytes()});
+  } else if (!InstallPixelsFromBuffer(buffer, info, &bitmap)) {
+    thrower.ThrowError("failed to use the memory of buffer");
+    return gin::Handle<NativeImage>();
+  }
 
   gfx::ImageSkia image_skia;
   image_skia.AddRepresentation(gfx::ImageSkiaRep(bitmap, scale_factor));
@@ -471,21 +715,149 @@ gin::Handle<NativeImage> NativeImage::CreateFromBuffer(
   int width = 0;
   int height = 0;
   double scale_factor = 1.;
+  bool copy = true;
 
   gin_helper::Dictionary options;
   if (args->GetNext(&options)) {
     options.Get("width", &width);
     options.Get("height", &height);
     options.Get("scaleFactor", &scale_factor);
+    options.Get("copy", &copy);
   }
 
+  const auto* data =
+      reinterpret_cast<const unsigned char*>(node::Buffer::Data(buffer));
+  size_t size = node::Buffer::Length(buffer);
   gfx::ImageSkia image_skia;
-  electron::util::AddImageSkiaRepFromBuffer(
-      &image_skia, reinterpret_cast<unsigned char*>(node::Buffer::Data(buffer)),
-      node::Buffer::Length(buffer), width, height, scale_factor);
+  if (copy || width <= 0 || height <= 0) {
+    electron::util::AddImageSkiaRepFromBuffer(&image_skia, data, size, width,
+                                              height, scale_factor);
+  } else if (!electron::util::AddImageSkiaRepFromPNG(&image_skia, data, size,
+                                                     scale_factor) &&
+             !electron::util::AddImageSkiaRepFromJPEG(&image_skia, data, size,
+                                                      scale_factor)) {
+    // Only raw bitmap data can be used without being decoded.
+    SkBitmap bitmap;
+    auto info = SkImageInfo::MakeN32(width, height, kPremul_SkAlphaType);
+    if (InstallPixelsFromBuffer(buffer, info, &bitmap))
+      image_skia.AddRepresentation(gfx::ImageSkiaRep(bitmap, scale_factor));
+  }
   return Create(args->isolate(), gfx::Image(image_skia));
 }
 
+// static
+v8::Local<v8::Promise> NativeImage::CreateFromBufferAsync(
+    gin_helper::ErrorThrower thrower,
+    v8::Local<v8::Value> buffer,
+    gin::Arguments* args) {
+  if (!node::Buffer::HasInstance(buffer)) {
+    thrower.ThrowError("buffer must be a node Buffer");
+    return v8::Local<v8::Promise>();
+  }
+
+  int width = 0;
+  int height = 0;
+  double scale_factor = 1.;
+
+  gin_helper::Dictionary options;
+  if (args->GetNext(&options)) {
+    options.Get("width", &width);
+    options.Get("height", &height);
+    options.Get("scaleFactor", &scale_factor);
+  }
+
+  // The buffer could be modified while it is decoded.
+  const auto* data =
+      reinterpret_cast<const unsigned char*>(node::Buffer::Data(buffer));
+  std::vector<unsigned char> copy(data, data + node::Buffer::Length(buffer));
+
+  util::Promise<v8::Local<v8::Value>> promise(args->isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+  base::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::ThreadPool(), base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(&DecodeImageSkiaReps, std::move(copy), width, height,
+                     scale_factor),
+      base::BindOnce(&NativeImage::ResolveWithImageSkiaReps,
+                     std::move(promise), false));
+  return handle;
+}
+
+// static
+v8::Local<v8::Promise> NativeImage::TransformImages(
+    gin_helper::ErrorThrower thrower,
+    const std::vector<gin_helper::Dictionary>& jobs) {
+  std::vector<ImageTransformJob> transform_jobs(jobs.size());
+  for (size_t i = 0; i < jobs.size(); i++) {
+    ImageTransformJob& job = transform_jobs[i];
+    NativeImage* image = nullptr;
+    if (!jobs[i].Get("image", &image)) {
+      thrower.ThrowError("image must be a NativeImage");
+      return v8::Local<v8::Promise>();
+    }
+    float scale_factor = 1.0f;
+    jobs[i].Get("scaleFactor", &scale_factor);
+    if (!image->IsEmpty()) {
+      job.bitmap = image->image()
+                       .AsImageSkia()
+                       .GetRepresentation(scale_factor)
+                       .GetBitmap();
+    }
+
+    std::string format = "png";
+    jobs[i].Get("format", &format);
+    if (format != "png" && format != "jpeg") {
+      thrower.ThrowError("format must be 'png' or 'jpeg'");
+      return v8::Local<v8::Promise>();
+    }
+    job.jpeg = format == "jpeg";
+    jobs[i].Get("quality", &job.quality);
+
+    std::vector<gin_helper::Dictionary> operations;
+    jobs[i].Get("operations", &operations);
+    for (const gin_helper::Dictionary& options : operations) {
+      ImageOperation operation;
+      std::string type;
+      options.Get("type", &type);
+      if (type == "resize") {
+        std::string quality;
+        options.Get("width", &operation.width);
+        options.Get("height", &operation.height);
+        options.Get("quality", &quality);
+        operation.method = GetResizeMethod(quality);
+      } else if (type == "crop") {
+        operation.type = ImageOperation::Type::kCrop;
+        int x = 0, y = 0, width = 0, height = 0;
+        options.Get("x", &x);
+        options.Get("y", &y);
+        options.Get("width", &width);
+        options.Get("height", &height);
+        operation.rect = gfx::Rect(x, y, width, height);
+      } else {
+        thrower.ThrowError("operation type must be 'resize' or 'crop'");
+        return v8::Local<v8::Promise>();
+      }
+      job.operations.push_back(operation);
+    }
+  }
+
+  util::Promise<v8::Local<v8::Value>> promise(thrower.isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+  if (transform_jobs.empty()) {
+    promise.Resolve(v8::Array::New(thrower.isolate()));
+    return handle;
+  }
+  auto batch = base::MakeRefCounted<ImageTransformBatch>(std::move(promise),
+                                                         jobs.size());
+  // Every job is a task of its own, so that they run in parallel.
+  for (size_t i = 0; i < transform_jobs.size(); i++) {
+    base::PostTaskAndReplyWithResult(
+        FROM_HERE, {base::ThreadPool(), base::TaskPriority::USER_VISIBLE},
+        base::BindOnce(&RunImageTransformJob, std::move(transform_jobs[i])),
+        base::BindOnce(&ImageTransformBatch::OnJobDone, batch, i));
+  }
+  return handle;
+}
+
 // static
 gin::Handle<NativeImage> NativeImage::CreateFromDataURL(v8::Isolate* isolate,
                                                         const GURL& url) {
@@ -572,6 +944,15 @@ namespace {
 
 using electron::api::NativeImage;
 
+base::Value GetCacheStats() {
+  return electron::NativeImageCache::GetInstance()->GetStats();
+}
+
+void SetCacheLimit(double limit) {
+  electron::NativeImageCache::GetInstance()->SetLimit(
+      static_cast<size_t>(std::max(limit, 0.)));
+}
+
 void Initialize(v8::Local<v8::Object> exports,
                 v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context,
@@ -588,7 +969,14 @@ void Initialize(v8::Local<v8::Object> exports,
   native_image.SetMethod("createFromPath", &NativeImage::CreateFromPath);
   native_image.SetMethod("createFromBitmap", &NativeImage::CreateFromBitmap);
   native_image.SetMethod("createFromBuffer", &NativeImage::CreateFromBuffer);
+  native_image.SetMethod("createFromPathAsync",
+                         &NativeImage::CreateFromPathAsync);
+  native_image.SetMethod("createFromBufferAsync",
+                         &NativeImage::CreateFromBufferAsync);
   native_image.SetMethod("createFromDataURL", &NativeImage::CreateFromDataURL);
+  native_image.SetMethod("transformImages", &NativeImage::TransformImages);
+  native_image.SetMethod("getCacheStats", &GetCacheStats);
+  native_image.SetMethod("setCacheLimit", &SetCacheLimit);
   native_image.SetMethod("createFromNamedImage",
                          &NativeImage::CreateFromNamedImage);
 }
@@ -14,7 +14,9 @@
 #include "native_mate/handle.h"
 #include "native_mate/wrappable.h"
 #include "shell/common/gin_helper/error_thrower.h"
+#include "shell/common/promise_util.h"
 #include "ui/gfx/image/image.h"
+#include "ui/gfx/image/image_skia_rep.h"
 
 #if defined(OS_WIN)
 #include "base/files/file_path.h"
@@ -61,6 +63,16 @@ class NativeImage : public mate::Wrappable<NativeImage> {
       gin_helper::ErrorThrower thrower,
       v8::Local<v8::Value> buffer,
       gin::Arguments* args);
+  static v8::Local<v8::Promise> CreateFromPathAsync(
+      v8::Isolate* isolate,
+      const base::FilePath& path);
+  static v8::Local<v8::Promise> CreateFromBufferAsync(
+      gin_helper::ErrorThrower thrower,
+      v8::Local<v8::Value> buffer,
+      gin::Arguments* args);
+  static v8::Local<v8::Promise> TransformImages(
+      gin_helper::ErrorThrower thrower,
+      const std::vector<gin_helper::Dictionary>& jobs);
   static gin::Handle<NativeImage> CreateFromDataURL(v8::Isolate* isolate,
                                                     const GURL& url);
   static gin::Handle<NativeImage> CreateFromNamedImage(gin::Arguments* args,
@@ -83,6 +95,12 @@ class NativeImage : public mate::Wrappable<NativeImage> {
   ~NativeImage() override;
 
  private:
+  // Resolves |promise| with the image read or decoded on the thread pool.
+  static void ResolveWithImageSkiaReps(
+      util::Promise<v8::Local<v8::Value>> promise,
+      bool is_template,
+      std::vector<gfx::ImageSkiaRep> reps);
+
   v8::Local<v8::Value> ToPNG(gin::Arguments* args);
   v8::Local<v8::Value> ToJPEG(v8::Isolate* isolate, int quality);
   v8::Local<v8::Value> ToBitmap(gin::Arguments* args);
@@ -5,12 +5,14 @@
 #ifndef SHELL_COMMON_GIN_HELPER_EVENT_EMITTER_H_
 #define SHELL_COMMON_GIN_HELPER_EVENT_EMITTER_H_
 
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "base/optional.h"
 #include "electron/shell/common/api/api.mojom.h"
 #include "shell/common/gin_helper/event_emitter_caller.h"
+#include "shell/common/gin_helper/event_listener_cache.h"
 
 namespace gin_helper {
 
@@ -40,11 +42,19 @@ class EventEmitter : public Base {
     return Base::GetWrapper(isolate);
   }
 
+  // Sets the names of the events that have JS listeners, see
+  // EventListenerCache.
+  void SetListenedEvents(const std::vector<std::string>& names) {
+    listener_cache_.SetListenedEvents(names);
+  }
+
   // this.emit(name, event, args...);
   template <typename... Args>
   bool EmitCustomEvent(base::StringPiece name,
                        v8::Local<v8::Object> event,
                        Args&&... args) {
+    if (!listener_cache_.ShouldEmit(name))
+      return false;
     return EmitWithEvent(
         name, internal::CreateCustomEvent(isolate(), GetWrapper(), event),
         std::forward<Args>(args)...);
@@ -53,14 +63,21 @@ class EventEmitter : public Base {
   // this.emit(name, new Event(flags), args...);
   template <typename... Args>
   bool EmitWithFlags(base::StringPiece name, int flags, Args&&... args) {
-    return EmitCustomEvent(name,
-                           internal::CreateEventFromFlags(isolate(), flags),
-                           std::forward<Args>(args)...);
+    if (!listener_cache_.ShouldEmit(name))
+      return false;
+    return EmitWithEvent(
+        name,
+        internal::CreateCustomEvent(
+            isolate(), GetWrapper(),
+            internal::CreateEventFromFlags(isolate(), flags)),
+        std::forward<Args>(args)...);
   }
 
   // this.emit(name, new Event(), args...);
   template <typename... Args>
   bool Emit(base::StringPiece name, Args&&... args) {
+    if (!listener_cache_.ShouldEmit(name))
+      return false;
     v8::Locker locker(isolate());
     v8::HandleScope handle_scope(isolate());
     v8::Local<v8::Object> wrapper = GetWrapper();
@@ -99,6 +116,8 @@ class EventEmitter : public Base {
     return false;
   }
 
+  EventListenerCache listener_cache_;
+
   DISALLOW_COPY_AND_ASSIGN(EventEmitter);
 };
 
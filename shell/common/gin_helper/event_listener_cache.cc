@@ -0,0 +1,62 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/gin_helper/event_listener_cache.h"
+
+#include <utility>
+
+#include "base/no_destructor.h"
+
+namespace gin_helper {
+
+EventListenerCache::EventListenerCache() = default;
+
+EventListenerCache::~EventListenerCache() = default;
+
+void EventListenerCache::SetListenedEvents(
+    const std::vector<std::string>& names) {
+  enabled_ = true;
+  names_ = base::flat_set<std::string, std::less<>>(names);
+}
+
+bool EventListenerCache::ShouldEmit(base::StringPiece name) const {
+  bool emit = !enabled_ || names_.find(name) != names_.end();
+  EventEmitStats::GetInstance()->Record(name, emit);
+  return emit;
+}
+
+// static
+EventEmitStats* EventEmitStats::GetInstance() {
+  static base::NoDestructor<EventEmitStats> instance;
+  return instance.get();
+}
+
+EventEmitStats::EventEmitStats() = default;
+
+EventEmitStats::~EventEmitStats() = default;
+
+void EventEmitStats::Record(base::StringPiece name, bool emitted) {
+  // Events are only emitted natively with fixed names, so the map stays
+  // small without bounding it.
+  auto it = events_.find(name);
+  if (it == events_.end())
+    it = events_.emplace(name.as_string(), Counts()).first;
+  if (emitted)
+    it->second.emitted_count++;
+  else
+    it->second.skipped_count++;
+}
+
+base::Value EventEmitStats::ToValue() const {
+  base::Value result(base::Value::Type::DICTIONARY);
+  for (const auto& it : events_) {
+    base::Value counts(base::Value::Type::DICTIONARY);
+    counts.SetDoubleKey("emitted", it.second.emitted_count);
+    counts.SetDoubleKey("skipped", it.second.skipped_count);
+    result.SetKey(it.first, std::move(counts));
+  }
+  return result;
+}
+
+}  // namespace gin_helper
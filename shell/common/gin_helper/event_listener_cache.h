@@ -0,0 +1,72 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_GIN_HELPER_EVENT_LISTENER_CACHE_H_
+#define SHELL_COMMON_GIN_HELPER_EVENT_LISTENER_CACHE_H_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/containers/flat_set.h"
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+#include "base/values.h"
+
+namespace gin_helper {
+
+// Names of the events an EventEmitter has JS listeners for.
+//
+// The JS side of an emitter opts in by passing its event names whenever its
+// listeners change, after which the events nobody listens to are dropped
+// before anything is created for them in V8. Until then every event is
+// emitted.
+class EventListenerCache {
+ public:
+  EventListenerCache();
+  ~EventListenerCache();
+
+  void SetListenedEvents(const std::vector<std::string>& names);
+
+  // Returns whether |name| has to be emitted, and counts it in the
+  // EventEmitStats either way.
+  bool ShouldEmit(base::StringPiece name) const;
+
+ private:
+  bool enabled_ = false;
+  base::flat_set<std::string, std::less<>> names_;
+
+  DISALLOW_COPY_AND_ASSIGN(EventListenerCache);
+};
+
+// Number of times each event was emitted by the EventEmitters of the
+// process, and skipped for having no listeners.
+class EventEmitStats {
+ public:
+  static EventEmitStats* GetInstance();
+
+  EventEmitStats();
+  ~EventEmitStats();
+
+  void Record(base::StringPiece name, bool emitted);
+
+  // Returns the counts keyed by event name.
+  base::Value ToValue() const;
+
+ private:
+  struct Counts {
+    uint64_t emitted_count = 0;
+    uint64_t skipped_count = 0;
+  };
+
+  std::map<std::string, Counts, std::less<>> events_;
+
+  DISALLOW_COPY_AND_ASSIGN(EventEmitStats);
+};
+
+}  // namespace gin_helper
+
+#endif  // SHELL_COMMON_GIN_HELPER_EVENT_LISTENER_CACHE_H_
@@ -4,10 +4,38 @@
 
 #include "shell/common/heap_snapshot.h"
 
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/containers/circular_deque.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include "base/task/post_task.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "mojo/public/cpp/system/simple_watcher.h"
+#include "mojo/public/cpp/system/wait.h"
+#include "third_party/zlib/zlib.h"
 #include "v8/include/v8-profiler.h"
 
 namespace {
 
+const int kChunkSize = 65536;
+
+// Serialized bytes allowed to wait for the worker sequence before V8 is made
+// to wait, so a slow consumer doesn't buffer the whole snapshot in memory.
+// V8 waits at most for the stall timeout of the snapshot.
+const size_t kMaxPendingBytes = 16 * 1024 * 1024;
+
+class ScopedAllowBaseSyncPrimitives
+    : public base::ScopedAllowBaseSyncPrimitivesForTesting {};
+
 class HeapSnapshotOutputStream : public v8::OutputStream {
  public:
   explicit HeapSnapshotOutputStream(base::File* file) : file_(file) {
@@ -17,7 +45,7 @@ class HeapSnapshotOutputStream : public v8::OutputStream {
   bool IsComplete() const { return is_complete_; }
 
   // v8::OutputStream
-  int GetChunkSize() override { return 65536; }
+  int GetChunkSize() override { return kChunkSize; }
   void EndOfStream() override { is_complete_ = true; }
 
   v8::OutputStream::WriteResult WriteAsciiChunk(char* data, int size) override {
@@ -30,6 +58,294 @@ class HeapSnapshotOutputStream : public v8::OutputStream {
   bool is_complete_ = false;
 };
 
+class HeapSnapshotProgress : public v8::ActivityControl {
+ public:
+  explicit HeapSnapshotProgress(
+      const electron::HeapSnapshotProgressCallback& callback)
+      : callback_(callback) {}
+
+  // v8::ActivityControl
+  ControlOption ReportProgressValue(int done, int total) override {
+    callback_.Run(done, total);
+    return kContinue;
+  }
+
+ private:
+  electron::HeapSnapshotProgressCallback callback_;
+};
+
+// Number of bytes handed to the worker sequence but not yet written, shared
+// between V8's serializer and the worker. Either side can fail the snapshot
+// when the pipe makes no progress for too long, which wakes up the other.
+class PendingBytes : public base::RefCountedThreadSafe<PendingBytes> {
+ public:
+  explicit PendingBytes(base::TimeDelta stall_timeout)
+      : condition_(&lock_),
+        stall_timeout_(stall_timeout),
+        last_progress_(base::TimeTicks::Now()) {}
+
+  base::TimeDelta stall_timeout() const { return stall_timeout_; }
+
+  void Add(size_t size) {
+    base::AutoLock auto_lock(lock_);
+    pending_ += size;
+  }
+
+  void Remove(size_t size) {
+    base::AutoLock auto_lock(lock_);
+    pending_ -= size;
+    last_progress_ = base::TimeTicks::Now();
+    condition_.Signal();
+  }
+
+  void Fail() {
+    base::AutoLock auto_lock(lock_);
+    failed_ = true;
+    condition_.Signal();
+  }
+
+  bool HasFailed() {
+    base::AutoLock auto_lock(lock_);
+    return failed_;
+  }
+
+  // Returns false if the snapshot has failed, or once nothing has been
+  // written for |stall_timeout_| while more than |limit| bytes are pending.
+  bool WaitUntilBelow(size_t limit) {
+    base::AutoLock auto_lock(lock_);
+    while (pending_ > limit && !failed_) {
+      base::TimeDelta remaining =
+          last_progress_ + stall_timeout_ - base::TimeTicks::Now();
+      if (remaining <= base::TimeDelta()) {
+        failed_ = true;
+        break;
+      }
+      ScopedAllowBaseSyncPrimitives allow_wait;
+      condition_.TimedWait(remaining);
+    }
+    return !failed_;
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<PendingBytes>;
+  ~PendingBytes() = default;
+
+  base::Lock lock_;
+  base::ConditionVariable condition_;
+  const base::TimeDelta stall_timeout_;
+  base::TimeTicks last_progress_;
+  size_t pending_ = 0;
+  bool failed_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(PendingBytes);
+};
+
+// Writes snapshot chunks into a data pipe, gzipping them on the way when
+// asked to. Chunks that do not fit in the pipe are queued until it is
+// writable again, and the snapshot fails if the reader takes nothing for the
+// stall timeout. Created on the serializing sequence, then used and deleted
+// on the worker sequence only.
+class DataPipeChunkWriter {
+ public:
+  DataPipeChunkWriter(mojo::ScopedDataPipeProducerHandle producer,
+                      bool compress,
+                      scoped_refptr<PendingBytes> pending)
+      : producer_(std::move(producer)),
+        compress_(compress),
+        pending_(std::move(pending)),
+        buffer_(kChunkSize) {
+    if (compress_) {
+      memset(&zstream_, 0, sizeof(zstream_));
+      // Snapshots are large and very repetitive JSON, the fastest level
+      // already shrinks them several times over.
+      failed_ = deflateInit2(&zstream_, Z_BEST_SPEED, Z_DEFLATED,
+                             MAX_WBITS + 16 /* gzip header */, 8,
+                             Z_DEFAULT_STRATEGY) != Z_OK;
+    }
+  }
+
+  ~DataPipeChunkWriter() {
+    if (compress_)
+      deflateEnd(&zstream_);
+  }
+
+  void Write(std::string chunk) {
+    if (failed_ || pending_->HasFailed()) {
+      Fail();
+      return;
+    }
+    size_t size = chunk.size();
+    if (compress_) {
+      if (!Deflate(chunk.data(), chunk.size(), Z_NO_FLUSH)) {
+        Fail();
+        return;
+      }
+    } else {
+      queue_.push_back({std::move(chunk), 0});
+    }
+    // The serializer waits for the input of the chunk, whatever it
+    // compressed to.
+    queue_.back().pending_size += size;
+    Flush();
+  }
+
+  // Runs |callback| with whether the whole snapshot was written, once it
+  // was or failed, and deletes the writer.
+  void Finish(base::OnceCallback<void(bool)> callback) {
+    finish_callback_ = std::move(callback);
+    if (!failed_ && compress_ && !Deflate(nullptr, 0, Z_FINISH))
+      Fail();
+    Flush();
+  }
+
+ private:
+  struct Chunk {
+    std::string data;
+    size_t pending_size;
+    size_t offset = 0;
+  };
+
+  bool Deflate(const char* data, size_t size, int flush) {
+    zstream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    zstream_.avail_in = size;
+    // Always queue a chunk, so that the input is accounted for even when
+    // deflate keeps all of it for later.
+    queue_.push_back({std::string(), 0});
+    do {
+      zstream_.next_out = reinterpret_cast<Bytef*>(buffer_.data());
+      zstream_.avail_out = buffer_.size();
+      if (deflate(&zstream_, flush) == Z_STREAM_ERROR)
+        return false;
+      size_t have = buffer_.size() - zstream_.avail_out;
+      queue_.back().data.append(buffer_.data(), have);
+    } while (zstream_.avail_out == 0);
+    return true;
+  }
+
+  // Writes as much of the queue as the pipe takes.
+  void Flush() {
+    while (!failed_ && !queue_.empty()) {
+      Chunk& chunk = queue_.front();
+      uint32_t num_bytes = chunk.data.size() - chunk.offset;
+      if (num_bytes > 0) {
+        MojoResult result = producer_->WriteData(
+            chunk.data.data() + chunk.offset, &num_bytes,
+            MOJO_WRITE_DATA_FLAG_NONE);
+        if (result == MOJO_RESULT_SHOULD_WAIT) {
+          WaitForPipe();
+          return;
+        }
+        if (result != MOJO_RESULT_OK) {
+          Fail();
+          return;
+        }
+        chunk.offset += num_bytes;
+        // The reader is making progress.
+        stall_timer_.Stop();
+        if (chunk.offset < chunk.data.size())
+          continue;
+      }
+      pending_->Remove(chunk.pending_size);
+      queue_.pop_front();
+    }
+    if (finish_callback_ && (failed_ || queue_.empty()))
+      Close();
+  }
+
+  void WaitForPipe() {
+    if (!watcher_) {
+      watcher_ = std::make_unique<mojo::SimpleWatcher>(
+          FROM_HERE, mojo::SimpleWatcher::ArmingPolicy::AUTOMATIC,
+          base::SequencedTaskRunnerHandle::Get());
+      watcher_->Watch(producer_.get(), MOJO_HANDLE_SIGNAL_WRITABLE,
+                      MOJO_WATCH_CONDITION_SATISFIED,
+                      base::BindRepeating(&DataPipeChunkWriter::OnWritable,
+                                          base::Unretained(this)));
+    }
+    if (!stall_timer_.IsRunning()) {
+      stall_timer_.Start(FROM_HERE, pending_->stall_timeout(),
+                         base::BindOnce(&DataPipeChunkWriter::Fail,
+                                        base::Unretained(this)));
+    }
+  }
+
+  void OnWritable(MojoResult result) {
+    if (result != MOJO_RESULT_OK) {
+      Fail();
+      return;
+    }
+    Flush();
+  }
+
+  // Drops what is left and closes the pipe. The serializer is told to stop.
+  void Fail() {
+    failed_ = true;
+    pending_->Fail();
+    queue_.clear();
+    stall_timer_.Stop();
+    watcher_.reset();
+    producer_.reset();
+    if (finish_callback_)
+      Close();
+  }
+
+  void Close() {
+    watcher_.reset();
+    producer_.reset();
+    std::move(finish_callback_).Run(!failed_);
+    base::SequencedTaskRunnerHandle::Get()->DeleteSoon(FROM_HERE, this);
+  }
+
+  mojo::ScopedDataPipeProducerHandle producer_;
+  bool compress_;
+  scoped_refptr<PendingBytes> pending_;
+  bool failed_ = false;
+  z_stream zstream_;
+  std::vector<char> buffer_;
+  base::circular_deque<Chunk> queue_;
+  std::unique_ptr<mojo::SimpleWatcher> watcher_;
+  base::OneShotTimer stall_timer_;
+  base::OnceCallback<void(bool)> finish_callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(DataPipeChunkWriter);
+};
+
+class DataPipeOutputStream : public v8::OutputStream {
+ public:
+  DataPipeOutputStream(scoped_refptr<base::SequencedTaskRunner> task_runner,
+                       DataPipeChunkWriter* writer,
+                       scoped_refptr<PendingBytes> pending)
+      : task_runner_(std::move(task_runner)),
+        writer_(writer),
+        pending_(std::move(pending)) {}
+
+  bool IsComplete() const { return is_complete_; }
+
+  // v8::OutputStream
+  int GetChunkSize() override { return kChunkSize; }
+  void EndOfStream() override { is_complete_ = true; }
+
+  v8::OutputStream::WriteResult WriteAsciiChunk(char* data, int size) override {
+    // Don't let a reader that stopped reading block this thread for good.
+    if (!pending_->WaitUntilBelow(kMaxPendingBytes))
+      return kAbort;
+    pending_->Add(size);
+    // |writer_| deletes itself on |task_runner_| once finished, which is
+    // after serialization.
+    task_runner_->PostTask(
+        FROM_HERE, base::BindOnce(&DataPipeChunkWriter::Write,
+                                  base::Unretained(writer_),
+                                  std::string(data, size)));
+    return kContinue;
+  }
+
+ private:
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  DataPipeChunkWriter* writer_;
+  scoped_refptr<PendingBytes> pending_;
+  bool is_complete_ = false;
+};
+
 }  // namespace
 
 namespace electron {
@@ -53,4 +369,76 @@ bool TakeHeapSnapshot(v8::Isolate* isolate, base::File* file) {
   return stream.IsComplete();
 }
 
+void TakeHeapSnapshotToDataPipe(v8::Isolate* isolate,
+                                mojo::ScopedDataPipeProducerHandle producer,
+                                bool compress,
+                                base::TimeDelta stall_timeout,
+                                const HeapSnapshotProgressCallback& progress,
+                                base::OnceCallback<void(bool)> callback) {
+  DCHECK(isolate);
+
+  HeapSnapshotProgress control(progress);
+  auto* snapshot = isolate->GetHeapProfiler()->TakeHeapSnapshot(
+      progress.is_null() ? nullptr : &control);
+  if (!snapshot) {
+    std::move(callback).Run(false);
+    return;
+  }
+
+  auto task_runner = base::CreateSequencedTaskRunner(
+      {base::ThreadPool(), base::TaskPriority::USER_VISIBLE});
+  auto pending = base::MakeRefCounted<PendingBytes>(stall_timeout);
+  auto* writer =
+      new DataPipeChunkWriter(std::move(producer), compress, pending);
+
+  DataPipeOutputStream stream(task_runner, writer, pending);
+  snapshot->Serialize(&stream, v8::HeapSnapshot::kJSON);
+
+  const_cast<v8::HeapSnapshot*>(snapshot)->Delete();
+
+  task_runner->PostTask(
+      FROM_HERE,
+      base::BindOnce(
+          &DataPipeChunkWriter::Finish, base::Unretained(writer),
+          base::BindOnce(
+              [](scoped_refptr<base::SequencedTaskRunner> reply_runner,
+                 bool is_complete, base::OnceCallback<void(bool)> callback,
+                 bool success) {
+                reply_runner->PostTask(
+                    FROM_HERE, base::BindOnce(std::move(callback),
+                                              is_complete && success));
+              },
+              base::SequencedTaskRunnerHandle::Get(), stream.IsComplete(),
+              std::move(callback))));
+}
+
+bool WriteDataPipeToFile(mojo::ScopedDataPipeConsumerHandle consumer,
+                         base::File file) {
+  if (!file.IsValid())
+    return false;
+
+  while (true) {
+    const void* buffer = nullptr;
+    uint32_t num_bytes = 0;
+    MojoResult result =
+        consumer->BeginReadData(&buffer, &num_bytes, MOJO_READ_DATA_FLAG_NONE);
+    if (result == MOJO_RESULT_SHOULD_WAIT) {
+      result = mojo::Wait(consumer.get(), MOJO_HANDLE_SIGNAL_READABLE);
+      if (result == MOJO_RESULT_OK)
+        continue;
+    }
+    // The producer has been closed and everything has been read.
+    if (result == MOJO_RESULT_FAILED_PRECONDITION)
+      return true;
+    if (result != MOJO_RESULT_OK)
+      return false;
+
+    int written =
+        file.WriteAtCurrentPos(static_cast<const char*>(buffer), num_bytes);
+    consumer->EndReadData(num_bytes);
+    if (written != static_cast<int>(num_bytes))
+      return false;
+  }
+}
+
 }  // namespace electron
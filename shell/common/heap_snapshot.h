@@ -5,13 +5,40 @@
 #ifndef SHELL_COMMON_HEAP_SNAPSHOT_H_
 #define SHELL_COMMON_HEAP_SNAPSHOT_H_
 
+#include "base/callback.h"
 #include "base/files/file.h"
+#include "base/time/time.h"
+#include "mojo/public/cpp/system/data_pipe.h"
 #include "v8/include/v8.h"
 
 namespace electron {
 
 bool TakeHeapSnapshot(v8::Isolate* isolate, base::File* file);
 
+// Called with the number of heap objects processed so far and the total while
+// the snapshot is being built.
+using HeapSnapshotProgressCallback =
+    base::RepeatingCallback<void(uint32_t done, uint32_t total)>;
+
+// Takes a heap snapshot of |isolate| and streams it into |producer|. V8 hands
+// the serialized chunks over to a worker sequence, which gzips them when
+// |compress| is true and writes them to the pipe while serialization goes on.
+// |callback| is run on the calling sequence once the pipe has been closed.
+// If the reader takes nothing from the pipe for |stall_timeout|, the pipe is
+// closed and the snapshot fails, instead of blocking |isolate|'s thread for as
+// long as the reader is paused.
+void TakeHeapSnapshotToDataPipe(v8::Isolate* isolate,
+                                mojo::ScopedDataPipeProducerHandle producer,
+                                bool compress,
+                                base::TimeDelta stall_timeout,
+                                const HeapSnapshotProgressCallback& progress,
+                                base::OnceCallback<void(bool)> callback);
+
+// Reads |consumer| until its producer is closed and appends the data to
+// |file|. This blocks, so it must run on a sequence that allows it.
+bool WriteDataPipeToFile(mojo::ScopedDataPipeConsumerHandle consumer,
+                         base::File file);
+
 }  // namespace electron
 
 #endif  // SHELL_COMMON_HEAP_SNAPSHOT_H_
@@ -0,0 +1,170 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/ipc_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "base/bits.h"
+#include "base/no_destructor.h"
+#include "base/strings/string_number_conversions.h"
+
+namespace electron {
+
+namespace {
+
+// Channels seen after this many are counted together, so that apps using a
+// new channel name for every message don't grow the stats without bound.
+const size_t kMaxChannels = 512;
+const char kOverflowChannel[] = "*";
+
+double MicrosecondsToMilliseconds(uint64_t value) {
+  return value / static_cast<double>(base::Time::kMicrosecondsPerMillisecond);
+}
+
+}  // namespace
+
+LatencyHistogram::LatencyHistogram() = default;
+
+LatencyHistogram::~LatencyHistogram() = default;
+
+void LatencyHistogram::Record(base::TimeDelta latency) {
+  uint64_t value = std::max<int64_t>(latency.InMicroseconds(), 0);
+  buckets_[BucketForValue(value)]++;
+  count_++;
+  sum_ += value;
+  min_ = std::min(min_, value);
+  max_ = std::max(max_, value);
+}
+
+base::Value LatencyHistogram::ToValue() const {
+  base::Value result(base::Value::Type::DICTIONARY);
+  result.SetDoubleKey("count", count_);
+  if (count_ == 0)
+    return result;
+  result.SetDoubleKey("min", MicrosecondsToMilliseconds(min_));
+  result.SetDoubleKey("max", MicrosecondsToMilliseconds(max_));
+  result.SetDoubleKey("mean", MicrosecondsToMilliseconds(sum_) / count_);
+  for (int percentile : {50, 90, 99}) {
+    result.SetDoubleKey(
+        "p" + base::NumberToString(percentile),
+        MicrosecondsToMilliseconds(ValueAtPercentile(percentile)));
+  }
+  return result;
+}
+
+// static
+size_t LatencyHistogram::BucketForValue(uint64_t value) {
+  if (value < kSubBucketCount)
+    return value;
+  int exponent = 63 - base::bits::CountLeadingZeroBits(value);
+  if (exponent > kMaxExponent)
+    return kBucketCount - 1;
+  // The |kSubBucketBits| bits following the leading one pick the sub-bucket.
+  size_t sub_bucket = (value >> (exponent - kSubBucketBits)) - kSubBucketCount;
+  return kSubBucketCount * (exponent - kSubBucketBits + 1) + sub_bucket;
+}
+
+// static
+uint64_t LatencyHistogram::LowestValueInBucket(size_t bucket) {
+  if (bucket < kSubBucketCount)
+    return bucket;
+  int exponent = bucket / kSubBucketCount + kSubBucketBits - 1;
+  uint64_t sub_bucket = bucket % kSubBucketCount;
+  return (kSubBucketCount + sub_bucket) << (exponent - kSubBucketBits);
+}
+
+uint64_t LatencyHistogram::ValueAtPercentile(double percentile) const {
+  auto target = static_cast<uint64_t>(std::ceil(count_ * percentile / 100));
+  target = std::max<uint64_t>(target, 1);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    seen += buckets_[i];
+    if (seen >= target)
+      return std::min(std::max(LowestValueInBucket(i), min_), max_);
+  }
+  return max_;
+}
+
+struct IpcStats::ChannelStats {
+  uint64_t sent_count = 0;
+  uint64_t sent_bytes = 0;
+  uint64_t received_count = 0;
+  uint64_t received_bytes = 0;
+  // Only allocated for the channels that are used with invoke or sendSync.
+  std::unique_ptr<LatencyHistogram> invoke;
+  std::unique_ptr<LatencyHistogram> send_sync;
+};
+
+IpcStats::IpcStats() = default;
+
+IpcStats::~IpcStats() = default;
+
+// static
+IpcStats* IpcStats::GetInstance() {
+  static base::NoDestructor<IpcStats> instance;
+  return instance.get();
+}
+
+void IpcStats::RecordSent(const std::string& channel, size_t bytes) {
+  auto* stats = GetChannelStats(channel);
+  stats->sent_count++;
+  stats->sent_bytes += bytes;
+}
+
+void IpcStats::RecordReceived(const std::string& channel, size_t bytes) {
+  auto* stats = GetChannelStats(channel);
+  stats->received_count++;
+  stats->received_bytes += bytes;
+}
+
+void IpcStats::RecordInvoke(const std::string& channel,
+                            base::TimeDelta latency) {
+  auto* stats = GetChannelStats(channel);
+  if (!stats->invoke)
+    stats->invoke = std::make_unique<LatencyHistogram>();
+  stats->invoke->Record(latency);
+}
+
+void IpcStats::RecordSendSync(const std::string& channel,
+                              base::TimeDelta latency) {
+  auto* stats = GetChannelStats(channel);
+  if (!stats->send_sync)
+    stats->send_sync = std::make_unique<LatencyHistogram>();
+  stats->send_sync->Record(latency);
+}
+
+base::Value IpcStats::ToValue() const {
+  base::Value result(base::Value::Type::DICTIONARY);
+  for (const auto& it : channels_) {
+    const ChannelStats& stats = *it.second;
+    base::Value channel(base::Value::Type::DICTIONARY);
+    channel.SetDoubleKey("sentCount", stats.sent_count);
+    channel.SetDoubleKey("sentBytes", stats.sent_bytes);
+    channel.SetDoubleKey("receivedCount", stats.received_count);
+    channel.SetDoubleKey("receivedBytes", stats.received_bytes);
+    if (stats.invoke)
+      channel.SetKey("invoke", stats.invoke->ToValue());
+    if (stats.send_sync)
+      channel.SetKey("sendSync", stats.send_sync->ToValue());
+    result.SetKey(it.first, std::move(channel));
+  }
+  return result;
+}
+
+IpcStats::ChannelStats* IpcStats::GetChannelStats(const std::string& channel) {
+  auto it = channels_.find(channel);
+  if (it != channels_.end())
+    return it->second.get();
+  std::string key =
+      channels_.size() < kMaxChannels ? channel : kOverflowChannel;
+  auto& stats = channels_[key];
+  if (!stats)
+    stats = std::make_unique<ChannelStats>();
+  return stats.get();
+}
+
+}  // namespace electron
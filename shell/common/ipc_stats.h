@@ -0,0 +1,87 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_IPC_STATS_H_
+#define SHELL_COMMON_IPC_STATS_H_
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "base/values.h"
+
+namespace electron {
+
+// Log-linear histogram of latencies in microseconds in the spirit of
+// HdrHistogram: every power of two is split into 16 linear sub-buckets, so
+// any value is kept with a relative error below 1/16 in a fixed 2 KiB.
+class LatencyHistogram {
+ public:
+  LatencyHistogram();
+  ~LatencyHistogram();
+
+  void Record(base::TimeDelta latency);
+
+  // Returns the count, and the min, max, mean and percentiles in
+  // milliseconds.
+  base::Value ToValue() const;
+
+ private:
+  static constexpr int kSubBucketBits = 4;
+  static constexpr int kSubBucketCount = 1 << kSubBucketBits;
+  // Values of 2^37us (~38 hours) and above land in the last bucket.
+  static constexpr int kMaxExponent = 36;
+  static constexpr size_t kBucketCount =
+      kSubBucketCount * (kMaxExponent - kSubBucketBits + 2);
+
+  static size_t BucketForValue(uint64_t value);
+  static uint64_t LowestValueInBucket(size_t bucket);
+
+  uint64_t ValueAtPercentile(double percentile) const;
+
+  std::array<uint32_t, kBucketCount> buckets_ = {};
+  uint64_t count_ = 0;
+  uint64_t sum_ = 0;
+  uint64_t min_ = UINT64_MAX;
+  uint64_t max_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(LatencyHistogram);
+};
+
+// Per-channel IPC message counts, payload bytes and round-trip latencies.
+// It is not thread-safe and must be used on the thread that sends and
+// receives the messages.
+class IpcStats {
+ public:
+  IpcStats();
+  ~IpcStats();
+
+  // Returns the instance shared by all the frames of a renderer process.
+  static IpcStats* GetInstance();
+
+  void RecordSent(const std::string& channel, size_t bytes);
+  void RecordReceived(const std::string& channel, size_t bytes);
+  void RecordInvoke(const std::string& channel, base::TimeDelta latency);
+  void RecordSendSync(const std::string& channel, base::TimeDelta latency);
+
+  // Returns a dictionary of IPCChannelStats keyed by channel.
+  base::Value ToValue() const;
+
+ private:
+  struct ChannelStats;
+
+  ChannelStats* GetChannelStats(const std::string& channel);
+
+  std::unordered_map<std::string, std::unique_ptr<ChannelStats>> channels_;
+
+  DISALLOW_COPY_AND_ASSIGN(IpcStats);
+};
+
+}  // namespace electron
+
+#endif  // SHELL_COMMON_IPC_STATS_H_
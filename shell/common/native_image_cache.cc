@@ -0,0 +1,105 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/native_image_cache.h"
+
+#include <iterator>
+#include <utility>
+
+namespace electron {
+
+namespace {
+
+// Enough for a few hundred thumbnails, or a dozen of full screen images.
+constexpr size_t kDefaultLimit = 64 * 1024 * 1024;
+
+}  // namespace
+
+// static
+NativeImageCache* NativeImageCache::GetInstance() {
+  static base::NoDestructor<NativeImageCache> instance;
+  return instance.get();
+}
+
+NativeImageCache::NativeImageCache()
+    : cache_(base::MRUCache<Key, SkBitmap>::NO_AUTO_EVICT),
+      limit_(kDefaultLimit) {}
+
+NativeImageCache::~NativeImageCache() = default;
+
+bool NativeImageCache::Get(const base::FilePath& path,
+                           base::Time last_modified,
+                           int64_t file_size,
+                           float scale_factor,
+                           SkBitmap* bitmap) {
+  base::AutoLock auto_lock(lock_);
+  auto it = cache_.Get(
+      std::make_tuple(path, last_modified, file_size, scale_factor));
+  if (it == cache_.end()) {
+    misses_++;
+    return false;
+  }
+  hits_++;
+  *bitmap = it->second;
+  return true;
+}
+
+void NativeImageCache::Put(const base::FilePath& path,
+                           base::Time last_modified,
+                           int64_t file_size,
+                           float scale_factor,
+                           const SkBitmap& bitmap) {
+  size_t bytes = bitmap.computeByteSize();
+  base::AutoLock auto_lock(lock_);
+  if (bytes > limit_)
+    return;
+
+  Key key = std::make_tuple(path, last_modified, file_size, scale_factor);
+  auto it = cache_.Peek(key);
+  if (it != cache_.end()) {
+    size_ -= it->second.computeByteSize();
+    cache_.Erase(it);
+  }
+
+  // The pixels are shared with the images created from the cache.
+  SkBitmap cached = bitmap;
+  cached.setImmutable();
+  cache_.Put(std::move(key), std::move(cached));
+  size_ += bytes;
+  Trim();
+}
+
+void NativeImageCache::SetLimit(size_t limit) {
+  base::AutoLock auto_lock(lock_);
+  limit_ = limit;
+  Trim();
+}
+
+void NativeImageCache::Clear() {
+  base::AutoLock auto_lock(lock_);
+  cache_.Clear();
+  size_ = 0;
+}
+
+base::Value NativeImageCache::GetStats() {
+  base::AutoLock auto_lock(lock_);
+  base::Value stats(base::Value::Type::DICTIONARY);
+  stats.SetDoubleKey("size", size_);
+  stats.SetDoubleKey("limit", limit_);
+  stats.SetIntKey("count", cache_.size());
+  stats.SetDoubleKey("hits", hits_);
+  stats.SetDoubleKey("misses", misses_);
+  return stats;
+}
+
+void NativeImageCache::Trim() {
+  lock_.AssertAcquired();
+  while (size_ > limit_ && !cache_.empty()) {
+    auto oldest = std::prev(cache_.end());
+    size_ -= oldest->second.computeByteSize();
+    cache_.Erase(oldest);
+  }
+}
+
+}  // namespace electron
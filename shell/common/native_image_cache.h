@@ -0,0 +1,75 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_NATIVE_IMAGE_CACHE_H_
+#define SHELL_COMMON_NATIVE_IMAGE_CACHE_H_
+
+#include <tuple>
+
+#include "base/containers/mru_cache.h"
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/no_destructor.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+
+namespace electron {
+
+// Images decoded from files, shared by the whole process so that loading the
+// same file again does not read and decode it. Entries are keyed by the
+// modification time and size of the file, and the least recently used ones are
+// evicted once the decoded pixels take more than the limit. It can be used
+// from any thread.
+class NativeImageCache {
+ public:
+  static NativeImageCache* GetInstance();
+
+  // Returns whether the bitmap decoded from |path| at |scale_factor|, when it
+  // was last modified at |last_modified| and was |file_size| bytes long, is
+  // in the cache.
+  bool Get(const base::FilePath& path,
+           base::Time last_modified,
+           int64_t file_size,
+           float scale_factor,
+           SkBitmap* bitmap);
+  void Put(const base::FilePath& path,
+           base::Time last_modified,
+           int64_t file_size,
+           float scale_factor,
+           const SkBitmap& bitmap);
+
+  // Sets the maximum size of the decoded pixels kept in the cache, in bytes.
+  // 0 disables the cache.
+  void SetLimit(size_t limit);
+  void Clear();
+
+  // Returns the size, limit, entry count, hits and misses of the cache.
+  base::Value GetStats();
+
+ private:
+  friend class base::NoDestructor<NativeImageCache>;
+
+  using Key = std::tuple<base::FilePath, base::Time, int64_t, float>;
+
+  NativeImageCache();
+  ~NativeImageCache();
+
+  // Evicts entries until the cache fits in |limit_|.
+  void Trim();
+
+  base::Lock lock_;
+  base::MRUCache<Key, SkBitmap> cache_;
+  size_t size_ = 0;
+  size_t limit_;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(NativeImageCache);
+};
+
+}  // namespace electron
+
+#endif  // SHELL_COMMON_NATIVE_IMAGE_CACHE_H_
@@ -5,12 +5,17 @@
 #include "shell/common/native_mate_converters/blink_converter.h"
 
 #include <algorithm>
+#include <cstring>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "base/containers/mru_cache.h"
+#include "base/no_destructor.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/threading/thread_local.h"
 #include "content/public/browser/native_web_keyboard_event.h"
 #include "gin/converter.h"
 #include "mojo/public/cpp/base/values_mojom_traits.h"
@@ -18,6 +23,7 @@
 #include "native_mate/dictionary.h"
 #include "shell/common/deprecate_util.h"
 #include "shell/common/keyboard_util.h"
+#include "shell/common/native_mate_converters/serialized_message.h"
 #include "shell/common/native_mate_converters/value_converter.h"
 #include "third_party/blink/public/common/context_menu_data/edit_flags.h"
 #include "third_party/blink/public/platform/web_input_event.h"
@@ -552,18 +558,154 @@ bool Converter<network::mojom::ReferrerPolicy>::FromV8(
 }
 
 namespace {
-constexpr uint8_t kNewSerializationTag = 0;
-constexpr uint8_t kOldSerializationTag = 1;
+using electron::serialized_message::kArrayWrappedValueTag;
+using electron::serialized_message::kNewSerializationTag;
+using electron::serialized_message::kOldSerializationTag;
+using electron::serialized_message::kResultWrappedValueTag;
+
+constexpr size_t kMaxChannelHints = 256;
+
+// Serialization buffers are pooled in power-of-two size classes between
+// these sizes, larger messages get a buffer of their own.
+constexpr size_t kMinPooledBufferSize = 4 * 1024;
+constexpr size_t kMaxPooledBufferSize = 1024 * 1024;
+constexpr size_t kMaxBuffersPerSizeClass = 2;
+
+// Buffers that messages of the current thread were serialized in, kept once
+// the messages are sent to serialize the next ones.
+class SerializationBufferPool {
+ public:
+  SerializationBufferPool() = default;
+
+  static SerializationBufferPool* Get() {
+    static base::NoDestructor<
+        base::ThreadLocalOwnedPointer<SerializationBufferPool>>
+        pool;
+    if (!pool->Get())
+      pool->Set(std::make_unique<SerializationBufferPool>());
+    return pool->Get();
+  }
+
+  // Returns a buffer of at least |size| bytes. Pooled buffers are as large as
+  // their size class, and are not cleared.
+  std::vector<uint8_t> Acquire(size_t size) {
+    int size_class = GetSizeClass(size);
+    if (size_class < 0)
+      return std::vector<uint8_t>(size);
+    auto& free_list = free_lists_[size_class];
+    if (free_list.empty())
+      return std::vector<uint8_t>(kMinPooledBufferSize << size_class);
+    std::vector<uint8_t> buffer = std::move(free_list.back());
+    free_list.pop_back();
+    return buffer;
+  }
+
+  // Takes |buffer| back if it was returned by Acquire().
+  void Release(std::vector<uint8_t> buffer) {
+    int size_class = GetSizeClass(buffer.size());
+    if (size_class < 0 || buffer.size() != kMinPooledBufferSize << size_class)
+      return;
+    auto& free_list = free_lists_[size_class];
+    if (free_list.size() < kMaxBuffersPerSizeClass)
+      free_list.push_back(std::move(buffer));
+  }
+
+ private:
+  static constexpr int kSizeClassCount = 9;
+  static_assert(kMinPooledBufferSize << (kSizeClassCount - 1) ==
+                    kMaxPooledBufferSize,
+                "The size classes must cover the pooled sizes");
+
+  // Returns the smallest size class holding |size| bytes, or -1 when it is
+  // not pooled.
+  static int GetSizeClass(size_t size) {
+    for (int i = 0; i < kSizeClassCount; i++) {
+      if (size <= kMinPooledBufferSize << i)
+        return i;
+    }
+    return -1;
+  }
+
+  std::vector<std::vector<uint8_t>> free_lists_[kSizeClassCount];
+
+  DISALLOW_COPY_AND_ASSIGN(SerializationBufferPool);
+};
+
+// What was learned from the previous messages sent on each channel of the
+// current thread. Serializing a message then usually takes a single
+// allocation, instead of growing a fresh buffer a dozen times.
+class IPCChannelHints {
+ public:
+  struct Hint {
+    size_t size = 0;
+    bool needed_old_serialization = false;
+  };
+
+  IPCChannelHints() : hints_(kMaxChannelHints) {}
+
+  static IPCChannelHints* Get() {
+    static base::NoDestructor<base::ThreadLocalOwnedPointer<IPCChannelHints>>
+        hints;
+    if (!hints->Get())
+      hints->Set(std::make_unique<IPCChannelHints>());
+    return hints->Get();
+  }
+
+  Hint* GetHint(const std::string& channel) {
+    auto it = hints_.Get(channel);
+    if (it == hints_.end())
+      it = hints_.Put(channel, Hint());
+    return &it->second;
+  }
+
+ private:
+  base::MRUCache<std::string, Hint> hints_;
+
+  DISALLOW_COPY_AND_ASSIGN(IPCChannelHints);
+};
+
+// Returns whether one of the IPC arguments |args| can not be cloned by the
+// ValueSerializer, so that the message can go straight to the old
+// serialization instead of failing half-way through the new one. Only the
+// types of the arguments are looked at: reading their properties could run
+// getters and proxy traps, which the serialization runs again.
+bool HasNonCloneableArgument(v8::Local<v8::Context> context,
+                             v8::Local<v8::Value> args) {
+  if (!args->IsArray())
+    return false;
+  v8::Local<v8::Array> array = args.As<v8::Array>();
+  for (uint32_t i = 0; i < array->Length(); i++) {
+    v8::Local<v8::Value> value;
+    if (!array->Get(context, i).ToLocal(&value))
+      return false;
+    if (value->IsSymbol() || value->IsFunction() || value->IsPromise() ||
+        value->IsProxy() || value->IsWeakMap() || value->IsWeakSet() ||
+        value->IsGeneratorObject())
+      return true;
+    // Objects wrapping native objects, like DOM nodes, are host objects.
+    if (value->IsObject() && value.As<v8::Object>()->InternalFieldCount() > 0)
+      return true;
+  }
+  return false;
+}
 
 class V8Serializer : public v8::ValueSerializer::Delegate {
  public:
   explicit V8Serializer(v8::Isolate* isolate,
-                        bool use_old_serialization = false)
+                        bool use_old_serialization = false,
+                        SerializationBufferPool* pool = nullptr,
+                        size_t size_hint = 0)
       : isolate_(isolate),
+        pool_(pool),
+        size_hint_(size_hint),
         serializer_(isolate, this),
         use_old_serialization_(use_old_serialization) {}
   ~V8Serializer() override = default;
 
+  // Whether the old serialization was used, possibly after the new one
+  // failed.
+  bool used_old_serialization() const { return use_old_serialization_; }
+
   bool Serialize(v8::Local<v8::Value> value, blink::CloneableMessage* out) {
     serializer_.WriteHeader();
     if (use_old_serialization_) {
@@ -580,7 +722,9 @@ class V8Serializer : public v8::ValueSerializer::Delegate {
       if (!serializer_.WriteValue(isolate_->GetCurrentContext(), value)
                .To(&wrote_value)) {
         try_catch.Reset();
-        if (!V8Serializer(isolate_, true).Serialize(value, out)) {
+        use_old_serialization_ = true;
+        if (!V8Serializer(isolate_, true, pool_, size_hint_)
+                 .Serialize(value, out)) {
           try_catch.ReThrow();
           return false;
         }
@@ -591,8 +735,17 @@ class V8Serializer : public v8::ValueSerializer::Delegate {
 
     std::pair<uint8_t*, size_t> buffer = serializer_.Release();
     DCHECK_EQ(buffer.first, data_.data());
-    out->encoded_message = base::make_span(buffer.first, buffer.second);
-    out->owned_encoded_message = std::move(data_);
+    if (pool_) {
+      // The message keeps the whole pooled buffer, which goes back to the
+      // pool once the message is sent.
+      out->owned_encoded_message = std::move(data_);
+      out->encoded_message =
+          base::make_span(out->owned_encoded_message.data(), buffer.second);
+    } else {
+      data_.resize(buffer.second);
+      out->owned_encoded_message = std::move(data_);
+      out->encoded_message = out->owned_encoded_message;
+    }
 
     return true;
   }
@@ -624,14 +777,29 @@ class V8Serializer : public v8::ValueSerializer::Delegate {
   void* ReallocateBufferMemory(void* old_buffer,
                                size_t size,
                                size_t* actual_size) override {
-    DCHECK_EQ(old_buffer, data_.data());
-    data_.resize(size);
-    *actual_size = data_.capacity();
+    DCHECK(!old_buffer || old_buffer == data_.data());
+    // Start with the size of the previous message on the channel, so that
+    // messages of similar sizes take a single allocation.
+    if (!old_buffer)
+      size = std::max(size, size_hint_);
+    if (!pool_) {
+      data_.resize(size);
+    } else if (size > data_.size()) {
+      std::vector<uint8_t> buffer = pool_->Acquire(size);
+      if (old_buffer) {
+        memcpy(buffer.data(), data_.data(), data_.size());
+        pool_->Release(std::move(data_));
+      }
+      data_ = std::move(buffer);
+    }
+    *actual_size = data_.size();
     return data_.data();
   }
 
   void FreeBufferMemory(void* buffer) override {
     DCHECK_EQ(buffer, data_.data());
+    if (pool_)
+      pool_->Release(std::move(data_));
     data_ = {};
   }
 
@@ -641,6 +809,9 @@ class V8Serializer : public v8::ValueSerializer::Delegate {
 
  private:
   v8::Isolate* isolate_;
+  // Where |data_| comes from, if it is pooled.
+  SerializationBufferPool* pool_;
+  size_t size_hint_;
   std::vector<uint8_t> data_;
   v8::ValueSerializer serializer_;
   bool use_old_serialization_;
@@ -673,6 +844,28 @@ class V8Deserializer : public v8::ValueDeserializer::Delegate {
         }
         return scope.Escape(value);
       }
+      case kArrayWrappedValueTag: {
+        v8::Local<v8::Value> value;
+        if (!deserializer_.ReadValue(context).ToLocal(&value)) {
+          return v8::Null(isolate_);
+        }
+        return scope.Escape(v8::Array::New(isolate_, &value, 1));
+      }
+      case kResultWrappedValueTag: {
+        v8::Local<v8::Value> value;
+        if (!deserializer_.ReadValue(context).ToLocal(&value)) {
+          return v8::Null(isolate_);
+        }
+        v8::Local<v8::Object> result = v8::Object::New(isolate_);
+        if (!result
+                 ->CreateDataProperty(context,
+                                      mate::StringToV8(isolate_, "result"),
+                                      value)
+                 .FromMaybe(false)) {
+          return v8::Null(isolate_);
+        }
+        return scope.Escape(result);
+      }
       case kOldSerializationTag: {
         v8::Local<v8::Value> value;
         if (!ReadBaseValue(&value)) {
@@ -731,4 +924,34 @@ bool Converter<blink::CloneableMessage>::FromV8(v8::Isolate* isolate,
   return V8Serializer(isolate).Serialize(val, out);
 }
 
+bool ConvertIPCMessageFromV8(v8::Isolate* isolate,
+                             v8::Local<v8::Value> val,
+                             const std::string& channel,
+                             blink::CloneableMessage* out) {
+  IPCChannelHints::Hint* hint = IPCChannelHints::Get()->GetHint(channel);
+
+  // Only look for non-cloneable arguments on channels that needed them
+  // before, other messages rarely have any.
+  bool use_old_serialization =
+      hint->needed_old_serialization &&
+      HasNonCloneableArgument(isolate->GetCurrentContext(), val);
+
+  V8Serializer serializer(isolate, use_old_serialization,
+                          SerializationBufferPool::Get(), hint->size);
+  if (!serializer.Serialize(val, out))
+    return false;
+
+  // |hint| may have been evicted while serializing.
+  hint = IPCChannelHints::Get()->GetHint(channel);
+  hint->size = out->encoded_message.size();
+  hint->needed_old_serialization = serializer.used_old_serialization();
+  return true;
+}
+
+void ReleaseIPCMessageBuffer(blink::CloneableMessage* message) {
+  SerializationBufferPool::Get()->Release(
+      std::move(message->owned_encoded_message));
+  *message = blink::CloneableMessage();
+}
+
 }  // namespace mate
@@ -5,6 +5,8 @@
 #ifndef SHELL_COMMON_NATIVE_MATE_CONVERTERS_BLINK_CONVERTER_H_
 #define SHELL_COMMON_NATIVE_MATE_CONVERTERS_BLINK_CONVERTER_H_
 
+#include <string>
+
 #include "native_mate/converter.h"
 #include "third_party/blink/public/common/messaging/cloneable_message.h"
 #include "third_party/blink/public/common/web_cache/web_cache_resource_type_stats.h"
@@ -139,6 +141,21 @@ struct Converter<blink::CloneableMessage> {
                      blink::CloneableMessage* out);
 };
 
+// Like ConvertFromV8 for a message sent on the IPC |channel|, sized and
+// serialized after the previous messages of the channel. |out| is encoded in
+// a buffer of the serialization pool of the current thread: send a
+// ShallowClone() of it, then give the buffer back with
+// ReleaseIPCMessageBuffer().
+bool ConvertIPCMessageFromV8(v8::Isolate* isolate,
+                             v8::Local<v8::Value> val,
+                             const std::string& channel,
+                             blink::CloneableMessage* out);
+
+// Gives the buffer of |message|, converted by ConvertIPCMessageFromV8 and
+// sent since, back to the serialization pool of the current thread. |message|
+// is empty afterwards.
+void ReleaseIPCMessageBuffer(blink::CloneableMessage* message);
+
 v8::Local<v8::Value> EditFlagsToV8(v8::Isolate* isolate, int editFlags);
 v8::Local<v8::Value> MediaFlagsToV8(v8::Isolate* isolate, int mediaFlags);
 
@@ -0,0 +1,30 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/native_mate_converters/serialized_message.h"
+
+namespace electron {
+
+namespace serialized_message {
+
+size_t GetHeaderSize(base::span<const uint8_t> data) {
+  if (data.empty() || data[0] != kVersionTag)
+    return 0;
+  // The version is a varint of at most 5 bytes.
+  for (size_t i = 1; i < data.size() && i <= 5; i++) {
+    if (!(data[i] & 0x80))
+      return i + 1;
+  }
+  return 0;
+}
+
+bool IsNewSerialization(base::span<const uint8_t> data) {
+  size_t header_size = GetHeaderSize(data);
+  return header_size && header_size < data.size() &&
+         data[header_size] == kNewSerializationTag;
+}
+
+}  // namespace serialized_message
+
+}  // namespace electron
@@ -0,0 +1,42 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_NATIVE_MATE_CONVERTERS_SERIALIZED_MESSAGE_H_
+#define SHELL_COMMON_NATIVE_MATE_CONVERTERS_SERIALIZED_MESSAGE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base/containers/span.h"
+
+namespace electron {
+
+namespace serialized_message {
+
+// The IPC messages written by blink_converter.cc start with the V8
+// ValueSerializer header, then a tag telling whether the value was written by
+// the ValueSerializer or as a base::Value.
+constexpr uint8_t kVersionTag = 0xFF;
+constexpr uint8_t kNewSerializationTag = 0;
+constexpr uint8_t kOldSerializationTag = 1;
+// Written by the native IPC handlers of the main process, the value written
+// by the ValueSerializer is read as [value] or {result: value}. Wrapping the
+// value in the serialized data instead would shift the ids of the objects it
+// references more than once.
+constexpr uint8_t kArrayWrappedValueTag = 2;
+constexpr uint8_t kResultWrappedValueTag = 3;
+
+// Returns the size of the ValueSerializer header at the start of |data|, or
+// 0 if there is none.
+size_t GetHeaderSize(base::span<const uint8_t> data);
+
+// Whether the value in |data| was written by the ValueSerializer, rather than
+// as a base::Value.
+bool IsNewSerialization(base::span<const uint8_t> data);
+
+}  // namespace serialized_message
+
+}  // namespace electron
+
+#endif  // SHELL_COMMON_NATIVE_MATE_CONVERTERS_SERIALIZED_MESSAGE_H_
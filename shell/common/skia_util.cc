@@ -2,14 +2,18 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "base/files/file_util.h"
 #include "base/strings/pattern.h"
 #include "base/strings/string_util.h"
 #include "base/threading/thread_restrictions.h"
 #include "net/base/data_url.h"
+#include "shell/common/asar/archive.h"
 #include "shell/common/asar/asar_util.h"
+#include "shell/common/native_image_cache.h"
 #include "shell/common/node_includes.h"
 #include "shell/common/skia_util.h"
 #include "third_party/skia/include/core/SkBitmap.h"
@@ -118,9 +122,55 @@ bool AddImageSkiaRepFromBuffer(gfx::ImageSkia* image,
   return true;
 }
 
-bool AddImageSkiaRepFromPath(gfx::ImageSkia* image,
-                             const base::FilePath& path,
-                             double scale_factor) {
+// Returns the size of the file at |path|, and when it, or the asar archive it
+// is in, was last modified.
+bool GetFileVersion(const base::FilePath& path,
+                    base::Time* last_modified,
+                    int64_t* size) {
+  base::FilePath asar_path, relative_path;
+  base::File::Info info;
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  if (asar::GetAsarArchivePath(path, &asar_path, &relative_path)) {
+    std::shared_ptr<asar::Archive> archive =
+        asar::GetOrCreateAsarArchive(asar_path);
+    asar::Archive::Stats stats;
+    if (!archive || !archive->Stat(relative_path, &stats) ||
+        stats.is_directory || !base::GetFileInfo(asar_path, &info))
+      return false;
+    *size = stats.size;
+  } else if (!base::GetFileInfo(path, &info) || info.is_directory) {
+    return false;
+  } else {
+    *size = info.size;
+  }
+  *last_modified = info.last_modified;
+  return true;
+}
+
+bool ReadImageSkiaRepFromPath(const base::FilePath& path,
+                              float scale_factor,
+                              std::vector<gfx::ImageSkiaRep>* reps) {
+  base::Time last_modified;
+  int64_t file_size;
+  if (!GetFileVersion(path, &last_modified, &file_size))
+    return false;
+
+  // Relative paths depend on the working directory.
+  base::FilePath cache_key = path;
+  if (!path.IsAbsolute()) {
+    base::ThreadRestrictions::ScopedAllowIO allow_io;
+    base::FilePath absolute_path = base::MakeAbsoluteFilePath(path);
+    if (!absolute_path.empty())
+      cache_key = absolute_path;
+  }
+
+  auto* cache = NativeImageCache::GetInstance();
+  SkBitmap bitmap;
+  if (cache->Get(cache_key, last_modified, file_size, scale_factor, &bitmap)) {
+    reps->emplace_back(bitmap, scale_factor);
+    return true;
+  }
+
   std::string file_contents;
   {
     base::ThreadRestrictions::ScopedAllowIO allow_io;
@@ -132,23 +182,38 @@ bool AddImageSkiaRepFromPath(gfx::ImageSkia* image,
       reinterpret_cast<const unsigned char*>(file_contents.data());
   size_t size = file_contents.size();
 
-  return AddImageSkiaRepFromBuffer(image, data, size, 0, 0, scale_factor);
+  gfx::ImageSkia image;
+  if (!AddImageSkiaRepFromBuffer(&image, data, size, 0, 0, scale_factor))
+    return false;
+  bitmap = image.image_reps().front().GetBitmap();
+  cache->Put(cache_key, last_modified, file_size, scale_factor, bitmap);
+  reps->emplace_back(bitmap, scale_factor);
+  return true;
 }
 
-bool PopulateImageSkiaRepsFromPath(gfx::ImageSkia* image,
-                                   const base::FilePath& path) {
-  bool succeed = false;
+std::vector<gfx::ImageSkiaRep> ReadImageSkiaRepsFromPath(
+    const base::FilePath& path) {
+  std::vector<gfx::ImageSkiaRep> reps;
   std::string filename(path.BaseName().RemoveExtension().AsUTF8Unsafe());
-  if (base::MatchPattern(filename, "*@*x"))
+  if (base::MatchPattern(filename, "*@*x")) {
     // Don't search for other representations if the DPI has been specified.
-    return AddImageSkiaRepFromPath(image, path, GetScaleFactorFromPath(path));
-  else
-    succeed |= AddImageSkiaRepFromPath(image, path, 1.0f);
+    ReadImageSkiaRepFromPath(path, GetScaleFactorFromPath(path), &reps);
+    return reps;
+  }
 
+  ReadImageSkiaRepFromPath(path, 1.0f, &reps);
   for (const ScaleFactorPair& pair : kScaleFactorPairs)
-    succeed |= AddImageSkiaRepFromPath(
-        image, path.InsertBeforeExtensionASCII(pair.name), pair.scale);
-  return succeed;
+    ReadImageSkiaRepFromPath(path.InsertBeforeExtensionASCII(pair.name),
+                             pair.scale, &reps);
+  return reps;
+}
+
+bool PopulateImageSkiaRepsFromPath(gfx::ImageSkia* image,
+                                   const base::FilePath& path) {
+  std::vector<gfx::ImageSkiaRep> reps = ReadImageSkiaRepsFromPath(path);
+  for (const gfx::ImageSkiaRep& rep : reps)
+    image->AddRepresentation(rep);
+  return !reps.empty();
 }
 #if defined(OS_WIN)
 bool ReadImageSkiaFromICO(gfx::ImageSkia* image, HICON icon) {
@@ -6,6 +6,7 @@
 #define SHELL_COMMON_SKIA_UTIL_H_
 
 #include <string>
+#include <vector>
 
 #include "ui/gfx/image/image_skia.h"
 
@@ -13,6 +14,11 @@ namespace electron {
 
 namespace util {
 
+// Reads the image at |path| and its @Nx variants, going through the
+// NativeImageCache. Can be called on any thread that allows blocking.
+std::vector<gfx::ImageSkiaRep> ReadImageSkiaRepsFromPath(
+    const base::FilePath& path);
+
 bool PopulateImageSkiaRepsFromPath(gfx::ImageSkia* image,
                                    const base::FilePath& path);
 
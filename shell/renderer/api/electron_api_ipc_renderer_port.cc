@@ -0,0 +1,172 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/renderer/api/electron_api_ipc_renderer_port.h"
+
+#include <memory>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/no_destructor.h"
+#include "gin/object_template_builder.h"
+#include "shell/common/gin_converters/blink_converter_gin_adapter.h"
+#include "shell/common/gin_helper/error_thrower.h"
+#include "shell/common/ipc_stats.h"
+#include "shell/common/node_includes.h"
+
+namespace electron {
+
+namespace api {
+
+gin::WrapperInfo IPCRendererPort::kWrapperInfo = {gin::kEmbedderNativeGin};
+
+IPCRendererPort::IPCRendererPort(
+    v8::Isolate* isolate,
+    const std::string& channel,
+    mojo::PendingRemote<mojom::ElectronPeerPort> remote,
+    mojo::PendingReceiver<mojom::ElectronPeerPort> receiver)
+    : isolate_(isolate),
+      channel_(channel),
+      remote_(std::move(remote)),
+      receiver_(this, std::move(receiver)) {
+  context_.Reset(isolate, isolate->GetCurrentContext());
+  context_.SetWeak(this, &IPCRendererPort::OnContextCollected,
+                   v8::WeakCallbackType::kParameter);
+  GetOpenPorts().insert(this);
+
+  // The disconnect handlers can not outlive the pipes owned by this object.
+  remote_.set_disconnect_handler(base::BindOnce(
+      &IPCRendererPort::OnDisconnect, base::Unretained(this)));
+  receiver_.set_disconnect_handler(base::BindOnce(
+      &IPCRendererPort::OnDisconnect, base::Unretained(this)));
+}
+
+IPCRendererPort::~IPCRendererPort() {
+  GetOpenPorts().erase(this);
+}
+
+// static
+std::set<IPCRendererPort*>& IPCRendererPort::GetOpenPorts() {
+  static base::NoDestructor<std::set<IPCRendererPort*>> ports;
+  return *ports;
+}
+
+// static
+void IPCRendererPort::CloseAllInContext(v8::Local<v8::Context> context) {
+  // Close() removes the port from the set, so iterate over a copy.
+  std::set<IPCRendererPort*> ports = GetOpenPorts();
+  for (IPCRendererPort* port : ports) {
+    if (port->context_ == context)
+      port->Close();
+  }
+}
+
+// static
+void IPCRendererPort::OnContextCollected(
+    const v8::WeakCallbackInfo<IPCRendererPort>& data) {
+  IPCRendererPort* self = data.GetParameter();
+  self->context_.Reset();
+  self->Close();
+}
+
+// static
+gin::Handle<IPCRendererPort> IPCRendererPort::Create(
+    v8::Isolate* isolate,
+    const std::string& channel,
+    mojo::PendingRemote<mojom::ElectronPeerPort> remote,
+    mojo::PendingReceiver<mojom::ElectronPeerPort> receiver) {
+  return gin::CreateHandle(
+      isolate, new IPCRendererPort(isolate, channel, std::move(remote),
+                                   std::move(receiver)));
+}
+
+void IPCRendererPort::Message(blink::CloneableMessage arguments) {
+  IpcStats::GetInstance()->RecordReceived(channel_,
+                                          arguments.encoded_message.size());
+  if (on_message_.IsEmpty() || context_.IsEmpty())
+    return;
+
+  v8::HandleScope handle_scope(isolate_);
+  v8::Local<v8::Context> context = context_.Get(isolate_);
+  v8::Context::Scope context_scope(context);
+  CallHandler(on_message_, {gin::ConvertToV8(isolate_, arguments)});
+}
+
+void IPCRendererPort::PostMessage(v8::Isolate* isolate,
+                                  v8::Local<v8::Value> arguments) {
+  if (!remote_.is_bound()) {
+    gin_helper::ErrorThrower(isolate).ThrowError("The port is closed");
+    return;
+  }
+  blink::CloneableMessage message;
+  if (!mate::ConvertIPCMessageFromV8(isolate, arguments, channel_, &message))
+    return;
+  IpcStats::GetInstance()->RecordSent(channel_,
+                                      message.encoded_message.size());
+  remote_->Message(message.ShallowClone());
+  mate::ReleaseIPCMessageBuffer(&message);
+}
+
+void IPCRendererPort::SetHandlers(v8::Local<v8::Function> on_message,
+                                  v8::Local<v8::Function> on_close) {
+  on_message_.Reset(isolate_, on_message);
+  on_close_.Reset(isolate_, on_close);
+}
+
+void IPCRendererPort::Close() {
+  // The peer is told through the disconnection of the pipes.
+  remote_.reset();
+  receiver_.reset();
+  // The handlers keep the port alive while it is open.
+  on_message_.Reset();
+  on_close_.Reset();
+  GetOpenPorts().erase(this);
+}
+
+void IPCRendererPort::OnDisconnect() {
+  if (!remote_.is_bound() && !receiver_.is_bound())
+    return;
+  v8::Global<v8::Function> on_close = std::move(on_close_);
+  Close();
+  if (on_close.IsEmpty() || context_.IsEmpty())
+    return;
+
+  v8::HandleScope handle_scope(isolate_);
+  v8::Local<v8::Context> context = context_.Get(isolate_);
+  v8::Context::Scope context_scope(context);
+  CallHandler(on_close, {});
+}
+
+void IPCRendererPort::CallHandler(const v8::Global<v8::Function>& handler,
+                                  std::vector<v8::Local<v8::Value>> args) {
+  v8::Local<v8::Context> context = isolate_->GetCurrentContext();
+  v8::MicrotasksScope script_scope(isolate_,
+                                   v8::MicrotasksScope::kRunMicrotasks);
+
+  // Only set up the node::CallbackScope if there's a node environment.
+  // Sandboxed renderers don't have a node environment.
+  v8::Local<v8::Object> self = GetWrapper(isolate_).ToLocalChecked();
+  std::unique_ptr<node::CallbackScope> callback_scope;
+  if (node::Environment::GetCurrent(context))
+    callback_scope.reset(new node::CallbackScope(isolate_, self, {0, 0}));
+
+  v8::Local<v8::Function> function = handler.Get(isolate_);
+  ignore_result(function->Call(context, self, args.size(), args.data()));
+}
+
+gin::ObjectTemplateBuilder IPCRendererPort::GetObjectTemplateBuilder(
+    v8::Isolate* isolate) {
+  return gin::Wrappable<IPCRendererPort>::GetObjectTemplateBuilder(isolate)
+      .SetMethod("postMessage", &IPCRendererPort::PostMessage)
+      .SetMethod("setHandlers", &IPCRendererPort::SetHandlers)
+      .SetMethod("close", &IPCRendererPort::Close);
+}
+
+const char* IPCRendererPort::GetTypeName() {
+  return "IPCRendererPort";
+}
+
+}  // namespace api
+
+}  // namespace electron
@@ -0,0 +1,86 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_RENDERER_API_ELECTRON_API_IPC_RENDERER_PORT_H_
+#define SHELL_RENDERER_API_ELECTRON_API_IPC_RENDERER_PORT_H_
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "electron/shell/common/api/api.mojom.h"
+#include "gin/handle.h"
+#include "gin/wrappable.h"
+#include "mojo/public/cpp/bindings/pending_receiver.h"
+#include "mojo/public/cpp/bindings/pending_remote.h"
+#include "mojo/public/cpp/bindings/receiver.h"
+#include "mojo/public/cpp/bindings/remote.h"
+
+namespace electron {
+
+namespace api {
+
+// One end of a direct channel between two renderers, created with
+// ipcRenderer.connectTo(). The JavaScript IpcRendererPort wraps it.
+class IPCRendererPort : public gin::Wrappable<IPCRendererPort>,
+                        public mojom::ElectronPeerPort {
+ public:
+  static gin::WrapperInfo kWrapperInfo;
+
+  static gin::Handle<IPCRendererPort> Create(
+      v8::Isolate* isolate,
+      const std::string& channel,
+      mojo::PendingRemote<mojom::ElectronPeerPort> remote,
+      mojo::PendingReceiver<mojom::ElectronPeerPort> receiver);
+
+  // Closes the ports created in |context|, which is being released.
+  static void CloseAllInContext(v8::Local<v8::Context> context);
+
+  // gin::Wrappable:
+  gin::ObjectTemplateBuilder GetObjectTemplateBuilder(
+      v8::Isolate* isolate) override;
+  const char* GetTypeName() override;
+
+ private:
+  IPCRendererPort(v8::Isolate* isolate,
+                  const std::string& channel,
+                  mojo::PendingRemote<mojom::ElectronPeerPort> remote,
+                  mojo::PendingReceiver<mojom::ElectronPeerPort> receiver);
+  ~IPCRendererPort() override;
+
+  // The open ports of the renderer, all of them live on the main thread.
+  static std::set<IPCRendererPort*>& GetOpenPorts();
+
+  static void OnContextCollected(
+      const v8::WeakCallbackInfo<IPCRendererPort>& data);
+
+  // mojom::ElectronPeerPort:
+  void Message(blink::CloneableMessage arguments) override;
+
+  void PostMessage(v8::Isolate* isolate, v8::Local<v8::Value> arguments);
+  void SetHandlers(v8::Local<v8::Function> on_message,
+                   v8::Local<v8::Function> on_close);
+  void Close();
+
+  void OnDisconnect();
+  void CallHandler(const v8::Global<v8::Function>& handler,
+                   std::vector<v8::Local<v8::Value>> args);
+
+  v8::Isolate* isolate_;
+  std::string channel_;
+  v8::Global<v8::Context> context_;
+  v8::Global<v8::Function> on_message_;
+  v8::Global<v8::Function> on_close_;
+
+  mojo::Remote<mojom::ElectronPeerPort> remote_;
+  mojo::Receiver<mojom::ElectronPeerPort> receiver_{this};
+
+  DISALLOW_COPY_AND_ASSIGN(IPCRendererPort);
+};
+
+}  // namespace api
+
+}  // namespace electron
+
+#endif  // SHELL_RENDERER_API_ELECTRON_API_IPC_RENDERER_PORT_H_
@@ -2,9 +2,12 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <set>
 #include <string>
+#include <vector>
 
 #include "base/task/post_task.h"
+#include "base/time/time.h"
 #include "base/values.h"
 #include "content/public/renderer/render_frame.h"
 #include "content/public/renderer/render_frame_observer.h"
@@ -12,18 +15,23 @@
 #include "gin/handle.h"
 #include "gin/object_template_builder.h"
 #include "gin/wrappable.h"
+#include "mojo/public/cpp/bindings/receiver.h"
 #include "services/service_manager/public/cpp/interface_provider.h"
 #include "shell/common/api/api.mojom.h"
 #include "shell/common/gin_converters/blink_converter_gin_adapter.h"
 #include "shell/common/gin_converters/value_converter_gin_adapter.h"
 #include "shell/common/gin_helper/error_thrower.h"
+#include "shell/common/ipc_stats.h"
+#include "shell/common/native_mate_converters/serialized_message.h"
 #include "shell/common/node_bindings.h"
 #include "shell/common/node_includes.h"
 #include "shell/common/promise_util.h"
+#include "shell/renderer/api/electron_api_ipc_renderer_port.h"
 #include "third_party/blink/public/web/web_local_frame.h"
 
 using blink::WebLocalFrame;
 using content::RenderFrame;
+using electron::IpcStats;
 
 namespace {
 
@@ -39,7 +47,8 @@ RenderFrame* GetCurrentRenderFrame() {
 }
 
 class IPCRenderer : public gin::Wrappable<IPCRenderer>,
-                    public content::RenderFrameObserver {
+                    public content::RenderFrameObserver,
+                    public electron::mojom::NativeIpcChannelsObserver {
  public:
   static gin::WrapperInfo kWrapperInfo;
 
@@ -59,13 +68,23 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
         mojo::MakeRequest(&electron_browser_ptr_));
   }
 
-  void OnDestruct() override { electron_browser_ptr_.reset(); }
+  void OnDestruct() override {
+    electron_browser_ptr_.reset();
+    ResetNativeIpc();
+  }
 
   void WillReleaseScriptContext(v8::Local<v8::Context> context,
                                 int32_t world_id) override {
     if (weak_context_.IsEmpty() ||
-        weak_context_.Get(context->GetIsolate()) == context)
+        weak_context_.Get(context->GetIsolate()) == context) {
       electron_browser_ptr_.reset();
+      ResetNativeIpc();
+    }
+  }
+
+  // electron::mojom::NativeIpcChannelsObserver:
+  void OnChannelsChanged(const std::vector<std::string>& channels) override {
+    native_channels_ = std::set<std::string>(channels.begin(), channels.end());
   }
 
   // gin::Wrappable:
@@ -76,12 +95,45 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
         .SetMethod("sendSync", &IPCRenderer::SendSync)
         .SetMethod("sendTo", &IPCRenderer::SendTo)
         .SetMethod("sendToHost", &IPCRenderer::SendToHost)
+        .SetMethod("connectTo", &IPCRenderer::ConnectTo)
         .SetMethod("invoke", &IPCRenderer::Invoke);
   }
 
   const char* GetTypeName() override { return "IPCRenderer"; }
 
  private:
+  // Returns the pipe to the IPC handler thread of the main process if
+  // |channel| is handled by a native addon there, or null if |message| has to
+  // go through ElectronBrowser. The pipe is requested with the first message.
+  electron::mojom::ElectronNativeIpc* GetNativeIpc(
+      bool internal,
+      const std::string& channel,
+      const blink::CloneableMessage& message) {
+    if (internal)
+      return nullptr;
+    if (!native_ipc_requested_) {
+      native_ipc_requested_ = true;
+      // The main process closes the pipe if it has no native handlers.
+      render_frame()->GetRemoteInterfaces()->GetInterface(
+          mojo::MakeRequest(&native_ipc_ptr_));
+      native_ipc_ptr_.set_connection_error_handler(base::BindOnce(
+          &IPCRenderer::ResetNativeIpc, base::Unretained(this)));
+      native_ipc_ptr_->SetChannelsObserver(
+          channels_observer_receiver_.BindNewPipeAndPassRemote());
+    }
+    if (!native_ipc_ptr_ || !native_channels_.count(channel) ||
+        !electron::serialized_message::IsNewSerialization(
+            message.encoded_message))
+      return nullptr;
+    return native_ipc_ptr_.get();
+  }
+
+  void ResetNativeIpc() {
+    native_ipc_ptr_.reset();
+    channels_observer_receiver_.reset();
+    native_channels_.clear();
+  }
+
   void SendMessage(v8::Isolate* isolate,
                    bool internal,
                    const std::string& channel,
@@ -92,10 +144,18 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
       return;
     }
     blink::CloneableMessage message;
-    if (!mate::ConvertFromV8(isolate, arguments, &message)) {
+    if (!mate::ConvertIPCMessageFromV8(isolate, arguments, channel,
+                                       &message)) {
       return;
     }
-    electron_browser_ptr_->Message(internal, channel, std::move(message));
+    IpcStats::GetInstance()->RecordSent(channel,
+                                        message.encoded_message.size());
+    auto* native_ipc = GetNativeIpc(internal, channel, message);
+    if (native_ipc)
+      native_ipc->Message(channel, message.ShallowClone());
+    else
+      electron_browser_ptr_->Message(internal, channel, message.ShallowClone());
+    mate::ReleaseIPCMessageBuffer(&message);
   }
 
   v8::Local<v8::Promise> Invoke(v8::Isolate* isolate,
@@ -108,18 +168,32 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
       return v8::Local<v8::Promise>();
     }
     blink::CloneableMessage message;
-    if (!mate::ConvertFromV8(isolate, arguments, &message)) {
+    if (!mate::ConvertIPCMessageFromV8(isolate, arguments, channel,
+                                       &message)) {
       return v8::Local<v8::Promise>();
     }
+    IpcStats::GetInstance()->RecordSent(channel,
+                                        message.encoded_message.size());
     electron::util::Promise<blink::CloneableMessage> p(isolate);
     auto handle = p.GetHandle();
 
-    electron_browser_ptr_->Invoke(
-        internal, channel, std::move(message),
-        base::BindOnce(
-            [](electron::util::Promise<blink::CloneableMessage> p,
-               blink::CloneableMessage result) { p.ResolveWithGin(result); },
-            std::move(p)));
+    auto callback = base::BindOnce(
+        [](electron::util::Promise<blink::CloneableMessage> p,
+           const std::string& channel, base::TimeTicks start,
+           blink::CloneableMessage result) {
+          IpcStats::GetInstance()->RecordInvoke(channel,
+                                                base::TimeTicks::Now() - start);
+          p.ResolveWithGin(result);
+        },
+        std::move(p), channel, base::TimeTicks::Now());
+    auto* native_ipc = GetNativeIpc(internal, channel, message);
+    if (native_ipc) {
+      native_ipc->Invoke(channel, message.ShallowClone(), std::move(callback));
+    } else {
+      electron_browser_ptr_->Invoke(internal, channel, message.ShallowClone(),
+                                    std::move(callback));
+    }
+    mate::ReleaseIPCMessageBuffer(&message);
 
     return handle;
   }
@@ -136,11 +210,50 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
       return;
     }
     blink::CloneableMessage message;
-    if (!mate::ConvertFromV8(isolate, arguments, &message)) {
+    if (!mate::ConvertIPCMessageFromV8(isolate, arguments, channel,
+                                       &message)) {
       return;
     }
+    IpcStats::GetInstance()->RecordSent(channel,
+                                        message.encoded_message.size());
     electron_browser_ptr_->MessageTo(internal, send_to_all, web_contents_id,
-                                     channel, std::move(message));
+                                     channel, message.ShallowClone());
+    mate::ReleaseIPCMessageBuffer(&message);
+  }
+
+  v8::Local<v8::Promise> ConnectTo(v8::Isolate* isolate,
+                                   int32_t web_contents_id,
+                                   const std::string& channel) {
+    if (!electron_browser_ptr_) {
+      gin_helper::ErrorThrower(isolate).ThrowError(
+          kIPCMethodCalledAfterContextReleasedError);
+      return v8::Local<v8::Promise>();
+    }
+    electron::util::Promise<v8::Local<v8::Value>> p(isolate);
+    auto handle = p.GetHandle();
+
+    electron_browser_ptr_->ConnectTo(
+        web_contents_id, channel,
+        base::BindOnce(
+            [](electron::util::Promise<v8::Local<v8::Value>> p,
+               const std::string& channel,
+               mojo::PendingRemote<electron::mojom::ElectronPeerPort> remote,
+               mojo::PendingReceiver<electron::mojom::ElectronPeerPort>
+                   receiver) {
+              if (!remote || !receiver) {
+                p.RejectWithErrorMessage("No such WebContents");
+                return;
+              }
+              v8::Isolate* isolate = p.isolate();
+              v8::HandleScope handle_scope(isolate);
+              v8::Context::Scope context_scope(p.GetContext());
+              auto port = electron::api::IPCRendererPort::Create(
+                  isolate, channel, std::move(remote), std::move(receiver));
+              p.Resolve(port.ToV8());
+            },
+            std::move(p), channel));
+
+    return handle;
   }
 
   void SendToHost(v8::Isolate* isolate,
@@ -152,10 +265,14 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
       return;
     }
     blink::CloneableMessage message;
-    if (!mate::ConvertFromV8(isolate, arguments, &message)) {
+    if (!mate::ConvertIPCMessageFromV8(isolate, arguments, channel,
+                                       &message)) {
       return;
     }
-    electron_browser_ptr_->MessageHost(channel, std::move(message));
+    IpcStats::GetInstance()->RecordSent(channel,
+                                        message.encoded_message.size());
+    electron_browser_ptr_->MessageHost(channel, message.ShallowClone());
+    mate::ReleaseIPCMessageBuffer(&message);
   }
 
   blink::CloneableMessage SendSync(v8::Isolate* isolate,
@@ -168,18 +285,38 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
       return blink::CloneableMessage();
     }
     blink::CloneableMessage message;
-    if (!mate::ConvertFromV8(isolate, arguments, &message)) {
+    if (!mate::ConvertIPCMessageFromV8(isolate, arguments, channel,
+                                       &message)) {
       return blink::CloneableMessage();
     }
 
+    IpcStats::GetInstance()->RecordSent(channel,
+                                        message.encoded_message.size());
+    base::TimeTicks start = base::TimeTicks::Now();
     blink::CloneableMessage result;
-    electron_browser_ptr_->MessageSync(internal, channel, std::move(message),
-                                       &result);
+    auto* native_ipc = GetNativeIpc(internal, channel, message);
+    if (native_ipc) {
+      native_ipc->MessageSync(channel, message.ShallowClone(), &result);
+    } else {
+      electron_browser_ptr_->MessageSync(internal, channel,
+                                         message.ShallowClone(), &result);
+    }
+    mate::ReleaseIPCMessageBuffer(&message);
+    IpcStats::GetInstance()->RecordSendSync(channel,
+                                            base::TimeTicks::Now() - start);
     return result;
   }
 
   v8::Global<v8::Context> weak_context_;
   electron::mojom::ElectronBrowserPtr electron_browser_ptr_;
+
+  // Channels handled by native addons of the main process, and the pipe their
+  // messages are sent through.
+  bool native_ipc_requested_ = false;
+  electron::mojom::ElectronNativeIpcPtr native_ipc_ptr_;
+  mojo::Receiver<electron::mojom::NativeIpcChannelsObserver>
+      channels_observer_receiver_{this};
+  std::set<std::string> native_channels_;
 };
 
 gin::WrapperInfo IPCRenderer::kWrapperInfo = {gin::kEmbedderNativeGin};
@@ -9,15 +9,17 @@
 #include <vector>
 
 #include "base/environment.h"
+#include "base/containers/span.h"
 #include "base/macros.h"
-#include "base/threading/thread_restrictions.h"
-#include "mojo/public/cpp/system/platform_handle.h"
+#include "mojo/public/cpp/bindings/remote.h"
 #include "shell/common/electron_constants.h"
 #include "shell/common/gin_converters/blink_converter_gin_adapter.h"
 #include "shell/common/gin_converters/value_converter_gin_adapter.h"
 #include "shell/common/heap_snapshot.h"
+#include "shell/common/ipc_stats.h"
 #include "shell/common/node_includes.h"
 #include "shell/common/options_switches.h"
+#include "shell/renderer/api/electron_api_ipc_renderer_port.h"
 #include "shell/renderer/electron_render_frame_observer.h"
 #include "shell/renderer/renderer_client_base.h"
 #include "third_party/blink/public/web/blink.h"
@@ -104,12 +106,7 @@ ElectronApiServiceImpl::ElectronApiServiceImpl(
 void ElectronApiServiceImpl::BindTo(
     mojo::PendingAssociatedReceiver<mojom::ElectronRenderer> receiver) {
   // Note: BindTo might be called for multiple times.
-  if (receiver_.is_bound())
-    receiver_.reset();
-
-  receiver_.Bind(std::move(receiver));
-  receiver_.set_disconnect_handler(
-      base::BindOnce(&ElectronApiServiceImpl::OnConnectionError, GetWeakPtr()));
+  receivers_.Add(this, std::move(receiver));
 }
 
 void ElectronApiServiceImpl::DidCreateDocumentElement() {
@@ -120,16 +117,14 @@ void ElectronApiServiceImpl::OnDestruct() {
   delete this;
 }
 
-void ElectronApiServiceImpl::OnConnectionError() {
-  if (receiver_.is_bound())
-    receiver_.reset();
-}
-
 void ElectronApiServiceImpl::Message(bool internal,
                                      bool send_to_all,
                                      const std::string& channel,
                                      blink::CloneableMessage arguments,
                                      int32_t sender_id) {
+  IpcStats::GetInstance()->RecordReceived(channel,
+                                          arguments.encoded_message.size());
+
   // Don't handle browser messages before document element is created.
   //
   // Note: It is probably better to save the message and then replay it after
@@ -176,6 +171,22 @@ void ElectronApiServiceImpl::Message(bool internal,
   }
 }
 
+void ElectronApiServiceImpl::MessageFromSharedMemory(
+    bool internal,
+    const std::string& channel,
+    base::ReadOnlySharedMemoryRegion arguments,
+    int32_t sender_id) {
+  base::ReadOnlySharedMemoryMapping mapping = arguments.Map();
+  if (!mapping.IsValid())
+    return;
+
+  // The message only borrows the mapping, which outlives it.
+  blink::CloneableMessage message;
+  message.encoded_message =
+      base::make_span(mapping.GetMemoryAs<uint8_t>(), mapping.size());
+  Message(internal, false, channel, std::move(message), sender_id);
+}
+
 #if BUILDFLAG(ENABLE_REMOTE_MODULE)
 void ElectronApiServiceImpl::DereferenceRemoteJSCallback(
     const std::string& context_id,
@@ -211,24 +222,54 @@ void ElectronApiServiceImpl::UpdateCrashpadPipeName(
 #endif
 }
 
-void ElectronApiServiceImpl::TakeHeapSnapshot(
-    mojo::ScopedHandle file,
-    TakeHeapSnapshotCallback callback) {
-  base::ThreadRestrictions::ScopedAllowIO allow_io;
+void ElectronApiServiceImpl::TakeHeapSnapshotToDataPipe(
+    mojo::ScopedDataPipeProducerHandle pipe,
+    bool compress,
+    base::TimeDelta stall_timeout,
+    mojo::PendingRemote<mojom::HeapSnapshotObserver> observer,
+    TakeHeapSnapshotToDataPipeCallback callback) {
+  mojo::Remote<mojom::HeapSnapshotObserver> remote(std::move(observer));
+  // Progress is only reported while the snapshot is built, which happens
+  // synchronously inside this call.
+  electron::TakeHeapSnapshotToDataPipe(
+      blink::MainThreadIsolate(), std::move(pipe), compress, stall_timeout,
+      base::BindRepeating(
+          [](mojom::HeapSnapshotObserver* observer, uint32_t done,
+             uint32_t total) { observer->OnProgress(done, total); },
+          base::Unretained(remote.get())),
+      std::move(callback));
+}
+
+void ElectronApiServiceImpl::GetIPCStats(GetIPCStatsCallback callback) {
+  std::move(callback).Run(IpcStats::GetInstance()->ToValue());
+}
+
+void ElectronApiServiceImpl::ConnectPeer(
+    const std::string& channel,
+    mojo::PendingRemote<mojom::ElectronPeerPort> remote,
+    mojo::PendingReceiver<mojom::ElectronPeerPort> receiver,
+    int32_t sender_id) {
+  // Same as Message, dropping the ends closes the channel on the other side.
+  if (!document_created_)
+    return;
 
-  base::PlatformFile platform_file;
-  if (mojo::UnwrapPlatformFile(std::move(file), &platform_file) !=
-      MOJO_RESULT_OK) {
-    LOG(ERROR) << "Unable to get the file handle from mojo.";
-    std::move(callback).Run(false);
+  blink::WebLocalFrame* frame = render_frame()->GetWebFrame();
+  if (!frame)
     return;
-  }
-  base::File base_file(platform_file);
 
-  bool success =
-      electron::TakeHeapSnapshot(blink::MainThreadIsolate(), &base_file);
+  v8::Isolate* isolate = blink::MainThreadIsolate();
+  v8::HandleScope handle_scope(isolate);
+
+  v8::Local<v8::Context> context = renderer_client_->GetContext(frame, isolate);
+  v8::Context::Scope context_scope(context);
+  v8::MicrotasksScope script_scope(isolate,
+                                   v8::MicrotasksScope::kRunMicrotasks);
 
-  std::move(callback).Run(success);
+  auto port = api::IPCRendererPort::Create(isolate, channel, std::move(remote),
+                                           std::move(receiver));
+  InvokeIpcCallback(context, "onConnect",
+                    {gin::ConvertToV8(isolate, channel), port.ToV8(),
+                     gin::ConvertToV8(isolate, sender_id)});
 }
 
 }  // namespace electron
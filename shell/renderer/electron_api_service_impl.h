@@ -7,12 +7,13 @@
 
 #include <string>
 
+#include "base/memory/read_only_shared_memory_region.h"
 #include "base/memory/weak_ptr.h"
 #include "content/public/renderer/render_frame.h"
 #include "content/public/renderer/render_frame_observer.h"
 #include "electron/buildflags/buildflags.h"
 #include "electron/shell/common/api/api.mojom.h"
-#include "mojo/public/cpp/bindings/associated_receiver.h"
+#include "mojo/public/cpp/bindings/associated_receiver_set.h"
 #include "mojo/public/cpp/bindings/pending_associated_receiver.h"
 
 namespace electron {
@@ -33,13 +34,26 @@ class ElectronApiServiceImpl : public mojom::ElectronRenderer,
                const std::string& channel,
                blink::CloneableMessage arguments,
                int32_t sender_id) override;
+  void MessageFromSharedMemory(bool internal,
+                               const std::string& channel,
+                               base::ReadOnlySharedMemoryRegion arguments,
+                               int32_t sender_id) override;
 #if BUILDFLAG(ENABLE_REMOTE_MODULE)
   void DereferenceRemoteJSCallback(const std::string& context_id,
                                    int32_t object_id) override;
 #endif
   void UpdateCrashpadPipeName(const std::string& pipe_name) override;
-  void TakeHeapSnapshot(mojo::ScopedHandle file,
-                        TakeHeapSnapshotCallback callback) override;
+  void TakeHeapSnapshotToDataPipe(
+      mojo::ScopedDataPipeProducerHandle pipe,
+      bool compress,
+      base::TimeDelta stall_timeout,
+      mojo::PendingRemote<mojom::HeapSnapshotObserver> observer,
+      TakeHeapSnapshotToDataPipeCallback callback) override;
+  void GetIPCStats(GetIPCStatsCallback callback) override;
+  void ConnectPeer(const std::string& channel,
+                   mojo::PendingRemote<mojom::ElectronPeerPort> remote,
+                   mojo::PendingReceiver<mojom::ElectronPeerPort> receiver,
+                   int32_t sender_id) override;
 
   base::WeakPtr<ElectronApiServiceImpl> GetWeakPtr() {
     return weak_factory_.GetWeakPtr();
@@ -52,12 +66,12 @@ class ElectronApiServiceImpl : public mojom::ElectronRenderer,
   void DidCreateDocumentElement() override;
   void OnDestruct() override;
 
-  void OnConnectionError();
-
   // Whether the DOM document element has been created.
   bool document_created_ = false;
 
-  mojo::AssociatedReceiver<mojom::ElectronRenderer> receiver_{this};
+  // The browser keeps its remotes bound for as long as the frame lives, while
+  // one-shot callers bind their own, so several receivers can be alive.
+  mojo::AssociatedReceiverSet<mojom::ElectronRenderer> receivers_;
 
   RendererClientBase* renderer_client_;
   base::WeakPtrFactory<ElectronApiServiceImpl> weak_factory_;
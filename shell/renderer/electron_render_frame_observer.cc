@@ -20,6 +20,7 @@
 #include "net/grit/net_resources.h"
 #include "services/service_manager/public/cpp/interface_provider.h"
 #include "shell/common/options_switches.h"
+#include "shell/renderer/api/electron_api_ipc_renderer_port.h"
 #include "third_party/blink/public/platform/web_isolated_world_info.h"
 #include "third_party/blink/public/web/blink.h"
 #include "third_party/blink/public/web/web_document.h"
@@ -119,6 +120,9 @@ void ElectronRenderFrameObserver::DraggableRegionsChanged() {
 void ElectronRenderFrameObserver::WillReleaseScriptContext(
     v8::Local<v8::Context> context,
     int world_id) {
+  // Let the peers of the ports opened in the context know they are closed,
+  // instead of keeping the ports alive with the handlers they hold.
+  api::IPCRendererPort::CloseAllInContext(context);
   if (ShouldNotifyClient(world_id))
     renderer_client_->WillReleaseScriptContext(context, render_frame_);
 }
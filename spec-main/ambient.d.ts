@@ -8,6 +8,9 @@ declare namespace Electron {
       menuWillShow(menu: Menu): void;
     };
     getAcceleratorTextAt(index: number): string;
+    isItemCheckedAt(index: number): boolean;
+    isEnabledAt(index: number): boolean;
+    isVisibleAt(index: number): boolean;
   }
 
   interface MenuItem {
@@ -1124,6 +1124,60 @@ describe('app module', () => {
     })
   })
 
+  describe('metrics sampling API', () => {
+    afterEach(() => {
+      app.stopMetricsSampling()
+    })
+
+    it('records samples of every process into a typed array', async () => {
+      app.startMetricsSampling({ interval: 50, capacity: 100 })
+      await new Promise(resolve => setTimeout(resolve, 500))
+
+      const { fields, samples } = app.getMetricsSamples()
+      expect(fields).to.include.members(['timestamp', 'pid', 'percentCPUUsage', 'workingSetSize'])
+      expect(samples).to.be.an.instanceOf(Float64Array)
+      expect(samples.length % fields.length).to.equal(0)
+
+      const rows = samples.length / fields.length
+      expect(rows).to.be.within(1, 100)
+      const pidIndex = fields.indexOf('pid')
+      const pids = new Set()
+      for (let row = 0; row < rows; row++) {
+        pids.add(samples[row * fields.length + pidIndex])
+      }
+      expect(pids).to.include(process.pid)
+    })
+
+    it('rejects a non-positive interval', () => {
+      expect(() => app.startMetricsSampling({ interval: 0 })).to.throw(/must be positive/)
+    })
+
+    it('rejects a capacity above the limit', () => {
+      expect(() => app.startMetricsSampling({ capacity: 100001 })).to.throw(/must not exceed 100000/)
+    })
+  })
+
+  describe('GC scheduling API', () => {
+    afterEach(() => {
+      app.setGCOptions({ idleGC: true, fullGCInterval: 0 })
+    })
+
+    it('counts forced full collections', async () => {
+      const before = app.getGCStats()
+      app.setGCOptions({ fullGCInterval: 50 })
+      await new Promise(resolve => setTimeout(resolve, 500))
+      const after = app.getGCStats()
+      expect(after.forcedGCCount).to.be.greaterThan(before.forcedGCCount)
+      expect(after.majorGCCount).to.be.greaterThan(before.majorGCCount)
+      expect(after.totalPauseTime).to.be.greaterThan(before.totalPauseTime)
+      expect(after.maxPauseTime).to.be.at.most(after.totalPauseTime)
+    })
+
+    it('rejects a negative interval', () => {
+      expect(() => app.setGCOptions({ fullGCInterval: -1 })).to.throw(/must not be negative/)
+    })
+  })
+
   describe('getGPUFeatureStatus() API', () => {
     it('returns the graphic features statuses', () => {
       const features = app.getGPUFeatureStatus()
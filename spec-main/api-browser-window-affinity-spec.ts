@@ -3,6 +3,8 @@ import * as path from 'path'
 
 import { ipcMain, BrowserWindow, WebPreferences } from 'electron'
 import { closeWindow } from './window-helpers'
+import { emittedOnce } from './events-helpers'
+import { ifdescribe } from './spec-helpers'
 
 describe('BrowserWindow with affinity module', () => {
   const fixtures = path.resolve(__dirname, '..', 'spec', 'fixtures')
@@ -164,4 +166,40 @@ describe('BrowserWindow with affinity module', () => {
       ])
     })
   })
+
+  // Crashing the shared process is flaky on Windows, see the webContents.send
+  // specs.
+  ifdescribe(process.platform !== 'win32')('BrowserWindow with an affinity : reused process', () => {
+    const affinityReused = 'affinityReused'
+
+    const createWindow = (index: number) => createWindowWithWebPrefs({
+      affinity: affinityReused,
+      nodeIntegration: true,
+      additionalArguments: [`--affinity-window=${index}`]
+    })
+
+    it('resolves the preferences of the remaining window after others are destroyed', async () => {
+      const w1 = await createWindow(1)
+      const w2 = await createWindow(2)
+      expect(w2.webContents.getOSProcessId()).to.equal(w1.webContents.getOSProcessId())
+      await closeWindow(w1, { assertNotWindows: false })
+
+      const w3 = await createWindow(3)
+      expect(w3.webContents.getOSProcessId()).to.equal(w2.webContents.getOSProcessId())
+      await closeWindow(w2, { assertNotWindows: false })
+
+      // Relaunching the crashed process looks up the preferences of its
+      // WebContents by process ID, which has to find the last window rather
+      // than one of the destroyed ones.
+      const crashed = emittedOnce(w3.webContents, 'crashed')
+      w3.webContents.executeJavaScript('process.crash()')
+      await crashed
+      await w3.loadFile(path.join(fixtures, 'api', 'blank.html'))
+      const argv = await w3.webContents.executeJavaScript('process.argv')
+      expect(argv).to.include('--affinity-window=3')
+      expect(argv).to.not.include('--affinity-window=1')
+      expect(argv).to.not.include('--affinity-window=2')
+      await closeWindow(w3, { assertNotWindows: false })
+    })
+  })
 })
@@ -3,7 +3,9 @@ import * as path from 'path'
 import * as cp from 'child_process'
 import { closeAllWindows } from './window-helpers'
 import { emittedOnce } from './events-helpers'
-import { ipcMain, BrowserWindow } from 'electron'
+import { ifdescribe, delay } from './spec-helpers'
+import * as v8 from 'v8'
+import { ipcMain, BrowserWindow, IpcRawMessage } from 'electron'
 
 describe('ipc main module', () => {
   const fixtures = path.join(__dirname, '..', 'spec', 'fixtures')
@@ -78,4 +80,156 @@ describe('ipc main module', () => {
       expect(output).to.deep.equal(['error'])
     })
   })
+
+  describe('ipcMain.onRaw', () => {
+    let listener: ((event: Electron.IpcMainEvent, message: IpcRawMessage) => void) | null = null
+    afterEach(() => {
+      if (listener) ipcMain.removeRawListener('raw-message', listener)
+      listener = null
+      ipcMain.removeAllListeners('raw-message')
+    })
+
+    const sendFromRenderer = async (w: BrowserWindow, ...args: any[]) => {
+      await w.loadURL('about:blank')
+      w.webContents.executeJavaScript(`require('electron').ipcRenderer.send('raw-message', ...${JSON.stringify(args)})`)
+    }
+
+    it('receives messages without deserializing them', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true } })
+      const received = new Promise<IpcRawMessage>(resolve => {
+        listener = (event, message) => resolve(message)
+        ipcMain.onRaw('raw-message', listener)
+      })
+      await sendFromRenderer(w, 'hello', { a: 1 })
+      const message = await received
+      expect(message.channel).to.equal('raw-message')
+      expect(message.size).to.be.greaterThan(0)
+      expect(message.args).to.deep.equal(['hello', { a: 1 }])
+      expect(v8.deserialize(message.toBuffer())).to.deep.equal(['hello', { a: 1 }])
+    })
+
+    it('still calls the listeners added with on()', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true } })
+      listener = () => {}
+      ipcMain.onRaw('raw-message', listener)
+      await sendFromRenderer(w, 'hello')
+      const [, arg] = await emittedOnce(ipcMain, 'raw-message')
+      expect(arg).to.equal('hello')
+    })
+
+    it('can forward messages with webContents.sendRaw()', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true } })
+      const target = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true } })
+      await target.loadURL('about:blank')
+      const forwarded = target.webContents.executeJavaScript(`new Promise(resolve => {
+        require('electron').ipcRenderer.once('raw-message', (event, ...args) => resolve(args))
+      })`)
+      listener = (event, message) => target.webContents.sendRaw(message)
+      ipcMain.onRaw('raw-message', listener)
+      await sendFromRenderer(w, 'hello', [1, 2])
+      expect(await forwarded).to.deep.equal(['hello', [1, 2]])
+    })
+  })
+
+  const ipcHandler = process.env.ELECTRON_SKIP_NATIVE_MODULE_TESTS ? null : require('ipc-handler')
+  ifdescribe(ipcHandler && ipcHandler.supported)('native IPC handlers', () => {
+    const channels = ['native-ipc-echo', 'native-ipc-error', 'native-ipc-remove', 'native-ipc-busy']
+    let w: BrowserWindow
+
+    beforeEach(async () => {
+      w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true } })
+      await w.loadURL('about:blank')
+    })
+
+    afterEach(() => {
+      for (const channel of channels) {
+        ipcHandler.removeHandler(channel)
+        ipcMain.removeAllListeners(channel)
+      }
+    })
+
+    it('replies to sendSync with the value of the handler', async () => {
+      expect(ipcHandler.addHandler('native-ipc-echo')).to.be.true()
+      const result = await w.webContents.executeJavaScript(`(() => {
+        const shared = { a: 1 }
+        const reply = require('electron').ipcRenderer.sendSync('native-ipc-echo', shared, shared, 'str')
+        return [reply[0] === reply[1], reply[0], reply[2]]
+      })()`)
+      expect(result).to.deep.equal([true, { a: 1 }, 'str'])
+    })
+
+    it('resolves invoke with the value of the handler', async () => {
+      ipcHandler.addHandler('native-ipc-echo')
+      const result = await w.webContents.executeJavaScript(`(async () => {
+        const shared = [1, 2]
+        const reply = await require('electron').ipcRenderer.invoke('native-ipc-echo', shared, { shared })
+        return [reply[0] === reply[1].shared, reply[0]]
+      })()`)
+      expect(result).to.deep.equal([true, [1, 2]])
+    })
+
+    it('rejects invoke with the error of the handler', async () => {
+      ipcHandler.addHandler('native-ipc-error')
+      const message = await w.webContents.executeJavaScript(`
+        require('electron').ipcRenderer.invoke('native-ipc-error').catch(error => error.message)
+      `)
+      expect(message).to.match(/Handler failed/)
+    })
+
+    it('handles messages instead of ipcMain', async () => {
+      ipcHandler.addHandler('native-ipc-echo')
+      ipcMain.on('native-ipc-echo', () => { throw new Error('Unexpected message') })
+      const count = ipcHandler.getMessageCount()
+      await w.webContents.executeJavaScript(`(() => {
+        const { ipcRenderer } = require('electron')
+        ipcRenderer.send('native-ipc-echo', 1)
+        ipcRenderer.sendSync('native-ipc-echo', 2)
+      })()`)
+      // Messages are handled in order on the handler thread.
+      expect(ipcHandler.getMessageCount()).to.equal(count + 2)
+    })
+
+    it('lets a handler remove itself', async () => {
+      ipcHandler.addHandler('native-ipc-remove')
+      ipcMain.on('native-ipc-remove', (event) => { event.returnValue = 'ipcMain' })
+      const result = await w.webContents.executeJavaScript(`(() => {
+        const { ipcRenderer } = require('electron')
+        return [ipcRenderer.sendSync('native-ipc-remove', 'native'), ipcRenderer.sendSync('native-ipc-remove')]
+      })()`)
+      expect(result).to.deep.equal([['native'], 'ipcMain'])
+    })
+
+    it('handles messages while the main thread is busy', async () => {
+      ipcHandler.addHandler('native-ipc-echo')
+      ipcMain.on('native-ipc-busy', () => {
+        const start = Date.now()
+        while (Date.now() - start < 2000) {}
+      })
+      // The first message makes the renderer ask which channels are native.
+      await w.webContents.executeJavaScript(`
+        require('electron').ipcRenderer.send('native-ipc-echo', 0)
+        new Promise(resolve => setTimeout(resolve, 200))
+      `)
+      const elapsed = await w.webContents.executeJavaScript(`(() => {
+        const { ipcRenderer } = require('electron')
+        ipcRenderer.send('native-ipc-busy')
+        const start = Date.now()
+        ipcRenderer.sendSync('native-ipc-echo', 1)
+        return Date.now() - start
+      })()`)
+      // Going through the UI thread would wait for the busy listener.
+      expect(elapsed).to.be.lessThan(1000)
+    })
+
+    it('tells the handler once it is no longer called', async () => {
+      ipcHandler.addHandler('native-ipc-echo')
+      const removed = ipcHandler.getRemovedCount()
+      // Does not wait for the handler thread.
+      ipcHandler.removeHandler('native-ipc-echo')
+      for (let i = 0; i < 50 && ipcHandler.getRemovedCount() === removed; i++) {
+        await delay(20)
+      }
+      expect(ipcHandler.getRemovedCount()).to.equal(removed + 1)
+    })
+  })
 })
@@ -123,6 +123,58 @@ describe('ipcRenderer module', () => {
       expect(childValue.hello).to.equal('world')
       expect(childValue.child).to.equal(childValue)
     })
+
+    it('keeps cloning values after non-cloneable ones on the same channel', async () => {
+      w.webContents.executeJavaScript(`{
+        const { ipcRenderer } = require('electron')
+        ipcRenderer.send('message', { location: document.location })
+        ipcRenderer.send('message', new Date(0), 'x'.repeat(100000))
+      }`)
+
+      const [, first] = await emittedOnce(ipcMain, 'message')
+      expect(first.location.protocol).to.equal('about:')
+      const [, date, string] = await emittedOnce(ipcMain, 'message')
+      expect(date).to.be.an.instanceOf(Date)
+      expect(date.getTime()).to.equal(0)
+      expect(string).to.have.lengthOf(100000)
+    })
+
+    it('runs getters once on channels that sent non-cloneable values', async () => {
+      w.webContents.executeJavaScript(`{
+        const { ipcRenderer } = require('electron')
+        ipcRenderer.send('message', document.location)
+        let count = 0
+        ipcRenderer.send('message', { get value () { return ++count } })
+      }`)
+
+      await emittedOnce(ipcMain, 'message')
+      const [, received] = await emittedOnce(ipcMain, 'message')
+      expect(received).to.deep.equal({ value: 1 })
+    })
+
+    it('sends messages of growing and shrinking sizes intact', async () => {
+      const sizes = [10, 5000, 70000, 300000, 2000000, 70000, 5000, 10]
+      const received: string[] = []
+      const listener = (event: Electron.IpcMainEvent, value: string) => received.push(value)
+      ipcMain.on('message', listener)
+      try {
+        const done = new Promise(resolve => ipcMain.once('done', resolve))
+        w.webContents.executeJavaScript(`{
+          const { ipcRenderer } = require('electron')
+          const sizes = ${JSON.stringify(sizes)}
+          sizes.forEach((size, i) => ipcRenderer.send('message', String.fromCharCode(97 + i).repeat(size)))
+          ipcRenderer.send('done')
+        }`)
+        await done
+      } finally {
+        ipcMain.removeListener('message', listener)
+      }
+
+      expect(received).to.have.lengthOf(sizes.length)
+      sizes.forEach((size, i) => {
+        expect(received[i]).to.equal(String.fromCharCode(97 + i).repeat(size))
+      })
+    })
   })
 
   describe('sendSync()', () => {
@@ -184,6 +236,76 @@ describe('ipcRenderer module', () => {
     generateSpecs('with contextIsolation + sandbox', { contextIsolation: true, sandbox: true })
   })
 
+  describe('connectTo()', () => {
+    const generateSpecs = (description: string, webPreferences: WebPreferences) => {
+      describe(description, () => {
+        let contents: WebContents
+
+        beforeEach(async () => {
+          contents = (webContents as any).create({
+            preload: path.join(fixtures, 'module', 'preload-ipc-port-echo.js'),
+            ...webPreferences
+          })
+
+          await contents.loadURL('about:blank')
+        })
+
+        afterEach(() => {
+          if (!contents.isDestroyed()) (contents as any).destroy()
+          contents = null as unknown as WebContents
+        })
+
+        it('exchanges messages with the WebContents', async () => {
+          const data = await w.webContents.executeJavaScript(`(async () => {
+            const port = await require('electron').ipcRenderer.connectTo(${contents.id}, 'port-echo')
+            const received = new Promise(resolve => port.once('message', (event, ...args) => resolve(args)))
+            port.postMessage('hello', { a: 1 })
+            const args = await received
+            port.close()
+            return args
+          })()`)
+          expect(data).to.deep.equal(['hello', { a: 1 }])
+        })
+
+        it('emits close when the WebContents goes away', async () => {
+          await w.webContents.executeJavaScript(`(async () => {
+            const port = await require('electron').ipcRenderer.connectTo(${contents.id}, 'port-echo')
+            window.portClosed = new Promise(resolve => port.once('close', resolve))
+          })()`)
+          ;(contents as any).destroy()
+          await w.webContents.executeJavaScript('window.portClosed')
+        })
+
+        it('emits close when the WebContents navigates away', async () => {
+          await w.webContents.executeJavaScript(`(async () => {
+            const port = await require('electron').ipcRenderer.connectTo(${contents.id}, 'port-echo')
+            window.portClosed = new Promise(resolve => port.once('close', resolve))
+          })()`)
+          await contents.loadURL('data:text/html,<p>navigated</p>')
+          await w.webContents.executeJavaScript('window.portClosed')
+        })
+
+        it('emits close when nobody listens on the channel', async () => {
+          await w.webContents.executeJavaScript(`(async () => {
+            const port = await require('electron').ipcRenderer.connectTo(${contents.id}, 'no-listener')
+            await new Promise(resolve => port.once('close', resolve))
+          })()`)
+        })
+      })
+    }
+
+    generateSpecs('without sandbox', {})
+    generateSpecs('with sandbox', { sandbox: true })
+    generateSpecs('with contextIsolation', { contextIsolation: true })
+
+    it('rejects when the WebContents does not exist', async () => {
+      const error = await w.webContents.executeJavaScript(`
+        require('electron').ipcRenderer.connectTo(-1, 'port-echo').catch(error => error.message)
+      `)
+      expect(error).to.equal('No such WebContents')
+    })
+  })
+
   describe('ipcRenderer.on', () => {
     it('is not used for internals', async () => {
       const result = await w.webContents.executeJavaScript(`
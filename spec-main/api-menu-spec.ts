@@ -749,6 +749,44 @@ describe('Menu module', function () {
     })
   })
 
+  describe('menu item state', () => {
+    it('is seen by the native menu after the items change', () => {
+      const menu = Menu.buildFromTemplate([
+        { label: '1', type: 'checkbox' },
+        { label: '2', type: 'radio' },
+        { label: '3', type: 'radio' }
+      ])
+      expect(menu.isEnabledAt(0)).to.be.true()
+      expect(menu.isItemCheckedAt(0)).to.be.false()
+
+      menu.items[0].enabled = false
+      menu.items[0].checked = true
+      menu.items[2].checked = true
+      expect(menu.isEnabledAt(0)).to.be.false()
+      expect(menu.isItemCheckedAt(0)).to.be.true()
+      expect(menu.isItemCheckedAt(1)).to.be.false()
+      expect(menu.isItemCheckedAt(2)).to.be.true()
+    })
+
+    it('is sent to the native menu in one batch', async () => {
+      const menu = Menu.buildFromTemplate(Array.from({ length: 100 }, (v, i) => ({ label: `${i}` })))
+      await new Promise(resolve => process.nextTick(resolve))
+
+      const setCommandStates = (menu as any).setCommandStates
+      let calls = 0
+      ;(menu as any).setCommandStates = function (states: any[]) {
+        calls++
+        expect(states).to.have.lengthOf(100)
+        return setCommandStates.call(this, states)
+      }
+      for (const item of menu.items) item.visible = false
+      await new Promise(resolve => process.nextTick(resolve))
+
+      expect(calls).to.equal(1)
+      expect(menu.isVisibleAt(99)).to.be.false()
+    })
+  })
+
   describe('Menu.popup', () => {
     let w: BrowserWindow
     let menu: Menu
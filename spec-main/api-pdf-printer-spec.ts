@@ -0,0 +1,113 @@
+import * as chai from 'chai'
+import * as chaiAsPromised from 'chai-as-promised'
+import * as fs from 'fs'
+import * as os from 'os'
+import * as path from 'path'
+import { PDFPrinter, webContents } from 'electron'
+import { emittedOnce } from './events-helpers'
+import { ifdescribe } from './spec-helpers'
+
+const { expect } = chai
+
+chai.use(chaiAsPromised)
+
+const features = process.electronBinding('features')
+
+ifdescribe(features.isPrintingEnabled())('PDFPrinter module', () => {
+  let outputDir: string
+  let printer: PDFPrinter
+
+  beforeEach(() => {
+    outputDir = fs.mkdtempSync(path.join(os.tmpdir(), 'pdf-printer-spec-'))
+  })
+
+  afterEach(() => {
+    if (printer) printer.destroy()
+    for (const file of fs.readdirSync(outputDir)) {
+      fs.unlinkSync(path.join(outputDir, file))
+    }
+    fs.rmdirSync(outputDir)
+  })
+
+  it('throws when concurrency is not a positive integer', () => {
+    expect(() => new PDFPrinter({ concurrency: 0 })).to.throw(/concurrency/)
+  })
+
+  it('prints pages to files', async () => {
+    printer = new PDFPrinter()
+    const outputPath = path.join(outputDir, 'page.pdf')
+    const result = await printer.print({
+      url: 'data:text/html,<h1>Hello</h1><h1 style="page-break-before: always">World</h1>',
+      outputPath
+    })
+    expect(result).to.deep.equal({ outputPath, pageCount: 2 })
+    expect(fs.readFileSync(outputPath).slice(0, 5).toString()).to.equal('%PDF-')
+  })
+
+  it('emits job-done with an event and the result', async () => {
+    printer = new PDFPrinter()
+    const outputPath = path.join(outputDir, 'page.pdf')
+    const jobDone = emittedOnce(printer, 'job-done')
+    await printer.print({ url: 'data:text/html,<h1>Hello</h1>', outputPath })
+    const [event, result] = await jobDone
+    expect(event).to.be.an('object')
+    expect(result).to.deep.equal({ outputPath, pageCount: 1 })
+  })
+
+  it('limits the number of jobs running at the same time', async () => {
+    printer = new PDFPrinter({ concurrency: 2 })
+    const jobs = []
+    for (let i = 0; i < 5; i++) {
+      jobs.push(printer.print({
+        url: `data:text/html,<h1>${i}</h1>`,
+        outputPath: path.join(outputDir, `${i}.pdf`)
+      }))
+    }
+    expect(printer.getMetrics()).to.include({ activeCount: 2, pendingCount: 3 })
+    await Promise.all(jobs)
+
+    const metrics = printer.getMetrics()
+    expect(metrics).to.include({ activeCount: 0, completedCount: 5, pageCount: 5 })
+    expect(metrics.pagesPerSecond).to.be.greaterThan(0)
+  })
+
+  it('reuses its WebContents between jobs', async () => {
+    printer = new PDFPrinter({ concurrency: 1 })
+    const count = webContents.getAllWebContents().length
+    for (let i = 0; i < 3; i++) {
+      await printer.print({
+        url: `data:text/html,<h1>${i}</h1>`,
+        outputPath: path.join(outputDir, `${i}.pdf`)
+      })
+    }
+    expect(webContents.getAllWebContents().length).to.equal(count + 1)
+  })
+
+  it('rejects jobs that fail to load and keeps printing', async () => {
+    printer = new PDFPrinter({ concurrency: 1 })
+    await expect(printer.print({
+      url: 'file:///does-not-exist',
+      outputPath: path.join(outputDir, 'failed.pdf')
+    })).to.eventually.be.rejected()
+    await printer.print({
+      url: 'data:text/html,<h1>Hello</h1>',
+      outputPath: path.join(outputDir, 'page.pdf')
+    })
+    expect(printer.getMetrics()).to.include({ completedCount: 1, failedCount: 1 })
+  })
+
+  it('rejects pending jobs when destroyed', async () => {
+    printer = new PDFPrinter({ concurrency: 1 })
+    const running = printer.print({
+      url: 'data:text/html,<h1>0</h1>',
+      outputPath: path.join(outputDir, '0.pdf')
+    })
+    const pending = printer.print({
+      url: 'data:text/html,<h1>1</h1>',
+      outputPath: path.join(outputDir, '1.pdf')
+    })
+    printer.destroy()
+    await expect(pending).to.eventually.be.rejectedWith(/destroyed/)
+    await running
+  })
+})
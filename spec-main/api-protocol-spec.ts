@@ -189,6 +189,14 @@ describe('protocol module', () => {
       expect(r.data).to.equal(text)
     })
 
+    it('sends large Buffer slices as response', async () => {
+      const large = Buffer.from('x' + 'valar morghulis'.repeat(300000) + 'y')
+      const slice = large.subarray(1, large.length - 1)
+      await registerBufferProtocol(protocolName, (request, callback) => callback(slice))
+      const r = await ajax(protocolName + '://fake-host')
+      expect(r.data).to.equal(slice.toString())
+    })
+
     it('fails when sending string', async () => {
       await registerBufferProtocol(protocolName, (request, callback) => callback(text as any))
       await expect(ajax(protocolName + '://fake-host')).to.be.eventually.rejectedWith(Error, '404')
@@ -260,6 +268,49 @@ describe('protocol module', () => {
     })
   })
 
+  describe('protocol.registerDirectoryProtocol', () => {
+    const pagesPath = path.join(fixturesPath, 'pages')
+    const asarPath = path.join(fixturesPath, 'test.asar', 'a.asar')
+    const normalContent = String(fs.readFileSync(path.join(pagesPath, 'a.html')))
+    const asarContent = String(fs.readFileSync(path.join(asarPath, 'file1')))
+
+    it('serves files from a directory or an asar archive', async () => {
+      protocol.registerDirectoryProtocol(protocolName, { pages: pagesPath, '': asarPath })
+      const r1 = await ajax(protocolName + '://pages/a.html')
+      expect(r1.data).to.equal(normalContent)
+      expect(r1.headers).to.include('content-type: text/html')
+      expect(r1.headers).to.include('access-control-allow-origin: *')
+      const r2 = await ajax(protocolName + '://any-host/file1')
+      expect(r2.data).to.equal(asarContent)
+    })
+
+    it('answers range requests', async () => {
+      protocol.registerDirectoryProtocol(protocolName, asarPath)
+      const r = await ajax(protocolName + '://fake-host/file1', { headers: { Range: 'bytes=1-3' } })
+      expect(r.status).to.equal(206)
+      expect(r.data).to.equal(asarContent.substr(1, 3))
+      expect(r.headers).to.include(`content-range: bytes 1-3/${asarContent.length}`)
+    })
+
+    it('answers conditional requests', async () => {
+      protocol.registerDirectoryProtocol(protocolName, pagesPath)
+      const r1 = await ajax(protocolName + '://fake-host/a.html')
+      const etag = /etag: (.*)/.exec(r1.headers)![1].trim()
+      const r2 = await ajax(protocolName + '://fake-host/a.html', { headers: { 'If-None-Match': etag } })
+      expect(r2.status).to.equal(304)
+    })
+
+    it('does not serve files out of the root', async () => {
+      protocol.registerDirectoryProtocol(protocolName, path.join(pagesPath, 'partition'))
+      await expect(ajax(protocolName + '://fake-host/%2e%2e/a.html')).to.be.eventually.rejected()
+      await expect(ajax(protocolName + '://fake-host/missing.html')).to.be.eventually.rejected()
+    })
+
+    it('throws when the root is not an absolute path', () => {
+      expect(() => protocol.registerDirectoryProtocol(protocolName, 'relative')).to.throw(/absolute/)
+    })
+  })
+
   describe('protocol.registerHttpProtocol', () => {
     it('sends url as response', async () => {
       const server = http.createServer((req, res) => {
@@ -394,6 +445,18 @@ describe('protocol module', () => {
       expect(r.data).to.have.lengthOf(data.length)
     })
 
+    it('sends many small chunks through a small buffer intact', async () => {
+      const chunks = Array.from({ length: 2000 }, (_, i) => `${i},`)
+      await registerStreamProtocol(protocolName, (request, callback) => {
+        const body = new stream.Readable({ read () {} })
+        for (const chunk of chunks) body.push(chunk)
+        body.push(null)
+        callback({ data: body, bufferSize: 1000 } as any)
+      })
+      const r = await ajax(protocolName + '://fake-host')
+      expect(r.data).to.equal(chunks.join(''))
+    })
+
     it('can handle a stream completing while writing', async () => {
       function dumbPassthrough () {
         return new stream.Transform({
@@ -468,6 +531,57 @@ describe('protocol module', () => {
     })
   })
 
+  describe('protocol.enableResponseCache', () => {
+    it('serves cached responses without calling the handler', async () => {
+      let calls = 0
+      await registerStringProtocol(protocolName, (request, callback) => {
+        calls++
+        callback({ data: text, headers: { 'Cache-Control': 'max-age=3600' } })
+      })
+      protocol.enableResponseCache(protocolName)
+      for (let i = 0; i < 3; i++) {
+        const r = await ajax(protocolName + '://fake-host')
+        expect(r.data).to.equal(text)
+      }
+      expect(calls).to.equal(1)
+      const stats = protocol.getResponseCacheStats(protocolName)
+      expect(stats).to.include({ hits: 2, misses: 1, count: 1, size: text.length })
+    })
+
+    it('does not cache responses without a freshness lifetime', async () => {
+      let calls = 0
+      await registerBufferProtocol(protocolName, (request, callback) => {
+        calls++
+        const headers = { 'Cache-Control': calls === 1 ? 'no-store' : 'no-cache' }
+        callback({ data: Buffer.from(text), headers } as any)
+      })
+      protocol.enableResponseCache(protocolName)
+      await ajax(protocolName + '://fake-host')
+      await ajax(protocolName + '://fake-host')
+      await ajax(protocolName + '://fake-host')
+      expect(calls).to.equal(3)
+      expect(protocol.getResponseCacheStats(protocolName)).to.include({ hits: 0, count: 0 })
+    })
+
+    it('drops the least recently used responses beyond maxSize', async () => {
+      await registerStringProtocol(protocolName, (request, callback) => {
+        callback({ data: text, headers: { 'Cache-Control': 'max-age=3600' } })
+      })
+      protocol.enableResponseCache(protocolName, { maxSize: text.length * 2 })
+      for (const host of ['a', 'b', 'c']) {
+        await ajax(`${protocolName}://${host}`)
+      }
+      expect(protocol.getResponseCacheStats(protocolName)).to.include({ count: 2, size: text.length * 2 })
+      protocol.disableResponseCache(protocolName)
+      expect(protocol.getResponseCacheStats(protocolName)).to.include({ count: 0, maxSize: 0 })
+    })
+
+    it('throws when the scheme is not registered', () => {
+      expect(() => protocol.enableResponseCache('no-exist')).to.throw(/not been registered/)
+      expect(() => protocol.getResponseCacheStats('no-exist')).to.throw(/not been registered/)
+    })
+  })
+
   describe('protocol.isProtocolHandled', () => {
     it('returns true for built-in protocols', async () => {
       for (const p of ['about', 'file', 'http', 'https']) {
@@ -3,12 +3,14 @@ import * as http from 'http'
 import * as https from 'https'
 import * as path from 'path'
 import * as fs from 'fs'
+import * as os from 'os'
 import * as ChildProcess from 'child_process'
 import { session, BrowserWindow, net, ipcMain, Session } from 'electron'
 import * as send from 'send'
 import * as auth from 'basic-auth'
 import { closeAllWindows } from './window-helpers'
 import { emittedOnce } from './events-helpers'
+import { delay, ifit } from './spec-helpers'
 import { AddressInfo } from 'net';
 
 /* The whole session API doesn't use standard callbacks */
@@ -41,6 +43,70 @@ describe('session module', () => {
       expect(ses2.getUserAgent()).to.not.equal(userAgent)
     })
 
+    it('creates persistent sessions whose prefs load asynchronously', async () => {
+      const sessions = []
+      for (let i = 0; i < 20; i++) {
+        sessions.push(session.fromPartition(`persist:async-prefs-${i}`, { asyncPrefs: true }))
+      }
+      const w = new BrowserWindow({ show: false, webPreferences: { session: sessions[sessions.length - 1] } })
+      try {
+        await w.loadURL('about:blank')
+        w.webContents.setZoomLevel(2)
+        expect(w.webContents.getZoomLevel()).to.equal(2)
+      } finally {
+        w.destroy()
+      }
+    })
+
+    describe('with asyncPrefs in a fresh process', () => {
+      const appPath = path.join(fixtures, 'api', 'async-prefs-app')
+      let userData: string
+      let preferencesPath: string
+
+      beforeEach(() => {
+        userData = fs.mkdtempSync(path.join(os.tmpdir(), 'electron-async-prefs-'))
+        const partitionPath = path.join(userData, 'Partitions', 'async-prefs')
+        fs.mkdirSync(partitionPath, { recursive: true })
+        preferencesPath = path.join(partitionPath, 'Preferences')
+      })
+
+      afterEach(() => {
+        fs.rmdirSync(userData, { recursive: true })
+      })
+
+      const runApp = async (mode: string) => {
+        const appProcess = ChildProcess.spawn(process.execPath, [appPath], {
+          env: { ...process.env, ASYNC_PREFS_MODE: mode, ASYNC_PREFS_USER_DATA: userData }
+        })
+        let output = ''
+        appProcess.stdout.on('data', data => { output += data })
+        // Don't leave the app behind if it hangs while creating the session.
+        const timeout = setTimeout(() => appProcess.kill(), 10000)
+        const [code] = await emittedOnce(appProcess, 'exit')
+        clearTimeout(timeout)
+        expect(code).to.equal(0)
+        const match = /^async-prefs-results (.*)$/m.exec(output)
+        expect(match).to.not.equal(null)
+        return JSON.parse(match![1])
+      }
+
+      it('returns a persisted pref read right after the session is created', async function () {
+        this.timeout(20000)
+        fs.writeFileSync(preferencesPath, JSON.stringify({ spellcheck: { dictionaries: ['fr'] } }))
+        const result = await runApp('early')
+        expect(result.languages).to.deep.equal(['fr'])
+      })
+
+      ifit(process.platform !== 'win32')('reads the prefs off the main thread', async function () {
+        this.timeout(20000)
+        // The app can only get past session creation if it doesn't read its
+        // Preferences, a FIFO without a writer, on the main thread.
+        ChildProcess.execFileSync('mkfifo', [preferencesPath])
+        const result = await runApp('fifo')
+        expect(result.created).to.equal(true)
+      })
+    })
+
     it.skip('created session is ref-counted', () => {
       const partition = 'test2'
       const userAgent = 'test-agent'
@@ -263,6 +329,69 @@ describe('session module', () => {
     })
   })
 
+  describe('ses.getCodeCacheUsage()', () => {
+    it('reports the codeCacheSize option', async () => {
+      const ses = session.fromPartition('persist:code-cache-size', { codeCacheSize: 1024 * 1024 })
+      const usage = await ses.getCodeCacheUsage()
+      expect(usage.maxSize).to.equal(1024 * 1024)
+      expect(usage.size).to.be.at.least(0)
+    })
+
+    it('keeps the code cache within codeCacheSize', async function () {
+      this.timeout(120000)
+      const maxSize = 1024 * 1024
+      const ses = session.fromPartition(`persist:code-cache-limit-${process.pid}`, { codeCacheSize: maxSize })
+
+      // Each script gets its own code cache entry once it has been loaded
+      // twice over HTTP.
+      const script = (id: string) => Array.from({ length: 1000 }, (_, i) =>
+        `function f${id}_${i} () { return ${i} * 2 }\nf${id}_${i}()`).join('\n')
+      const server = http.createServer((req, res) => {
+        const id = req.url!.slice(1).replace(/\.js$/, '')
+        if (req.url!.endsWith('.js')) {
+          res.writeHead(200, { 'Content-Type': 'application/javascript' })
+          res.end(script(id))
+        } else {
+          res.writeHead(200, { 'Content-Type': 'text/html' })
+          res.end(`<script src="/${id}.js"></script>`)
+        }
+      })
+      await new Promise(resolve => server.listen(0, '127.0.0.1', resolve))
+      const serverUrl = `http://127.0.0.1:${(server.address() as AddressInfo).port}`
+
+      const w = new BrowserWindow({ show: false, webPreferences: { session: ses } })
+      try {
+        for (let i = 0; i < 40; i++) {
+          await w.loadURL(`${serverUrl}/${i}`)
+          await w.loadURL(`${serverUrl}/${i}`)
+        }
+      } finally {
+        w.destroy()
+        server.close()
+      }
+
+      // Entries are written and evicted asynchronously, wait until the size
+      // of the cache settles.
+      let previous = -1
+      let usage = await ses.getCodeCacheUsage()
+      for (let i = 0; i < 60 && (usage.size === 0 || usage.size !== previous); i++) {
+        previous = usage.size
+        await delay(500)
+        usage = await ses.getCodeCacheUsage()
+      }
+      if (usage.size === 0) {
+        throw new Error('Nothing was written to the code cache within 30 seconds')
+      }
+      expect(usage.maxSize).to.equal(maxSize)
+      expect(usage.size).to.be.greaterThan(0).and.at.most(maxSize)
+    })
+
+    it('reports an empty code cache for in-memory sessions', async () => {
+      const usage = await session.fromPartition('code-cache-in-memory').getCodeCacheUsage()
+      expect(usage).to.deep.equal({ size: 0, maxSize: 0 })
+    })
+  })
+
   describe('will-download event', () => {
     afterEach(closeAllWindows)
     it('can cancel default download behavior', async () => {
@@ -101,6 +101,120 @@ describe('webContents module', () => {
         w.webContents.send("test")
       }, 50)
     })
+
+    it('delivers messages in order', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true } })
+      await w.loadURL('about:blank')
+      await w.webContents.executeJavaScript(`{
+        window.received = new Promise(resolve => {
+          const values = []
+          require('electron').ipcRenderer.on('in-order', (event, value) => {
+            values.push(value)
+            if (values.length === 1000) resolve(values)
+          })
+        })
+        null
+      }`)
+      const expected = []
+      for (let i = 0; i < 1000; i++) {
+        w.webContents.send('in-order', i)
+        expected.push(i)
+      }
+      expect(await w.webContents.executeJavaScript('window.received')).to.deep.equal(expected)
+    })
+  })
+
+  describe('webContents.sendToFrame(frameId, channel, args...)', () => {
+    afterEach(closeAllWindows)
+
+    const sendAndReceive = async (w: BrowserWindow) => {
+      const frameId = await w.webContents.executeJavaScript(`{
+        window.received = new Promise(resolve => {
+          require('electron').ipcRenderer.once('to-frame', (event, arg) => resolve(arg))
+        })
+        require('electron').webFrame.routingId
+      }`)
+      w.webContents.sendToFrame(frameId, 'to-frame', 'hello')
+      return w.webContents.executeJavaScript('window.received')
+    }
+
+    it('sends the message to the frame', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true } })
+      await w.loadURL('about:blank')
+      expect(await sendAndReceive(w)).to.equal('hello')
+    })
+
+    it('sends the message to the frame after its renderer crashed', async function () {
+      // FIXME: re-enable this test on win32.
+      if (process.platform === 'win32') { return this.skip() }
+      const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true } })
+      await w.loadURL('about:blank')
+      expect(await sendAndReceive(w)).to.equal('hello')
+
+      const crashed = emittedOnce(w.webContents, 'crashed')
+      w.webContents.executeJavaScript('process.crash()')
+      await crashed
+      await w.loadURL('about:blank')
+      expect(await sendAndReceive(w)).to.equal('hello')
+    })
+  })
+
+  describe('webContents.broadcast(targets, channel, args...)', () => {
+    afterEach(closeAllWindows)
+
+    const createWindows = async (count: number, partition?: string) => {
+      const windows = []
+      for (let i = 0; i < count; i++) {
+        const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, partition } })
+        await w.loadURL('about:blank')
+        windows.push(w)
+      }
+      return windows
+    }
+
+    const listen = (w: BrowserWindow, channel: string) => w.webContents.executeJavaScript(`{
+      window.received = new Promise(resolve => {
+        require('electron').ipcRenderer.once(${JSON.stringify(channel)}, (event, ...args) => resolve(args))
+      })
+      null
+    }`)
+    const getReceived = (w: BrowserWindow) => w.webContents.executeJavaScript('window.received')
+
+    it('throws an error when the channel is missing', () => {
+      expect(() => {
+        (webContents.broadcast as any)(null)
+      }).to.throw('Missing required channel argument')
+    })
+
+    it('sends the message to the given WebContents', async () => {
+      const [w1, w2, w3] = await createWindows(3)
+      await Promise.all([w1, w2, w3].map(w => listen(w, 'broadcast')))
+      const count = webContents.broadcast([w1.webContents, w2.webContents], 'broadcast', 'hello', { a: 1 })
+      expect(count).to.equal(2)
+      expect(await getReceived(w1)).to.deep.equal(['hello', { a: 1 }])
+      expect(await getReceived(w2)).to.deep.equal(['hello', { a: 1 }])
+      const received = await w3.webContents.executeJavaScript('Promise.race([window.received, new Promise(resolve => setTimeout(resolve, 100))])')
+      expect(received).to.be.undefined()
+    })
+
+    it('sends large messages', async () => {
+      const windows = await createWindows(2)
+      await Promise.all(windows.map(w => listen(w, 'broadcast-large')))
+      const payload = 'x'.repeat(1024 * 1024)
+      webContents.broadcast(windows.map(w => w.webContents), 'broadcast-large', payload)
+      for (const w of windows) {
+        expect(await getReceived(w)).to.deep.equal([payload])
+      }
+    })
+
+    it('sends the message to the WebContents of a session', async () => {
+      const [w1] = await createWindows(1, 'broadcast-session')
+      await createWindows(1)
+      await listen(w1, 'broadcast-session')
+      const count = webContents.broadcast(session.fromPartition('broadcast-session'), 'broadcast-session', 42)
+      expect(count).to.equal(1)
+      expect(await getReceived(w1)).to.deep.equal([42])
+    })
   })
 
   ifdescribe(features.isPrintingEnabled())('webContents.print()', () => {
@@ -1496,6 +1610,77 @@ describe('webContents module', () => {
       }
     })
 
+    it('writes a gzipped snapshot and reports progress', async () => {
+      const w = new BrowserWindow({ show: false })
+      await w.loadURL('about:blank')
+
+      const filePath = path.join(app.getPath('temp'), 'test.heapsnapshot.gz')
+      let progressEvents = 0
+      w.webContents.on('heap-snapshot-progress', () => { progressEvents++ })
+
+      try {
+        await w.webContents.takeHeapSnapshot(filePath, { compress: true })
+        const snapshot = require('zlib').gunzipSync(fs.readFileSync(filePath)).toString()
+        expect(JSON.parse(snapshot)).to.have.property('snapshot')
+        expect(progressEvents).to.be.greaterThan(0)
+      } finally {
+        try {
+          fs.unlinkSync(filePath)
+        } catch (e) {
+          // ignore error
+        }
+      }
+    })
+
+    it('streams the snapshot to the caller', async () => {
+      const w = new BrowserWindow({ show: false })
+      await w.loadURL('about:blank')
+
+      const chunks: Buffer[] = []
+      for await (const chunk of w.webContents.takeHeapSnapshotStream()) {
+        chunks.push(chunk as Buffer)
+      }
+      const snapshot = Buffer.concat(chunks).toString()
+      expect(JSON.parse(snapshot)).to.have.property('snapshot')
+    })
+
+    it('streams a gzipped snapshot', async () => {
+      const w = new BrowserWindow({ show: false })
+      await w.loadURL('about:blank')
+
+      const chunks: Buffer[] = []
+      const stream = w.webContents.takeHeapSnapshotStream({ compress: true })
+      for await (const chunk of stream) {
+        chunks.push(chunk as Buffer)
+      }
+      const snapshot = require('zlib').gunzipSync(Buffer.concat(chunks)).toString()
+      expect(JSON.parse(snapshot)).to.have.property('snapshot')
+    })
+
+    it('gives up on a snapshot whose stream is not read', async function () {
+      this.timeout(60000)
+      const w = new BrowserWindow({ show: false })
+      await w.loadURL('about:blank')
+      // Large enough for the snapshot to fill the pipe and the renderer's
+      // buffer, which makes serialization wait for the reader.
+      await w.webContents.executeJavaScript(`
+        window.junk = Array.from({ length: 500000 }, (_, i) => ({
+          index: i, value: 'value' + i
+        }));
+        0
+      `)
+
+      const stream = w.webContents.takeHeapSnapshotStream({ stallTimeout: 500 })
+      // Nothing reads the stream, the renderer must still become responsive.
+      expect(await w.webContents.executeJavaScript('1 + 1')).to.equal(2)
+
+      const error = await new Promise<Error>((resolve) => {
+        stream.on('error', resolve)
+        stream.resume()
+      })
+      expect(error.message).to.equal('takeHeapSnapshot failed')
+    })
+
     it('fails with invalid file path', async () => {
       const w = new BrowserWindow({
         show: false,
@@ -1511,6 +1696,69 @@ describe('webContents module', () => {
     })
   })
 
+  describe('getIPCStats()', () => {
+    afterEach(closeAllWindows)
+
+    it('reports messages and invoke latencies on both sides', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true } })
+      await w.loadURL('about:blank')
+
+      ipcMain.handle('ipc-stats-invoke', () => 'pong')
+      try {
+        await w.webContents.executeJavaScript(`(async () => {
+          const { ipcRenderer } = require('electron')
+          ipcRenderer.send('ipc-stats-send', 'x'.repeat(100))
+          for (let i = 0; i < 10; i++) await ipcRenderer.invoke('ipc-stats-invoke')
+        })()`)
+      } finally {
+        ipcMain.removeHandler('ipc-stats-invoke')
+      }
+
+      const { browser, renderer } = await w.webContents.getIPCStats()
+      expect(renderer['ipc-stats-send'].sentCount).to.equal(1)
+      expect(renderer['ipc-stats-send'].sentBytes).to.be.greaterThan(100)
+      expect(browser['ipc-stats-send'].receivedCount).to.equal(1)
+      expect(browser['ipc-stats-send'].receivedBytes).to.equal(renderer['ipc-stats-send'].sentBytes)
+
+      const { invoke } = renderer['ipc-stats-invoke']
+      expect(invoke.count).to.equal(10)
+      expect(invoke.p50).to.be.within(invoke.min, invoke.max)
+      expect(invoke.p99).to.be.within(invoke.p50, invoke.max)
+      expect(browser['ipc-stats-invoke'].invoke.count).to.equal(10)
+    })
+  })
+
+  describe('native events', () => {
+    let contents: WebContents
+    const getDomReadyStats = () => app.getEventStats()['dom-ready'] || { emitted: 0, skipped: 0 }
+
+    beforeEach(() => {
+      contents = (webContents as any).create({})
+    })
+
+    afterEach(() => {
+      (contents as any).destroy()
+      contents = null as unknown as WebContents
+    })
+
+    it('are skipped when nothing listens to them', async () => {
+      const before = getDomReadyStats()
+      await contents.loadURL('about:blank')
+      const after = getDomReadyStats()
+      expect(after.skipped).to.be.greaterThan(before.skipped)
+      expect(after.emitted).to.equal(before.emitted)
+    })
+
+    it('are emitted again once listened to', async () => {
+      await contents.loadURL('about:blank')
+      const before = getDomReadyStats()
+      const domReady = emittedOnce(contents, 'dom-ready')
+      contents.reload()
+      await domReady
+      expect(getDomReadyStats().emitted).to.be.greaterThan(before.emitted)
+    })
+  })
+
   describe('setBackgroundThrottling()', () => {
     afterEach(closeAllWindows)
     it('does not crash when allowing', () => {
@@ -1562,6 +1810,28 @@ describe('webContents module', () => {
         expect(data).to.be.an.instanceof(Buffer).that.is.not.empty()
       }
     })
+
+    it('resolves with a Buffer that can be modified', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { sandbox: true } })
+      await w.loadURL('data:text/html,<h1>Hello, World!</h1>')
+      const data = await w.webContents.printToPDF({})
+      data.fill(0)
+      expect(data.every((byte: number) => byte === 0)).to.be.true()
+    })
+
+    it('can write the PDF to a file', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { sandbox: true } })
+      await w.loadURL('data:text/html,<h1>Hello, World!</h1>')
+      const outputPath = path.join(app.getPath('temp'), `print-to-pdf-${process.pid}.pdf`)
+      try {
+        const result = await w.webContents.printToPDF({ outputPath })
+        expect(result).to.equal(1)
+        const data = fs.readFileSync(outputPath)
+        expect(data.slice(0, 5).toString()).to.equal('%PDF-')
+      } finally {
+        if (fs.existsSync(outputPath)) fs.unlinkSync(outputPath)
+      }
+    })
   })
 
   describe('PictureInPicture video', () => {
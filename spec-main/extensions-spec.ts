@@ -40,6 +40,15 @@ ifdescribe(process.electronBinding('features').isExtensionsEnabled())('chrome ex
     expect(bg).to.equal('red');
   });
 
+  it('loads an extension in a session whose prefs are still loading', async () => {
+    const customSession = session.fromPartition(`persist:${require('uuid').v4()}`, { asyncPrefs: true } as any);
+    (customSession as any).loadChromeExtension(path.join(fixtures, 'extensions', 'red-bg'));
+    const w = new BrowserWindow({show: false, webPreferences: {session: customSession}})
+    await w.loadURL(url);
+    const bg = await w.webContents.executeJavaScript('document.documentElement.style.backgroundColor');
+    expect(bg).to.equal('red');
+  });
+
   it('confines an extension to the session it was loaded in', async () => {
     const customSession = session.fromPartition(`persist:${require('uuid').v4()}`);
     (customSession as any).loadChromeExtension(path.join(fixtures, 'extensions', 'red-bg'))
@@ -0,0 +1,133 @@
+#include <js_native_api.h>
+#include <node_api.h>
+
+#include <atomic>
+#include <string>
+
+#ifndef _WIN32
+#include "electron/native_api/ipc.h"
+#endif
+
+namespace {
+
+#ifndef _WIN32
+
+std::atomic<int> g_message_count(0);
+std::atomic<int> g_removed_count(0);
+
+// Replies with the arguments it received, or with an error on channels
+// ending in "-error". Handlers of channels ending in "-remove" remove
+// themselves before replying.
+class EchoHandler : public electron::api::ipc::MessageHandler {
+ public:
+  void OnMessage(int web_contents_id,
+                 const char* channel,
+                 const uint8_t* data,
+                 size_t size,
+                 electron::api::ipc::Reply* reply) override {
+    g_message_count++;
+    std::string name(channel);
+    if (EndsWith(name, "-remove"))
+      electron::api::ipc::removeMessageHandler(channel);
+    if (!reply)
+      return;
+    if (EndsWith(name, "-error"))
+      reply->SendError("Handler failed");
+    else
+      reply->Send(data, size);
+  }
+
+  void OnRemoved() override { g_removed_count++; }
+
+ private:
+  static bool EndsWith(const std::string& string, const std::string& suffix) {
+    return string.size() >= suffix.size() &&
+           string.compare(string.size() - suffix.size(), suffix.size(),
+                          suffix) == 0;
+  }
+};
+
+EchoHandler g_handler;
+
+bool GetChannel(napi_env env, napi_callback_info info, std::string* channel) {
+  size_t argc = 1;
+  napi_value args[1];
+  if (napi_get_cb_info(env, info, &argc, args, NULL, NULL) != napi_ok ||
+      argc != 1)
+    return false;
+  char buffer[256];
+  size_t length;
+  if (napi_get_value_string_utf8(env, args[0], buffer, sizeof(buffer),
+                                 &length) != napi_ok)
+    return false;
+  channel->assign(buffer, length);
+  return true;
+}
+
+napi_value AddHandler(napi_env env, napi_callback_info info) {
+  std::string channel;
+  if (!GetChannel(env, info, &channel)) {
+    napi_throw_error(env, NULL, "Expected a channel");
+    return NULL;
+  }
+  napi_value result;
+  napi_get_boolean(
+      env, electron::api::ipc::addMessageHandler(channel.c_str(), &g_handler),
+      &result);
+  return result;
+}
+
+napi_value RemoveHandler(napi_env env, napi_callback_info info) {
+  std::string channel;
+  if (!GetChannel(env, info, &channel)) {
+    napi_throw_error(env, NULL, "Expected a channel");
+    return NULL;
+  }
+  electron::api::ipc::removeMessageHandler(channel.c_str());
+  return NULL;
+}
+
+napi_value GetMessageCount(napi_env env, napi_callback_info info) {
+  napi_value result;
+  napi_create_int32(env, g_message_count, &result);
+  return result;
+}
+
+napi_value GetRemovedCount(napi_env env, napi_callback_info info) {
+  napi_value result;
+  napi_create_int32(env, g_removed_count, &result);
+  return result;
+}
+
+#endif
+
+napi_value Init(napi_env env, napi_value exports) {
+#ifdef _WIN32
+  // The addon would have to be linked against electron.lib.
+  napi_property_descriptor descriptors[] = {
+      {"supported", NULL, NULL, NULL, NULL, NULL, napi_default, NULL}};
+  napi_get_boolean(env, false, &descriptors[0].value);
+#else
+  napi_property_descriptor descriptors[] = {
+      {"supported", NULL, NULL, NULL, NULL, NULL, napi_default, NULL},
+      {"addHandler", NULL, AddHandler, NULL, NULL, NULL, napi_default, NULL},
+      {"removeHandler", NULL, RemoveHandler, NULL, NULL, NULL, napi_default,
+       NULL},
+      {"getMessageCount", NULL, GetMessageCount, NULL, NULL, NULL,
+       napi_default, NULL},
+      {"getRemovedCount", NULL, GetRemovedCount, NULL, NULL, NULL,
+       napi_default, NULL}};
+  napi_get_boolean(env, true, &descriptors[0].value);
+#endif
+
+  if (napi_define_properties(env, exports,
+                             sizeof(descriptors) / sizeof(*descriptors),
+                             descriptors) != napi_ok)
+    return NULL;
+
+  return exports;
+}
+
+}  // namespace
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, Init)
@@ -0,0 +1,15 @@
+{
+  "targets": [
+    {
+      "target_name": "ipc_handler",
+      "sources": [
+        "binding.cc"
+      ],
+      "include_dirs": [
+        # The directory containing the electron checkout, so that the
+        # native_api headers are included as "electron/native_api/...".
+        "<(module_root_dir)/../../../../.."
+      ]
+    }
+  ]
+}
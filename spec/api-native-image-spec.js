@@ -4,6 +4,8 @@ const chai = require('chai');
 const dirtyChai = require('dirty-chai');
 const { nativeImage } = require('electron');
 const { ifdescribe, ifit } = require('./spec-helpers');
+const fs = require('fs');
+const os = require('os');
 const path = require('path');
 
 const { expect } = chai;
@@ -181,6 +183,33 @@ describe('nativeImage module', () => {
       expect(imageC.getSize()).to.deep.equal({ width: 269, height: 95 });
     });
 
+    it('uses the memory of the buffer when copy is false', () => {
+      const imageA = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+      const bitmap = imageA.toBitmap();
+
+      const imageB = nativeImage.createFromBitmap(bitmap, { ...imageA.getSize(), copy: false });
+      expect(imageB.getSize()).to.deep.equal({ width: 538, height: 190 });
+      expect(imageB.getBitmap().equals(bitmap)).to.be.true();
+      expect(imageB.toPNG().equals(imageA.toPNG())).to.be.true();
+    });
+
+    it('keeps the pixels when the source Buffer is garbage collected', () => {
+      const imageA = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+      const expected = imageA.toBitmap();
+
+      // getBitmap() returns a Buffer over memory it does not own.
+      const createImage = () => {
+        const source = nativeImage.createFromBitmap(expected, imageA.getSize());
+        return nativeImage.createFromBitmap(source.getBitmap(), { ...imageA.getSize(), copy: false });
+      };
+      const imageB = createImage();
+      for (let i = 0; i < 3; i++) {
+        global.gc();
+        Buffer.alloc(expected.length, 0xff);
+      }
+      expect(imageB.toBitmap().equals(expected)).to.be.true();
+    });
+
     it('throws on invalid arguments', () => {
       expect(() => nativeImage.createFromBitmap(null, {})).to.throw('buffer must be a node Buffer');
       expect(() => nativeImage.createFromBitmap([12, 14, 124, 12], {})).to.throw('buffer must be a node Buffer');
@@ -234,6 +263,23 @@ describe('nativeImage module', () => {
       expect(imageI.getSize()).to.deep.equal({ width: 269, height: 95 });
     });
 
+    it('uses the memory of bitmap buffers when copy is false', () => {
+      const imageA = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+
+      const imageB = nativeImage.createFromBuffer(imageA.toBitmap(),
+        { width: 538, height: 190, copy: false });
+      expect(imageB.getSize()).to.deep.equal({ width: 538, height: 190 });
+      expect(imageB.toBitmap().equals(imageA.toBitmap())).to.be.true();
+
+      const imageC = nativeImage.createFromBuffer(imageA.toPNG(),
+        { width: 100, height: 200, copy: false });
+      expect(imageC.getSize()).to.deep.equal({ width: 538, height: 190 });
+
+      const imageD = nativeImage.createFromBuffer(Buffer.from([1, 2, 3, 4]),
+        { width: 100, height: 100, copy: false });
+      expect(imageD.isEmpty()).to.be.true();
+    });
+
     it('throws on invalid arguments', () => {
       expect(() => nativeImage.createFromBuffer(null)).to.throw('buffer must be a node Buffer');
       expect(() => nativeImage.createFromBuffer([12, 14, 124, 12])).to.throw('buffer must be a node Buffer');
@@ -405,6 +451,97 @@ describe('nativeImage module', () => {
     });
   });
 
+  describe('createFromPathAsync(path)', () => {
+    it('resolves with an empty image for invalid paths', async () => {
+      expect((await nativeImage.createFromPathAsync('')).isEmpty()).to.be.true();
+      expect((await nativeImage.createFromPathAsync('does-not-exist.png')).isEmpty()).to.be.true();
+      expect((await nativeImage.createFromPathAsync(__filename)).isEmpty()).to.be.true();
+    });
+
+    it('resolves with the image at the path', async () => {
+      const imagePath = path.join(__dirname, 'fixtures', 'assets', 'logo.png');
+      const image = await nativeImage.createFromPathAsync(imagePath);
+      expect(image.getSize()).to.deep.equal({ width: 538, height: 190 });
+      expect(image.toBitmap().equals(nativeImage.createFromPath(imagePath).toBitmap())).to.be.true();
+    });
+
+    it('decodes the same file only once', async () => {
+      const imagePath = path.join(__dirname, 'fixtures', 'assets', 'logo.png');
+      await nativeImage.createFromPathAsync(imagePath);
+      const before = nativeImage.getCacheStats();
+      const image = await nativeImage.createFromPathAsync(imagePath);
+      const after = nativeImage.getCacheStats();
+      expect(image.isEmpty()).to.be.false();
+      expect(after.hits).to.be.above(before.hits);
+      expect(after.misses).to.equal(before.misses);
+      expect(after.size).to.be.at.most(after.limit);
+    });
+
+    it('does not share writable pixels with the cache', async () => {
+      const imagePath = path.join(__dirname, 'fixtures', 'assets', 'logo.png');
+      const imageA = await nativeImage.createFromPathAsync(imagePath);
+      const bitmap = imageA.getBitmap();
+      const original = Buffer.from(bitmap);
+      bitmap.fill(0);
+      const imageB = await nativeImage.createFromPathAsync(imagePath);
+      expect(imageA.getBitmap().equals(original)).to.be.true();
+      expect(imageB.getBitmap().equals(original)).to.be.true();
+    });
+
+    it('reloads a file whose size changed', async () => {
+      const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'electron-native-image-spec-'));
+      const imagePath = path.join(dir, 'image.png');
+      try {
+        fs.copyFileSync(path.join(__dirname, 'fixtures', 'assets', 'logo.png'), imagePath);
+        const { mtime } = fs.statSync(imagePath);
+        const imageA = await nativeImage.createFromPathAsync(imagePath);
+        expect(imageA.getSize()).to.deep.equal({ width: 538, height: 190 });
+
+        // Keep the modification time, so that only the size tells them apart.
+        fs.copyFileSync(path.join(__dirname, 'fixtures', 'assets', '1x1.png'), imagePath);
+        fs.utimesSync(imagePath, mtime, mtime);
+        const imageB = await nativeImage.createFromPathAsync(imagePath);
+        expect(imageB.getSize()).to.deep.equal({ width: 1, height: 1 });
+      } finally {
+        fs.unlinkSync(imagePath);
+        fs.rmdirSync(dir);
+      }
+    });
+
+    it('does not cache when the limit is 0', async () => {
+      const { limit } = nativeImage.getCacheStats();
+      try {
+        nativeImage.setCacheLimit(0);
+        expect(nativeImage.getCacheStats()).to.include({ size: 0, count: 0 });
+        const image = await nativeImage.createFromPathAsync(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+        expect(image.isEmpty()).to.be.false();
+        expect(nativeImage.getCacheStats().count).to.equal(0);
+      } finally {
+        nativeImage.setCacheLimit(limit);
+      }
+    });
+  });
+
+  describe('createFromBufferAsync(buffer, options)', () => {
+    it('resolves with the image decoded from the buffer', async () => {
+      const imageA = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+      const imageB = await nativeImage.createFromBufferAsync(imageA.toPNG());
+      expect(imageB.getSize()).to.deep.equal({ width: 538, height: 190 });
+      expect(imageA.toBitmap().equals(imageB.toBitmap())).to.be.true();
+
+      const imageC = await nativeImage.createFromBufferAsync(imageA.toBitmap(), { width: 538, height: 190, scaleFactor: 2.0 });
+      expect(imageC.getSize()).to.deep.equal({ width: 269, height: 95 });
+    });
+
+    it('resolves with an empty image when the buffer is empty', async () => {
+      expect((await nativeImage.createFromBufferAsync(Buffer.from([]))).isEmpty()).to.be.true();
+    });
+
+    it('throws on invalid arguments', () => {
+      expect(() => nativeImage.createFromBufferAsync(null)).to.throw('buffer must be a node Buffer');
+    });
+  });
+
   describe('createFromNamedImage(name)', () => {
     it('returns empty for invalid options', () => {
       const image = nativeImage.createFromNamedImage('totally_not_real');
@@ -480,6 +617,49 @@ describe('nativeImage module', () => {
     });
   });
 
+  describe('transformImages(jobs)', () => {
+    const image = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+
+    it('resolves with an empty array when there are no jobs', async () => {
+      expect(await nativeImage.transformImages([])).to.deep.equal([]);
+    });
+
+    it('resizes, crops and encodes images', async () => {
+      const [resized, cropped, jpeg] = await nativeImage.transformImages([
+        { image, operations: [{ type: 'resize', width: 269 }] },
+        { image, operations: [{ type: 'crop', x: 0, y: 0, width: 100, height: 50 }] },
+        { image, format: 'jpeg', quality: 50 }
+      ]);
+
+      expect(nativeImage.createFromBuffer(resized).getSize()).to.deep.equal({ width: 269, height: 95 });
+      expect(nativeImage.createFromBuffer(cropped).getSize()).to.deep.equal({ width: 100, height: 50 });
+      expect(jpeg.slice(0, 2).equals(Buffer.from([0xff, 0xd8]))).to.be.true();
+      expect(nativeImage.createFromBuffer(jpeg).getSize()).to.deep.equal({ width: 538, height: 190 });
+    });
+
+    it('applies the operations in order', async () => {
+      const [result] = await nativeImage.transformImages([{
+        image,
+        operations: [
+          { type: 'crop', x: 0, y: 0, width: 200, height: 100 },
+          { type: 'resize', height: 50 }
+        ]
+      }]);
+      expect(nativeImage.createFromBuffer(result).getSize()).to.deep.equal({ width: 100, height: 50 });
+    });
+
+    it('resolves with an empty buffer for empty images', async () => {
+      const [result] = await nativeImage.transformImages([{ image: nativeImage.createEmpty() }]);
+      expect(result).to.have.lengthOf(0);
+    });
+
+    it('throws on invalid arguments', () => {
+      expect(() => nativeImage.transformImages([{}])).to.throw('image must be a NativeImage');
+      expect(() => nativeImage.transformImages([{ image, format: 'gif' }])).to.throw(/format must be/);
+      expect(() => nativeImage.transformImages([{ image, operations: [{ type: 'rotate' }] }])).to.throw(/operation type must be/);
+    });
+  });
+
   describe('crop(bounds)', () => {
     it('returns an empty image when called on an empty image', () => {
       expect(nativeImage.createEmpty().crop({ width: 1, height: 2, x: 0, y: 0 }).isEmpty()).to.be.true();
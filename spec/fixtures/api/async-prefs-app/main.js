@@ -0,0 +1,29 @@
+// Creates a persistent session with the asyncPrefs option in a fresh process,
+// see the session.fromPartition specs.
+
+const { app, session } = require('electron');
+const fs = require('fs');
+const path = require('path');
+
+app.setPath('userData', process.env.ASYNC_PREFS_USER_DATA);
+
+app.on('ready', () => {
+  const result = {};
+  const ses = session.fromPartition('persist:async-prefs', { asyncPrefs: true });
+
+  if (process.env.ASYNC_PREFS_MODE === 'fifo') {
+    // The Preferences file is a FIFO nobody writes to yet, so reading it on
+    // this thread would never have returned. Write to it now to let the read
+    // in the background finish.
+    result.created = true;
+    const partitionPath = path.join(app.getPath('userData'), 'Partitions', 'async-prefs');
+    fs.writeFileSync(path.join(partitionPath, 'Preferences'), '{}');
+  } else {
+    // Nothing ran since the session was created, so the read in the
+    // background can't have finished yet.
+    result.languages = ses.getSpellCheckerLanguages();
+  }
+
+  console.log(`async-prefs-results ${JSON.stringify(result)}`);
+  app.quit();
+});
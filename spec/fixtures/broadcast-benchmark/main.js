@@ -0,0 +1,59 @@
+// Sends the same message to many windows with webContents.send in a loop and
+// with webContents.broadcast, see script/benchmark-broadcast.js.
+
+const { app, BrowserWindow, ipcMain, webContents } = require('electron');
+
+const windowCount = parseInt(process.env.BROADCAST_BENCHMARK_WINDOWS, 10);
+const messageCount = parseInt(process.env.BROADCAST_BENCHMARK_MESSAGES, 10);
+const payloadSize = parseInt(process.env.BROADCAST_BENCHMARK_PAYLOAD_SIZE, 10);
+
+// Every window acknowledges the last message, so that the time measured
+// includes delivering the messages.
+const waitForAcks = () => new Promise(resolve => {
+  let acks = 0;
+  const onAck = () => {
+    if (++acks === windowCount) {
+      ipcMain.removeListener('ack', onAck);
+      resolve();
+    }
+  };
+  ipcMain.on('ack', onAck);
+});
+
+async function measure (send) {
+  const payload = { state: 'x'.repeat(payloadSize) };
+  const acked = waitForAcks();
+  const start = process.hrtime.bigint();
+  for (let i = 0; i < messageCount; i++) {
+    send('state', payload, i === messageCount - 1);
+  }
+  const sendTime = Number(process.hrtime.bigint() - start) / 1e6;
+  await acked;
+  const totalTime = Number(process.hrtime.bigint() - start) / 1e6;
+  return { sendTime, totalTime };
+}
+
+app.on('ready', async () => {
+  const windows = [];
+  for (let i = 0; i < windowCount; i++) {
+    const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true } });
+    await w.loadURL('about:blank');
+    await w.webContents.executeJavaScript(`{
+      const { ipcRenderer } = require('electron')
+      ipcRenderer.on('state', (event, payload, last) => {
+        if (last) ipcRenderer.send('ack')
+      })
+    }`);
+    windows.push(w);
+  }
+  const targets = windows.map(w => w.webContents);
+
+  const results = {
+    send: await measure((...args) => {
+      for (const contents of targets) contents.send(...args);
+    }),
+    broadcast: await measure((...args) => webContents.broadcast(targets, ...args))
+  };
+  console.log(`broadcast-benchmark-results ${JSON.stringify(results)}`);
+  app.quit();
+});
@@ -0,0 +1,27 @@
+// Verifies that the main process is started from browser_snapshot_blob.bin
+// instead of the snapshot shared with the renderers.
+
+const { app } = require('electron');
+
+app.on('ready', () => {
+  let returnCode = 0;
+  try {
+    const testValue = browserSnapshotValue(); // eslint-disable-line no-undef
+    if (testValue === 'browser-snapshot' && typeof f === 'undefined') {
+      console.log('ok browser snapshot successfully loaded.');
+    } else {
+      console.log('not ok browser snapshot could not be successfully loaded.');
+      returnCode = 1;
+    }
+  } catch (ex) {
+    console.log('Error running browser snapshot', ex);
+    returnCode = 1;
+  }
+  setImmediate(function () {
+    app.exit(returnCode);
+  });
+});
+
+process.on('exit', function (code) {
+  console.log('browser snapshot exited with code: ' + code);
+});
@@ -0,0 +1,8 @@
+const { ipcRenderer } = require('electron');
+
+ipcRenderer.on('port-echo', function (event) {
+  if (!event.port) return;
+  event.port.on('message', function (event, ...args) {
+    event.sender.postMessage(...args);
+  });
+});
@@ -0,0 +1,73 @@
+// Makes a thumbnail of every image of a corpus with image.resize and
+// image.toJPEG, and with nativeImage.transformImages, see
+// script/benchmark-native-image.js.
+
+const { app, nativeImage } = require('electron');
+const fs = require('fs');
+const path = require('path');
+
+const corpusDir = process.env.NATIVE_IMAGE_BENCHMARK_DIR;
+const imageCount = parseInt(process.env.NATIVE_IMAGE_BENCHMARK_IMAGES, 10);
+const thumbnailWidth = parseInt(process.env.NATIVE_IMAGE_BENCHMARK_WIDTH, 10);
+
+// Noise compresses and resizes about as badly as a photo does.
+function createPhoto (width, height) {
+  const pixels = Buffer.alloc(width * height * 4);
+  let seed = 1;
+  for (let i = 0; i < pixels.length; i += 4) {
+    seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+    pixels[i] = seed & 0xff;
+    pixels[i + 1] = (seed >> 8) & 0xff;
+    pixels[i + 2] = (seed >> 16) & 0xff;
+    pixels[i + 3] = 0xff;
+  }
+  return nativeImage.createFromBitmap(pixels, { width, height });
+}
+
+function loadCorpus () {
+  if (!corpusDir) {
+    const photo = createPhoto(4000, 3000);
+    return new Array(imageCount).fill(photo);
+  }
+  return fs.readdirSync(corpusDir)
+    .filter(name => /\.(png|jpe?g)$/i.test(name))
+    .map(name => nativeImage.createFromPath(path.join(corpusDir, name)))
+    .filter(image => !image.isEmpty());
+}
+
+async function measure (makeThumbnails) {
+  const start = process.hrtime.bigint();
+  // Whether the main thread stays responsive while the thumbnails are made.
+  let maxTickDelay = 0;
+  let lastTick = process.hrtime.bigint();
+  const timer = setInterval(() => {
+    const now = process.hrtime.bigint();
+    maxTickDelay = Math.max(maxTickDelay, Number(now - lastTick) / 1e6);
+    lastTick = now;
+  }, 1);
+  await makeThumbnails();
+  clearInterval(timer);
+  const now = process.hrtime.bigint();
+  maxTickDelay = Math.max(maxTickDelay, Number(now - lastTick) / 1e6);
+  return { totalTime: Number(now - start) / 1e6, maxTickDelay };
+}
+
+app.on('ready', async () => {
+  const images = loadCorpus();
+  const resize = { width: thumbnailWidth, quality: 'good' };
+
+  const results = {
+    count: images.length,
+    sync: await measure(async () => {
+      for (const image of images) image.resize(resize).toJPEG(80);
+    }),
+    transformImages: await measure(() => nativeImage.transformImages(images.map(image => ({
+      image,
+      operations: [Object.assign({ type: 'resize' }, resize)],
+      format: 'jpeg',
+      quality: 80
+    }))))
+  };
+  console.log(`native-image-benchmark-results ${JSON.stringify(results)}`);
+  app.quit();
+});
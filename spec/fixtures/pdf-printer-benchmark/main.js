@@ -0,0 +1,34 @@
+// Prints a generated document many times and reports the throughput, see
+// script/benchmark-pdf-printer.js.
+
+const { app, PDFPrinter } = require('electron');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
+const jobCount = parseInt(process.env.PDF_BENCHMARK_JOBS, 10);
+const pagesPerJob = parseInt(process.env.PDF_BENCHMARK_PAGES, 10);
+const concurrency = parseInt(process.env.PDF_BENCHMARK_CONCURRENCY, 10) || undefined;
+
+app.on('ready', async () => {
+  const outputDir = fs.mkdtempSync(path.join(os.tmpdir(), 'pdf-printer-benchmark-'));
+  const pages = [];
+  for (let i = 0; i < pagesPerJob; i++) {
+    pages.push(`<section style="page-break-after: always"><h1>Page ${i + 1}</h1>` +
+               '<p>Lorem ipsum dolor sit amet. </p>'.repeat(20) + '</section>');
+  }
+  const filePath = path.join(outputDir, 'document.html');
+  fs.writeFileSync(filePath, `<!doctype html><html><body>${pages.join('')}</body></html>`);
+
+  const printer = new PDFPrinter({ concurrency });
+  const jobs = [];
+  for (let i = 0; i < jobCount; i++) {
+    jobs.push(printer.print({ filePath, outputPath: path.join(outputDir, `${i}.pdf`) }));
+  }
+  await Promise.all(jobs);
+
+  console.log(`pdf-printer-benchmark-metrics ${JSON.stringify(printer.getMetrics())}`);
+  printer.destroy();
+  fs.rmdirSync(outputDir, { recursive: true });
+  app.quit();
+});
@@ -0,0 +1,26 @@
+// Creates many persistent sessions, with or without the asyncPrefs option,
+// see script/benchmark-session-prefs.js.
+
+const { app, session } = require('electron');
+
+const mode = process.env.SESSION_PREFS_BENCHMARK_MODE;
+const partitionCount = parseInt(process.env.SESSION_PREFS_BENCHMARK_PARTITIONS, 10);
+
+app.setPath('userData', process.env.SESSION_PREFS_BENCHMARK_USER_DATA);
+
+app.on('ready', () => {
+  const start = process.hrtime.bigint();
+  const sessions = [];
+  for (let i = 0; i < partitionCount; i++) {
+    sessions.push(session.fromPartition(`persist:benchmark-${i}`, { asyncPrefs: mode === 'async' }));
+  }
+  const creationTime = Number(process.hrtime.bigint() - start) / 1e6;
+
+  if (mode === 'populate') {
+    // Give every partition a Preferences file to read in the next runs.
+    for (const ses of sessions) ses.setDownloadPath(app.getPath('temp'));
+  }
+
+  console.log(`session-prefs-benchmark-results ${JSON.stringify({ creationTime })}`);
+  app.quit();
+});
@@ -0,0 +1,14 @@
+// Reports how long the main process took to get to 'ready', see
+// script/benchmark-startup.js.
+
+const { app } = require('electron');
+
+// Optional module graph to load before 'ready', as an app's main script would.
+if (process.env.STARTUP_BENCHMARK_REQUIRE) {
+  require(process.env.STARTUP_BENCHMARK_REQUIRE);
+}
+
+app.on('ready', () => {
+  console.log(`startup-benchmark-ready ${process.uptime() * 1000}`);
+  app.quit();
+});
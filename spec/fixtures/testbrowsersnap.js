@@ -0,0 +1,2 @@
+// Loaded by the main process only, from browser_snapshot_blob.bin.
+function browserSnapshotValue () { return 'browser-snapshot'; } // eslint-disable-line no-unused-vars
@@ -22,6 +22,13 @@ declare namespace NodeJS {
     sendToHost(channel: string, args: any[]): void;
     sendTo(internal: boolean, sendToAll: boolean, webContentsId: number, channel: string, args: any[]): void;
     invoke<T>(internal: boolean, channel: string, args: any[]): Promise<{ error: string, result: T }>;
+    connectTo(webContentsId: number, channel: string): Promise<IpcRendererPortBinding>;
+  }
+
+  interface IpcRendererPortBinding {
+    postMessage(args: any[]): void;
+    setHandlers(onMessage: (args: any[]) => void, onClose: () => void): void;
+    close(): void;
   }
 
   interface V8UtilBinding {